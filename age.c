@@ -0,0 +1,66 @@
+#include "age.h"
+#include "date_util.h"
+#include "clock.h"
+#include "translations.h"
+
+static struct {
+    bool valid;
+    uint32_t expires_ms; // Next local midnight, on clock_now_ms()
+    uint16_t birth_y;
+    uint8_t birth_m;
+    uint8_t birth_d;
+    uint8_t language;
+    char short_text[16];
+    char long_text[32];
+} g_age;
+
+static bool cache_fresh(AppData* app) {
+    return g_age.valid && (int32_t)(clock_now_ms() - g_age.expires_ms) < 0 &&
+           g_age.birth_y == app->cfg.birth_y && g_age.birth_m == app->cfg.birth_m &&
+           g_age.birth_d == app->cfg.birth_d && g_age.language == app->cfg.language;
+}
+
+static void cache_build(AppData* app) {
+    DateTime now;
+    clock_now_datetime(&now);
+    int32_t today = date_to_days(now.year, now.month, now.day);
+    uint32_t to_midnight = 86400 - (now.hour * 3600 + now.minute * 60 + now.second);
+
+    DateAge age;
+    date_age(date_to_days(app->cfg.birth_y, app->cfg.birth_m, app->cfg.birth_d), today, &age);
+
+    if(age.months == 0) {
+        snprintf(g_age.short_text, sizeof(g_age.short_text), "%lud", (unsigned long)age.days);
+    } else {
+        snprintf(g_age.short_text, sizeof(g_age.short_text), "%lum %lud",
+            (unsigned long)age.months, (unsigned long)age.month_days);
+    }
+
+    if(age.days < 7) {
+        snprintf(g_age.long_text, sizeof(g_age.long_text), "%lu %s",
+            (unsigned long)age.days, tr_get(app, TR_AGE_DAYS));
+    } else if(age.months == 0) {
+        snprintf(g_age.long_text, sizeof(g_age.long_text), "%lu %s",
+            (unsigned long)(age.days / 7), tr_get(app, TR_AGE_WEEKS));
+    } else {
+        snprintf(g_age.long_text, sizeof(g_age.long_text), "%lu %s",
+            (unsigned long)age.months, tr_get(app, TR_AGE_MONTHS));
+    }
+
+    g_age.expires_ms = clock_now_ms() + to_midnight * 1000;
+    g_age.birth_y = app->cfg.birth_y;
+    g_age.birth_m = app->cfg.birth_m;
+    g_age.birth_d = app->cfg.birth_d;
+    g_age.language = app->cfg.language;
+    g_age.valid = true;
+}
+
+const char* age_short(AppData* app) {
+    if(!cache_fresh(app)) cache_build(app);
+    return g_age.short_text;
+}
+
+const char* age_long(AppData* app) {
+    if(!cache_fresh(app)) cache_build(app);
+    return g_age.long_text;
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include "app_state.h"
+
+// ==== AGE STRINGS ====
+// Built once and reused until local midnight; a birth date or language
+// change is picked up on the next call. Draw code gets a cached pointer.
+
+const char* age_short(AppData* app); // "3m 12d" for the main screen
+const char* age_long(AppData* app); // "3 months" / "2 weeks" / "5 days" for the profile
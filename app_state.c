@@ -1,11 +1,36 @@
 #include "app_state.h"
+#include "translations.h"
+#include "child.h"
+#include "scratch.h"
+#include "clock.h"
+#include "date_util.h"
 #include <storage/storage.h>
 #include <stream/stream.h>
 #include <stream/buffered_file_stream.h>
 #include <furi.h>
 
-#define CONFIG_PATH EXT_PATH("apps/baby_log/config.json")
-#define STATE_PATH EXT_PATH("apps/baby_log/state.json")
+#define CONFIG_PATH EXT_PATH("apps/baby_log/config.json") // Root config, see child.h
+#define STATE_PATH (child_paths()->state)
+
+// Scratch buffer sizes for whole-file JSON reads and writes
+#define CONFIG_JSON_MAX 1024
+#define PROFILE_JSON_MAX 256
+#define STATE_JSON_MAX 512
+
+// state.json without "state_version" holds timer starts from the old
+// timestamp formula (365-day years, 30-day months); 2 = Unix time
+#define STATE_VERSION 2
+
+// Timers changed since the last save of the derived tables, written by
+// state_checkpoint() (see log_tables.h)
+static AppData* g_state_pending;
+
+// Root config keys of app->remind_minutes, by ReminderKind
+static const char* const remind_keys[ReminderCount] = {
+    [ReminderFeed] = "remind_feed",
+    [ReminderDiaper] = "remind_diaper",
+    [ReminderSleep] = "remind_sleep",
+};
 
 // Simple JSON parsing helpers (no malloc)
 static int parse_int(const char* str, int* val) {
@@ -66,133 +91,258 @@ static void extract_string(const char* start, char* out, size_t max_len) {
     out[i] = '\0';
 }
 
-void load_config(AppData* app) {
-    // Default values
-    strncpy(app->cfg.name, "Baby", sizeof(app->cfg.name) - 1);
-    app->cfg.name[sizeof(app->cfg.name) - 1] = '\0';
-    app->cfg.birth_y = 2024;
-    app->cfg.birth_m = 1;
-    app->cfg.birth_d = 1;
-    app->cfg.language = 0; // English by default
+// Name and birth date - shared by the root config and child configs
+static void parse_profile(const char* buffer, BabyConfig* cfg) {
+    const char* name_pos = find_key(buffer, "name");
+    if(name_pos) {
+        extract_string(name_pos, cfg->name, sizeof(cfg->name));
+    }
+    
+    const char* year_pos = find_key(buffer, "birth_y");
+    if(year_pos) {
+        parse_uint16(year_pos, &cfg->birth_y);
+    }
+    
+    const char* month_pos = find_key(buffer, "birth_m");
+    if(month_pos) {
+        parse_uint8(month_pos, &cfg->birth_m);
+    }
+    
+    const char* day_pos = find_key(buffer, "birth_d");
+    if(day_pos) {
+        parse_uint8(day_pos, &cfg->birth_d);
+    }
+}
 
+// Read a small JSON file into buffer; returns false if missing or too big
+static bool read_json(const char* path, char* buffer, size_t buffer_size) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     Stream* stream = buffered_file_stream_alloc(storage);
+    bool ok = false;
     
-    if(buffered_file_stream_open(stream, CONFIG_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+    if(buffered_file_stream_open(stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
         size_t size = stream_size(stream);
-        if(size > 0 && size < 1024) {
-            char buffer[1024];
+        if(size > 0 && size < buffer_size) {
             size_t read = stream_read(stream, (uint8_t*)buffer, size);
             buffer[read] = '\0';
-            
-            const char* name_pos = find_key(buffer, "name");
-            if(name_pos) {
-                extract_string(name_pos, app->cfg.name, sizeof(app->cfg.name));
-            }
-            
-            const char* year_pos = find_key(buffer, "birth_y");
-            if(year_pos) {
-                parse_uint16(year_pos, &app->cfg.birth_y);
-            }
-            
-            const char* month_pos = find_key(buffer, "birth_m");
-            if(month_pos) {
-                parse_uint8(month_pos, &app->cfg.birth_m);
-            }
-            
-            const char* day_pos = find_key(buffer, "birth_d");
-            if(day_pos) {
-                parse_uint8(day_pos, &app->cfg.birth_d);
-            }
-            
-            const char* lang_pos = find_key(buffer, "language");
-            if(lang_pos) {
-                uint8_t lang = 0;
-                parse_uint8(lang_pos, &lang);
-                if(lang <= 2) { // Valid language range
-                    app->cfg.language = lang;
-                }
-            }
+            ok = true;
         }
         buffered_file_stream_close(stream);
     }
     
     stream_free(stream);
     furi_record_close(RECORD_STORAGE);
+    return ok;
 }
 
-void save_config(AppData* app) {
+static void default_profile(BabyConfig* cfg) {
+    strncpy(cfg->name, "Baby", sizeof(cfg->name) - 1);
+    cfg->name[sizeof(cfg->name) - 1] = '\0';
+    cfg->birth_y = 2024;
+    cfg->birth_m = 1;
+    cfg->birth_d = 1;
+}
+
+void load_config(AppData* app) {
+    // Default values
+    default_profile(&app->cfg);
+    app->cfg.language = 0; // English by default
+    app->child_count = 1;
+    app->active_child = 0;
+    for(int i = 0; i < ReminderCount; i++) {
+        app->remind_minutes[i] = 0; // Off until set on the Reminders screen
+    }
+
+    ScratchMark mark = scratch_mark();
+    char* buffer = scratch_alloc(CONFIG_JSON_MAX);
+    if(read_json(CONFIG_PATH, buffer, CONFIG_JSON_MAX)) {
+        parse_profile(buffer, &app->cfg);
+        
+        const char* lang_pos = find_key(buffer, "language");
+        if(lang_pos) {
+            uint8_t lang = 0;
+            parse_uint8(lang_pos, &lang);
+            if(lang < LANG_MAX) { // Missing packs fall back to English in tr_load()
+                app->cfg.language = lang;
+            }
+        }
+        
+        const char* children_pos = find_key(buffer, "children");
+        if(children_pos) {
+            parse_uint8(children_pos, &app->child_count);
+        }
+        
+        const char* active_pos = find_key(buffer, "active_child");
+        if(active_pos) {
+            parse_uint8(active_pos, &app->active_child);
+        }
+        
+        for(int i = 0; i < ReminderCount; i++) {
+            const char* remind_pos = find_key(buffer, remind_keys[i]);
+            if(remind_pos) {
+                parse_uint16(remind_pos, &app->remind_minutes[i]);
+            }
+        }
+    }
+    scratch_release(mark);
+}
+
+void read_profile(BabyConfig* cfg) {
+    ScratchMark mark = scratch_mark();
+    char* buffer = scratch_alloc(PROFILE_JSON_MAX);
+    default_profile(cfg);
+    if(read_json(child_paths()->config, buffer, PROFILE_JSON_MAX)) {
+        parse_profile(buffer, cfg);
+    }
+    scratch_release(mark);
+}
+
+void load_profile(AppData* app) {
+    read_profile(&app->cfg);
+}
+
+static void write_json(const char* path, const char* buffer) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     
     // Ensure directory exists
-    storage_common_mkdir(storage, EXT_PATH("apps/baby_log"));
+    storage_common_mkdir(storage, CHILD_ROOT_DIR);
+    storage_common_mkdir(storage, child_paths()->dir);
     
     Stream* stream = buffered_file_stream_alloc(storage);
     
-    if(buffered_file_stream_open(stream, CONFIG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        char buffer[256];
-        snprintf(buffer, sizeof(buffer),
+    if(buffered_file_stream_open(stream, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        stream_write(stream, (uint8_t*)buffer, strlen(buffer));
+        buffered_file_stream_close(stream);
+    }
+    
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+}
+
+void save_config(AppData* app) {
+    // The root config carries child 0's profile and the app-wide settings
+    const BabyConfig* root = (app->active_child == 0) ? &app->cfg : &app->children[0].cfg;
+    ScratchMark mark = scratch_mark();
+    char* buffer = scratch_alloc(CONFIG_JSON_MAX);
+    snprintf(buffer, CONFIG_JSON_MAX,
+        "{\n"
+        "  \"name\": \"%s\",\n"
+        "  \"birth_y\": %u,\n"
+        "  \"birth_m\": %u,\n"
+        "  \"birth_d\": %u,\n"
+        "  \"language\": %u,\n"
+        "  \"children\": %u,\n"
+        "  \"active_child\": %u,\n"
+        "  \"%s\": %u,\n"
+        "  \"%s\": %u,\n"
+        "  \"%s\": %u\n"
+        "}\n",
+        root->name,
+        root->birth_y,
+        root->birth_m,
+        root->birth_d,
+        app->cfg.language,
+        app->child_count,
+        app->active_child,
+        remind_keys[ReminderFeed], app->remind_minutes[ReminderFeed],
+        remind_keys[ReminderDiaper], app->remind_minutes[ReminderDiaper],
+        remind_keys[ReminderSleep], app->remind_minutes[ReminderSleep]);
+    write_json(CONFIG_PATH, buffer);
+    
+    if(app->active_child != 0) {
+        snprintf(buffer, CONFIG_JSON_MAX,
             "{\n"
             "  \"name\": \"%s\",\n"
             "  \"birth_y\": %u,\n"
             "  \"birth_m\": %u,\n"
-            "  \"birth_d\": %u,\n"
-            "  \"language\": %u\n"
+            "  \"birth_d\": %u\n"
             "}\n",
             app->cfg.name,
             app->cfg.birth_y,
             app->cfg.birth_m,
-            app->cfg.birth_d,
-            app->cfg.language);
-        stream_write(stream, (uint8_t*)buffer, strlen(buffer));
-        buffered_file_stream_close(stream);
+            app->cfg.birth_d);
+        write_json(child_paths()->config, buffer);
     }
-    
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
+    scratch_release(mark);
 }
 
-void load_state(AppData* app) {
+// Old formula: days = (y-1970)*365 + (y-1969)/4 + (m-1)*30 + d-1. Its
+// months overlap by a day, so day 31 reads back as the 1st of the next.
+static uint32_t state_ts_from_v1(uint32_t ts) {
+    if(ts == 0) return 0;
+    int32_t old_days = (int32_t)(ts / 86400);
+    uint16_t year = 1970;
+    while((int32_t)((year + 1 - 1970) * 365 + (year + 1 - 1969) / 4) <= old_days) year++;
+    int32_t rem = old_days - ((year - 1970) * 365 + (year - 1969) / 4);
+    uint8_t month = (rem >= 360) ? 12 : (uint8_t)(rem / 30 + 1);
+    uint8_t day = (uint8_t)(rem - (month - 1) * 30 + 1);
+    uint8_t last = date_days_in_month(year, month);
+    if(day > last) day = last;
+    return (uint32_t)date_to_days(year, month, day) * 86400 + ts % 86400;
+}
+
+// A timer that can't have started yet is dropped rather than shown as negative
+static void state_check_timer(bool* active, uint32_t* start_ts, uint32_t now) {
+    if(*start_ts > now || (*active && *start_ts == 0)) {
+        *active = false;
+        *start_ts = 0;
+    }
+}
+
+void read_state(AppState* state) {
     // Default values
-    app->state.feeding_active = false;
-    app->state.sleep_active = false;
-    app->state.feeding_start_ts = 0;
-    app->state.sleep_start_ts = 0;
-    app->state.last_diaper_ts = 0;
+    state->feeding_active = false;
+    state->sleep_active = false;
+    state->feeding_start_ts = 0;
+    state->sleep_start_ts = 0;
+    state->last_diaper_ts = 0;
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
     Stream* stream = buffered_file_stream_alloc(storage);
     
     if(buffered_file_stream_open(stream, STATE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
         size_t size = stream_size(stream);
-        if(size > 0 && size < 512) {
-            char buffer[512];
+        if(size > 0 && size < STATE_JSON_MAX) {
+            ScratchMark mark = scratch_mark();
+            char* buffer = scratch_alloc(STATE_JSON_MAX);
             size_t read = stream_read(stream, (uint8_t*)buffer, size);
             buffer[read] = '\0';
             
             const char* feeding_pos = find_key(buffer, "feeding_active");
             if(feeding_pos) {
-                app->state.feeding_active = (*feeding_pos == 't');
+                state->feeding_active = (*feeding_pos == 't');
             }
             
             const char* sleep_pos = find_key(buffer, "sleep_active");
             if(sleep_pos) {
-                app->state.sleep_active = (*sleep_pos == 't');
+                state->sleep_active = (*sleep_pos == 't');
             }
             
             const char* feeding_ts_pos = find_key(buffer, "feeding_start_ts");
             if(feeding_ts_pos) {
                 uint32_t ts = 0;
                 parse_int(feeding_ts_pos, (int*)&ts);
-                app->state.feeding_start_ts = ts;
+                state->feeding_start_ts = ts;
             }
             
             const char* sleep_ts_pos = find_key(buffer, "sleep_start_ts");
             if(sleep_ts_pos) {
                 uint32_t ts = 0;
                 parse_int(sleep_ts_pos, (int*)&ts);
-                app->state.sleep_start_ts = ts;
+                state->sleep_start_ts = ts;
+            }
+            
+            int version = 1;
+            const char* version_pos = find_key(buffer, "state_version");
+            if(version_pos) parse_int(version_pos, &version);
+            if(version < STATE_VERSION) {
+                state->feeding_start_ts = state_ts_from_v1(state->feeding_start_ts);
+                state->sleep_start_ts = state_ts_from_v1(state->sleep_start_ts);
             }
+            uint32_t now = clock_now();
+            state_check_timer(&state->feeding_active, &state->feeding_start_ts, now);
+            state_check_timer(&state->sleep_active, &state->sleep_start_ts, now);
+            scratch_release(mark);
         }
         buffered_file_stream_close(stream);
     }
@@ -201,31 +351,54 @@ void load_state(AppData* app) {
     furi_record_close(RECORD_STORAGE);
 }
 
-void save_state(AppData* app) {
+void load_state(AppData* app) {
+    g_state_pending = NULL;
+    read_state(&app->state);
+}
+
+bool save_state(AppData* app) {
+    g_state_pending = NULL;
+    bool ok = false;
     Storage* storage = furi_record_open(RECORD_STORAGE);
     
     // Ensure directory exists
-    storage_common_mkdir(storage, EXT_PATH("apps/baby_log"));
+    storage_common_mkdir(storage, CHILD_ROOT_DIR);
+    storage_common_mkdir(storage, child_paths()->dir);
     
     Stream* stream = buffered_file_stream_alloc(storage);
     
     if(buffered_file_stream_open(stream, STATE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        char buffer[256];
-        snprintf(buffer, sizeof(buffer),
+        ScratchMark mark = scratch_mark();
+        char* buffer = scratch_alloc(STATE_JSON_MAX);
+        snprintf(buffer, STATE_JSON_MAX,
             "{\n"
+            "  \"state_version\": %d,\n"
             "  \"feeding_active\": %s,\n"
             "  \"sleep_active\": %s,\n"
             "  \"feeding_start_ts\": %lu,\n"
             "  \"sleep_start_ts\": %lu\n"
             "}\n",
+            STATE_VERSION,
             app->state.feeding_active ? "true" : "false",
             app->state.sleep_active ? "true" : "false",
             (unsigned long)app->state.feeding_start_ts,
             (unsigned long)app->state.sleep_start_ts);
-        stream_write(stream, (uint8_t*)buffer, strlen(buffer));
-        buffered_file_stream_close(stream);
+        size_t len = strlen(buffer);
+        ok = stream_write(stream, (uint8_t*)buffer, len) == len;
+        scratch_release(mark);
+        ok = buffered_file_stream_close(stream) && ok;
     }
     
     stream_free(stream);
     furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+void save_state_deferred(AppData* app) {
+    g_state_pending = app;
+}
+
+bool state_checkpoint(void) {
+    if(!g_state_pending) return true;
+    return save_state(g_state_pending);
 }
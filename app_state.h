@@ -2,7 +2,10 @@
 #include <furi.h>
 
 #define MAX_NAME_LEN 12
-#define MAX_LOG_ENTRIES 10
+#define MAX_LOG_ENTRIES 32
+#define CHILD_MAX 4
+#define JOURNAL_DEPTH 8 // Undoable operations kept in RAM
+#define STATS_WINDOW 16 // Newest samples kept for median/percentiles
 
 typedef struct {
     char name[16];
@@ -28,19 +31,130 @@ typedef enum {
     LogEventSleepStop,
 } LogEventType;
 
+#define LOG_EVENT_TYPE_COUNT (LogEventSleepStop + 1)
+
+// One event in the recent ring, packed to 12 bytes. Only the seed of a
+// generated ID is kept; log_format_id() rebuilds the string. IDs in any
+// other form are kept as their log_hash_id() and flagged foreign.
+#define LOG_ENTRY_DURATION_MAX 0xFFFFFF // Seconds, about 194 days
+
 typedef struct {
     uint32_t timestamp;
-    LogEventType type;
-    uint32_t duration; // For stop events
-    char id[33]; // Hex string ID
+    uint32_t id; // ID seed (or hash if foreign), 0 = no ID yet
+    uint32_t duration : 24; // For stop events
+    uint32_t type : 7; // LogEventType
+    uint32_t foreign : 1;
 } LogEntry;
 
+_Static_assert(sizeof(LogEntry) == 12, "LogEntry must stay packed");
+
+// Operations recorded in deleted.jsonl
+typedef enum {
+    JournalOpDelete = 0,
+    JournalOpRestore, // Undo of a delete
+} JournalOp;
+
+typedef struct {
+    JournalOp op; // Forward operation; undo applies its inverse
+    LogEntry entry;
+} JournalEntry;
+
+// Newest journal operations, so undo/redo never rescan the log
+typedef struct {
+    JournalEntry ops[JOURNAL_DEPTH]; // Oldest first
+    uint8_t count;
+    uint8_t cursor; // ops[0..cursor) can be undone, ops[cursor..count) redone
+} UndoJournal;
+
+// Reminder kinds, see reminder.h
+typedef enum {
+    ReminderFeed = 0, // No feed started for a while
+    ReminderDiaper, // No diaper change for a while
+    ReminderSleep, // Sleep running long
+    ReminderCount,
+} ReminderKind;
+
+// Rolling statistics of one interval series, see log_stats.h
 typedef struct {
-    BabyConfig cfg;
+    uint32_t ewma; // Seconds
+    uint32_t window[STATS_WINDOW]; // Newest samples, ring
+    uint32_t sorted[STATS_WINDOW]; // Same samples in ascending order
+    uint8_t head; // Slot of the oldest sample once the window is full
+    uint8_t count;
+} IntervalStats;
+
+// Newest live event of one type, see log_last.h
+typedef struct {
+    uint32_t ts; // 0 = none known
+    uint32_t id; // log_hash_id() of its ID
+    uint32_t duration; // Session length, for stop events
+} LastEvent;
+
+typedef struct {
+    IntervalStats feed; // Feeding start to next feeding start
+    IntervalStats sleep; // Sleep lengths
+    uint32_t last_feed_ts; // Start of the last counted feed, 0 = none
+} LogStats;
+
+// Cached state of a child that is not active, so switching back is instant
+typedef struct {
+    BabyConfig cfg; // language unused - app-wide
     AppState state;
+    LogEntry log_entries[MAX_LOG_ENTRIES];
+    int log_head;
+    int log_count;
+    UndoJournal journal;
+    LogStats stats;
+    LastEvent last[LOG_EVENT_TYPE_COUNT];
+    bool stats_stale; // Left mid-rebuild, rebuilt on switching back
+    bool loaded;
+    bool peeked; // Only cfg, state and last, read at start for the reminders
+} ChildSlot;
+
+typedef enum {
+    ExportFormatCsv = 0,
+    ExportFormatJson,
+} ExportFormat;
+
+// Status of a long-running storage job (export, import)
+typedef enum {
+    JobIdle = 0,
+    JobRunning,
+    JobDone,
+    JobCancelled,
+    JobFailed,
+} JobStatus;
 
-    // Menu navigation
-    int menu_index;
+// Hot fields first: the main loop, draw callback and input handler touch
+// them on every pass. Everything after children[] is read only by its own
+// screen or job, so it stays out of the way of the hot block.
+typedef struct {
+    // ==== HOT ====
+    AppState state; // Active child's timers
+    uint32_t now; // Clock at the last loop tick or key; draw code reads this, not the RTC
+    BabyConfig cfg; // Active child's profile
+    uint8_t child_count;
+    uint8_t active_child;
+    int menu_index; // Menu navigation
+    bool delete_refused; // Tombstone set full, shown on the menu until the next key
+    bool remind_alert; // Reminder went off, shown on the main screen until the next key
+    uint8_t remind_alert_child;
+    ReminderKind remind_alert_kind;
+    
+    // Recent ring, see log_recent_get()
+    int log_head; // Slot of the oldest entry
+    int log_count;
+    int log_index; // Recent Log scroll position
+    uint32_t log_generation; // Bumped on every ring change (render cache key)
+    LogEntry log_entries[MAX_LOG_ENTRIES]; // Newest live events
+    
+    uint16_t remind_minutes[ReminderCount]; // App-wide, saved in the root config; 0 = off
+    LogStats stats; // Feed rhythm behind the next-feed forecast
+    LastEvent last[LOG_EVENT_TYPE_COUNT]; // "Time since" on the main screen, by LogEventType
+    
+    // ==== COLD ====
+    ChildSlot children[CHILD_MAX]; // Child profiles (see child.h)
+    UndoJournal journal; // Undo/redo for Delete last
     
     // Profile screen navigation
     int profile_index; // 0=view, 1=edit name, 2=edit birth date, 3=language
@@ -48,6 +162,12 @@ typedef struct {
     // Language selection screen
     int lang_index; // 0=English, 1=Russian, 2=Spanish
     
+    // Reminders screen
+    int remind_index; // Selected row
+    
+    // Diagnostics screen
+    int diag_index; // First operation row shown
+    
     // Edit name screen
     char edit_name[16];
     int edit_name_pos;
@@ -59,13 +179,44 @@ typedef struct {
     uint8_t edit_month;
     uint8_t edit_day;
     
-    // Recent log screen
-    int log_index; // Current scroll position
-    LogEntry log_entries[MAX_LOG_ENTRIES];
-    int log_count;
+    // Add/edit event screen
+    LogEntry edit_event; // Working copy, id 0 for a new event
+    int edit_event_field; // EditEventField value
+    bool edit_event_error; // Last save was refused
+    
+    // Export screen
+    int export_format; // ExportFormat value
+    uint8_t export_days; // Range: the last N days, 0 = whole history
+    JobStatus export_status;
+    uint8_t export_percent;
+    uint32_t export_rows;
+    
+    // Import screen
+    JobStatus import_status;
+    uint8_t import_percent;
+    uint32_t import_added; // Records taken from the other device
+    uint32_t import_dups; // Records present on both devices
+    bool import_deletes_full; // Failed: the deletes of both devices didn't fit in RAM
+    
+    // Check log screen
+    JobStatus check_status;
+    uint8_t check_percent;
+    uint32_t check_good;
+    uint32_t check_bad; // Damaged lines copied to quarantine.jsonl
+    uint32_t check_repaired; // Bytes cut from torn tails at startup
+    bool check_resumable; // check.state exists - read when the screen opens and after a run
+    
+    // Session index rebuild (log_sessions.h), runs without a screen
+    JobStatus sessions_status;
+    JobStatus stats_status; // Statistics rebuild from the index (log_stats.h)
 } AppData;
 
 void load_config(AppData* app);
+void load_profile(AppData* app); // Active child's name and birth date
+void read_profile(BabyConfig* cfg); // Same, into a child slot
 void save_config(AppData* app);
 void load_state(AppData* app);
-void save_state(AppData* app);
+void read_state(AppState* state); // Same, into a child slot
+bool save_state(AppData* app);
+void save_state_deferred(AppData* app); // Timers changed, written with the derived tables (log_tables.h)
+bool state_checkpoint(void); // Called by log_tables_save()
@@ -4,37 +4,136 @@
 #include "screens.h"
 #include <gui/view_port.h>
 #include "screen_draw.h"
+#include "translations.h"
 #include "log_store.h"
+#include "log_append.h"
+#include "log_export.h"
+#include "log_import.h"
+#include "log_archive.h"
+#include "log_check.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "log_stats.h"
+#include "log_tables.h"
+#include "tick.h"
+#include "reminder.h"
+#include "input_queue.h"
+#include "diag.h"
+#include "scratch.h"
+#include "date_util.h"
+#include "child.h"
+#include "clock.h"
+#include "timer.h"
 #include <input/input.h>
-#include <furi_hal_rtc.h>
-#include <datetime/datetime.h>
 
 static Screen current_screen = ScreenMain;
 static AppData app;
 static bool should_exit = false;
 static ViewPort* view_port = NULL;
+static FuriThreadId main_thread = NULL;
+static uint32_t last_input_ms = 0;
 
-// Menu items for ScreenMenu (6 items: Profile, Recent Log, Delete Last, Clear All, Language, Exit)
-#define MENU_ITEM_COUNT 6
+// Held by the app thread while it changes app state and by draw_cb while it
+// reads it. Never held across a wait, so a frame waits at most for one key
+// or job step.
+static FuriMutex* app_mutex = NULL;
 
-// Validate date helper
-static bool is_valid_date(uint16_t year, uint8_t month, uint8_t day) {
-    if(year < 2000 || year > 2100) return false;
-    if(month < 1 || month > 12) return false;
-    if(day < 1 || day > 31) return false;
-    if(month == 2 && day > 29) return false;
-    if((month == 4 || month == 6 || month == 9 || month == 11) && day > 30) return false;
-    
-    DateTime now;
-    furi_hal_rtc_get_datetime(&now);
-    if(year > now.year) return false;
-    if(year == now.year && month > now.month) return false;
-    if(year == now.year && month == now.month && day > now.day) return false;
+static void app_lock(void) {
+    furi_check(furi_mutex_acquire(app_mutex, FuriWaitForever) == FuriStatusOk);
+}
+
+static void app_unlock(void) {
+    furi_check(furi_mutex_release(app_mutex) == FuriStatusOk);
+}
+
+// Main loop wake-up: input is queued, and may change what needs redrawing and when
+#define TICK_FLAG_WAKE (1 << 0)
+#define TICK_FLAG_REMINDER (1 << 1) // Reminder timer expired
+
+// Menu items for ScreenMenu (see MenuItem in screens.h)
+#define MENU_ITEM_COUNT MenuItemCount
+
+// Delay between export/import steps - short enough to keep the progress bar moving
+#define JOB_STEP_DELAY_MS 10
+
+// ==== EVENT EDITOR ====
+// Working copy in app.edit_event; saved as a patch record (see log_patch.h)
+
+#define EDIT_EVENT_MAX_DURATION (12 * 3600)
+
+static bool event_has_duration(LogEventType type) {
+    return type == LogEventFeedingStop || type == LogEventSleepStop;
+}
+
+static bool event_field_enabled(int field) {
+    if(field == EditEventType) return app.edit_event.id == 0;
+    if(field == EditEventDuration) return event_has_duration(app.edit_event.type);
     return true;
 }
 
+static void event_edit_open(const LogEntry* entry) {
+    if(entry) {
+        app.edit_event = *entry;
+        app.edit_event_field = EditEventHour;
+    } else {
+        memset(&app.edit_event, 0, sizeof(LogEntry));
+        app.edit_event.type = LogEventDiaper;
+        app.edit_event.timestamp = clock_now();
+        app.edit_event_field = EditEventType;
+    }
+    app.edit_event_error = false;
+    current_screen = ScreenEditEvent;
+}
+
+static void event_field_move(int dir) {
+    do {
+        app.edit_event_field = (app.edit_event_field + dir + EditEventFieldCount) % EditEventFieldCount;
+    } while(!event_field_enabled(app.edit_event_field));
+}
+
+static void event_adjust(int dir) {
+    LogEntry* event = &app.edit_event;
+    int32_t step = 0;
+    switch((EditEventField)app.edit_event_field) {
+        case EditEventType:
+            event->type = (LogEventType)((event->type + dir + LogEventSleepStop + 1) % (LogEventSleepStop + 1));
+            if(!event_has_duration(event->type)) event->duration = 0;
+            return;
+        case EditEventDuration:
+            if(dir < 0) {
+                event->duration = (event->duration > 60) ? event->duration - 60 : 0;
+            } else if(event->duration + 60 <= EDIT_EVENT_MAX_DURATION) {
+                event->duration += 60;
+            }
+            return;
+        case EditEventDay: step = 86400; break;
+        case EditEventHour: step = 3600; break;
+        case EditEventMinute: step = 60; break;
+        default: return;
+    }
+
+    uint32_t now = clock_now();
+    if(dir < 0) {
+        if(event->timestamp > (uint32_t)step) event->timestamp -= step;
+    } else {
+        event->timestamp = (event->timestamp + step > now) ? now : event->timestamp + step;
+    }
+}
+
+static void event_edit_close(void) {
+    current_screen = (app.edit_event.id == 0) ? ScreenMenu : ScreenRecentLog;
+}
+
+// Runs on the timer thread - alerts are played from the main loop
+static void reminder_timer_cb(void* ctx) {
+    UNUSED(ctx);
+    furi_thread_flags_set(main_thread, TICK_FLAG_REMINDER);
+}
+
 static void draw_cb(Canvas* canvas, void* ctx) {
     UNUSED(ctx);
+    app_lock();
+    diag_begin(DiagOpDraw);
     switch(current_screen) {
         case ScreenMain: draw_main(&app, canvas); break;
         case ScreenMenu: draw_menu(&app, canvas); break;
@@ -43,81 +142,57 @@ static void draw_cb(Canvas* canvas, void* ctx) {
         case ScreenEditBirthDate: draw_edit_birthdate(&app, canvas); break;
         case ScreenRecentLog: draw_recent_log(&app, canvas); break;
         case ScreenLanguage: draw_language(&app, canvas); break;
+        case ScreenExport: draw_export(&app, canvas); break;
+        case ScreenImport: draw_import(&app, canvas); break;
+        case ScreenEditEvent: draw_edit_event(&app, canvas); break;
+        case ScreenCheck: draw_check(&app, canvas); break;
+        case ScreenReminders: draw_reminders(&app, canvas); break;
+        case ScreenDiag: draw_diag(&app, canvas); break;
     }
+    diag_end(DiagOpDraw);
+    app_unlock();
 }
 
-// Handle button input and screen transitions
-static void input_cb(InputEvent* event, void* ctx) {
-    UNUSED(ctx);
-    
-    // Only process press events
-    if(event->type != InputTypePress) {
+// Handle button input and screen transitions - app thread, see input_queue.h
+static void input_handle(const InputRecord* event) {
+    // Only process press events (held arrows repeat on the event editor)
+    if(event->type != InputTypePress &&
+       !(event->type == InputTypeRepeat && current_screen == ScreenEditEvent)) {
         return;
     }
 
+    last_input_ms = clock_now_ms();
+    app.now = clock_now(); // The redraw below shows the key's effect
+
     switch(current_screen) {
         case ScreenMain:
-            // Main screen quick actions
-            // Feeding and sleeping are mutually exclusive
-            if(event->key == InputKeyUp) {
-                // Feeding button
-                uint32_t now = log_get_timestamp();
-                
-                if(app.state.feeding_active) {
-                    // Stop feeding - go to awake
-                    uint32_t duration = (now > app.state.feeding_start_ts) ? 
-                        (now - app.state.feeding_start_ts) : 0;
-                    log_add_event(&app, LogEventFeedingStop, duration);
-                    app.state.feeding_active = false;
-                } else {
-                    // Start feeding - stop sleep if active
-                    if(app.state.sleep_active) {
-                        // Stop sleep first and log it
-                        uint32_t duration = (now > app.state.sleep_start_ts) ? 
-                            (now - app.state.sleep_start_ts) : 0;
-                        log_add_event(&app, LogEventSleepStop, duration);
-                        app.state.sleep_active = false;
-                    }
-                    // Start feeding
-                    app.state.feeding_start_ts = now;
-                    app.state.feeding_active = true;
-                    log_add_event(&app, LogEventFeedingStart, 0);
-                }
-                save_state(&app);
+            if(app.remind_alert) {
+                // The first key only dismisses the reminder banner
+                app.remind_alert = false;
                 view_port_update(view_port);
-            } else if(event->key == InputKeyDown) {
-                // Sleep button
-                uint32_t now = log_get_timestamp();
-                
-                if(app.state.sleep_active) {
-                    // Stop sleep - go to awake
-                    uint32_t duration = (now > app.state.sleep_start_ts) ? 
-                        (now - app.state.sleep_start_ts) : 0;
-                    log_add_event(&app, LogEventSleepStop, duration);
-                    app.state.sleep_active = false;
-                } else {
-                    // Start sleep - stop feeding if active
-                    if(app.state.feeding_active) {
-                        // Stop feeding first and log it
-                        uint32_t duration = (now > app.state.feeding_start_ts) ? 
-                            (now - app.state.feeding_start_ts) : 0;
-                        log_add_event(&app, LogEventFeedingStop, duration);
-                        app.state.feeding_active = false;
-                    }
-                    // Start sleep
-                    app.state.sleep_start_ts = now;
-                    app.state.sleep_active = true;
-                    log_add_event(&app, LogEventSleepStart, 0);
+                break;
+            }
+            // Main screen quick actions
+            if(event->key == InputKeyUp || event->key == InputKeyDown) {
+                // Feeding and sleep timers, mutually exclusive (see timer.h)
+                TimerKey key = (event->key == InputKeyUp) ? TimerKeyFeed : TimerKeySleep;
+                TimerStep step = timer_step(&app.state, key, app.now);
+                for(uint8_t i = 0; i < step.count; i++) {
+                    log_add_event(&app, step.events[i].type, step.events[i].duration);
                 }
-                save_state(&app);
+                save_state_deferred(&app);
                 view_port_update(view_port);
             } else if(event->key == InputKeyLeft) {
                 // Log diaper - with visual feedback
-                uint32_t now = log_get_timestamp();
                 log_add_event(&app, LogEventDiaper, 0);
-                app.state.last_diaper_ts = now; // Store timestamp for feedback
-                save_state(&app);
+                app.state.last_diaper_ts = app.now; // Feedback only, not saved
                 view_port_update(view_port);
+            } else if(event->key == InputKeyRight) {
+                // Next child
+                if(app.child_count > 1) {
+                    child_switch(&app, (app.active_child + 1) % app.child_count);
+                    view_port_update(view_port);
+                }
             } else if(event->key == InputKeyBack) {
                 // Open menu
                 current_screen = ScreenMenu;
@@ -127,7 +202,8 @@ static void input_cb(InputEvent* event, void* ctx) {
             break;
 
         case ScreenMenu:
-            // Menu screen navigation (6 items now)
+            app.delete_refused = false;
+            // Menu screen navigation
             if(event->key == InputKeyUp) {
                 if(app.menu_index > 0) {
                     app.menu_index--;
@@ -139,43 +215,108 @@ static void input_cb(InputEvent* event, void* ctx) {
                 app.menu_index = (app.menu_index + 1) % MENU_ITEM_COUNT;
                 view_port_update(view_port);
             } else if(event->key == InputKeyOk) {
-                if(app.menu_index == 0) {
-                    // Child profile
-                    current_screen = ScreenProfile;
-                    app.profile_index = 0;
-                    view_port_update(view_port);
-                } else if(app.menu_index == 1) {
-                    // Recent log
-                    current_screen = ScreenRecentLog;
-                    log_load_recent(&app);
-                    app.log_index = 0;
-                    view_port_update(view_port);
-                } else if(app.menu_index == 2) {
-                    // Delete last event - ensure logs are loaded first
-                    if(app.log_count == 0) {
-                        log_load_recent(&app);
-                    }
-                    log_delete_last(&app);
-                    view_port_update(view_port);
-                } else if(app.menu_index == 3) {
-                    // Clear all logs
-                    log_clear_all(&app);
-                    view_port_update(view_port);
-                } else if(app.menu_index == 4) {
-                    // Language selection
-                    app.lang_index = app.cfg.language;
-                    current_screen = ScreenLanguage;
-                    view_port_update(view_port);
-                } else if(app.menu_index == 5) {
-                    // Exit
-                    should_exit = true;
+                switch((MenuItem)app.menu_index) {
+                    case MenuItemProfile:
+                        current_screen = ScreenProfile;
+                        app.profile_index = 0;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemAddChild:
+                        if(child_add(&app)) {
+                            // Name the new child right away, starting from "BABY N"
+                            strncpy(app.edit_name, app.cfg.name, sizeof(app.edit_name) - 1);
+                            app.edit_name[sizeof(app.edit_name) - 1] = '\0';
+                            app.edit_name_pos = 0;
+                            app.edit_name_char = app.edit_name[0] - 'A';
+                            current_screen = ScreenEditName;
+                        }
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemRecentLog:
+                        current_screen = ScreenRecentLog;
+                        app.log_index = 0;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemAddPast:
+                        event_edit_open(NULL);
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemExport:
+                        app.export_status = JobIdle;
+                        current_screen = ScreenExport;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemImport:
+                        app.import_status = JobIdle;
+                        current_screen = ScreenImport;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemDeleteLast:
+                        diag_begin(DiagOpDelete);
+                        log_delete_last(&app);
+                        diag_end(DiagOpDelete);
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemUndo:
+                        diag_begin(DiagOpUndo);
+                        log_undo(&app);
+                        diag_end(DiagOpUndo);
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemRedo:
+                        diag_begin(DiagOpRedo);
+                        log_redo(&app);
+                        diag_end(DiagOpRedo);
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemClearAll:
+                        log_clear_all(&app);
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemCheck:
+                        app.check_status = JobIdle;
+                        app.check_resumable = log_check_resumable();
+                        current_screen = ScreenCheck;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemReminders:
+                        app.remind_index = 0;
+                        current_screen = ScreenReminders;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemLanguage:
+                        app.lang_index = (app.cfg.language < tr_language_count()) ? app.cfg.language : 0;
+                        current_screen = ScreenLanguage;
+                        view_port_update(view_port);
+                        break;
+                    case MenuItemExit:
+                        should_exit = true;
+                        break;
+                    default:
+                        break;
                 }
+            } else if(event->key == InputKeyRight) {
+                current_screen = ScreenDiag;
+                view_port_update(view_port);
             } else if(event->key == InputKeyBack) {
                 current_screen = ScreenMain;
                 view_port_update(view_port);
             }
             break;
 
+        case ScreenDiag:
+            // Diagnostics - Up/Down scroll the operations, OK refreshes,
+            // Back returns to the menu
+            if(event->key == InputKeyBack) {
+                current_screen = ScreenMenu;
+            } else if(event->key == InputKeyUp) {
+                if(app.diag_index > 0) app.diag_index--;
+            } else if(event->key == InputKeyDown) {
+                if(app.diag_index < DiagOpCount - DIAG_ROWS) app.diag_index++;
+            }
+            view_port_update(view_port);
+            break;
+
         case ScreenProfile:
             // Profile screen navigation (2 options - Language moved to main menu)
             if(event->key == InputKeyUp) {
@@ -405,7 +546,7 @@ static void input_cb(InputEvent* event, void* ctx) {
                 view_port_update(view_port);
             } else if(event->key == InputKeyBack) {
                 // Save if valid
-                if(is_valid_date(app.edit_year, app.edit_month, app.edit_day)) {
+                if(date_is_valid_birth(app.edit_year, app.edit_month, app.edit_day)) {
                     app.cfg.birth_y = app.edit_year;
                     app.cfg.birth_m = app.edit_month;
                     app.cfg.birth_d = app.edit_day;
@@ -434,33 +575,164 @@ static void input_cb(InputEvent* event, void* ctx) {
                 }
                 view_port_update(view_port);
             } else if(event->key == InputKeyDown) {
-                // Scroll down - show 4 items, so max index is count - 4
-                int max_idx = (app.log_count > 4) ? app.log_count - 4 : 0;
-                if(app.log_index < max_idx) {
+                // Move the selection down, the list scrolls once it passes 4 rows
+                if(app.log_index < app.log_count - 1) {
                     app.log_index++;
                 }
                 view_port_update(view_port);
+            } else if(event->key == InputKeyOk) {
+                // Fix time or duration of the selected event
+                LogEntry* entry = log_recent_get(&app, app.log_index);
+                if(entry) {
+                    event_edit_open(entry);
+                    view_port_update(view_port);
+                }
             } else if(event->key == InputKeyBack) {
                 current_screen = ScreenMenu;
                 view_port_update(view_port);
             }
             break;
 
+        case ScreenEditEvent:
+            // Add past event / fix time or duration
+            if(event->key == InputKeyLeft) {
+                event_field_move(-1);
+            } else if(event->key == InputKeyRight) {
+                event_field_move(1);
+            } else if(event->key == InputKeyUp) {
+                event_adjust(1);
+            } else if(event->key == InputKeyDown) {
+                event_adjust(-1);
+            } else if(event->key == InputKeyOk && event->type == InputTypePress) {
+                bool ok;
+                if(app.edit_event.id == 0) {
+                    ok = log_add_past_event(
+                        &app, app.edit_event.type, app.edit_event.timestamp, app.edit_event.duration);
+                } else {
+                    ok = log_edit_event(&app, &app.edit_event);
+                }
+                app.edit_event_error = !ok;
+                if(ok) event_edit_close();
+            } else if(event->key == InputKeyBack && event->type == InputTypePress) {
+                event_edit_close();
+            }
+            view_port_update(view_port);
+            break;
+
+        case ScreenExport:
+            // Export screen - pick format, then show progress
+            if(app.export_status == JobRunning) {
+                if(event->key == InputKeyBack) {
+                    log_export_cancel();
+                }
+            } else if(app.export_status == JobIdle) {
+                if(event->key == InputKeyUp || event->key == InputKeyDown) {
+                    app.export_format = (app.export_format == ExportFormatCsv) ? ExportFormatJson : ExportFormatCsv;
+                    view_port_update(view_port);
+                } else if(event->key == InputKeyLeft || event->key == InputKeyRight) {
+                    // All -> 7 -> 30 days
+                    app.export_days = (app.export_days == 0) ? 7 : (app.export_days == 7) ? 30 : 0;
+                    view_port_update(view_port);
+                } else if(event->key == InputKeyOk) {
+                    uint32_t since = 0;
+                    if(app.export_days > 0) {
+                        since = (uint32_t)(date_today() - app.export_days + 1) * 86400;
+                    }
+                    log_export_start(&app, (ExportFormat)app.export_format, since);
+                    view_port_update(view_port);
+                } else if(event->key == InputKeyBack) {
+                    current_screen = ScreenMenu;
+                    view_port_update(view_port);
+                }
+            } else if(event->key == InputKeyBack || event->key == InputKeyOk) {
+                // Done / cancelled / failed - back to menu
+                app.export_status = JobIdle;
+                current_screen = ScreenMenu;
+                view_port_update(view_port);
+            }
+            break;
+
+        case ScreenImport:
+            // Import screen - merge import/log.jsonl into the local log
+            if(app.import_status == JobRunning) {
+                if(event->key == InputKeyBack) {
+                    log_import_cancel();
+                }
+            } else if(app.import_status == JobIdle) {
+                if(event->key == InputKeyOk) {
+                    log_import_start(&app);
+                    view_port_update(view_port);
+                } else if(event->key == InputKeyBack) {
+                    current_screen = ScreenMenu;
+                    view_port_update(view_port);
+                }
+            } else if(event->key == InputKeyBack || event->key == InputKeyOk) {
+                app.import_status = JobIdle;
+                current_screen = ScreenMenu;
+                view_port_update(view_port);
+            }
+            break;
+
+        case ScreenCheck:
+            // Check log screen - full scan of log.jsonl, resumable
+            if(app.check_status == JobRunning) {
+                if(event->key == InputKeyBack) {
+                    log_check_cancel();
+                }
+            } else if(app.check_status == JobIdle) {
+                if(event->key == InputKeyOk) {
+                    log_check_start(&app);
+                    view_port_update(view_port);
+                } else if(event->key == InputKeyBack) {
+                    current_screen = ScreenMenu;
+                    view_port_update(view_port);
+                }
+            } else if(event->key == InputKeyBack || event->key == InputKeyOk) {
+                app.check_status = JobIdle;
+                current_screen = ScreenMenu;
+                view_port_update(view_port);
+            }
+            break;
+
+        case ScreenReminders:
+            // Reminders screen - Left/Right change the selected one, saved on Back
+            if(event->key == InputKeyUp) {
+                app.remind_index = (app.remind_index + ReminderCount - 1) % ReminderCount;
+                view_port_update(view_port);
+            } else if(event->key == InputKeyDown) {
+                app.remind_index = (app.remind_index + 1) % ReminderCount;
+                view_port_update(view_port);
+            } else if(event->key == InputKeyLeft) {
+                uint16_t* minutes = &app.remind_minutes[app.remind_index];
+                *minutes = (*minutes > REMIND_STEP_MINUTES) ? *minutes - REMIND_STEP_MINUTES : 0;
+                view_port_update(view_port);
+            } else if(event->key == InputKeyRight) {
+                uint16_t* minutes = &app.remind_minutes[app.remind_index];
+                if(*minutes + REMIND_STEP_MINUTES <= REMIND_MAX_MINUTES) *minutes += REMIND_STEP_MINUTES;
+                view_port_update(view_port);
+            } else if(event->key == InputKeyBack || event->key == InputKeyOk) {
+                save_config(&app);
+                current_screen = ScreenMenu;
+                view_port_update(view_port);
+            }
+            break;
+
         case ScreenLanguage:
             // Language selection screen
             if(event->key == InputKeyUp) {
                 if(app.lang_index > 0) {
                     app.lang_index--;
                 } else {
-                    app.lang_index = 2;
+                    app.lang_index = tr_language_count() - 1;
                 }
                 view_port_update(view_port);
             } else if(event->key == InputKeyDown) {
-                app.lang_index = (app.lang_index + 1) % 3;
+                app.lang_index = (app.lang_index + 1) % tr_language_count();
                 view_port_update(view_port);
             } else if(event->key == InputKeyOk) {
-                // Save language selection
+                // Save language selection and swap in its pack
                 app.cfg.language = app.lang_index;
+                tr_load(app.cfg.language);
                 save_config(&app);
                 current_screen = ScreenProfile;
                 view_port_update(view_port);
@@ -473,14 +745,72 @@ static void input_cb(InputEvent* event, void* ctx) {
     }
 }
 
+// GUI input thread: queue the key and wake the app thread, nothing else
+// Export/import run in small steps here so input stays responsive and Back
+// can cancel. Returns true if a job ran; called with the app lock held.
+static bool jobs_step(void) {
+    if(app.export_status == JobRunning) {
+        diag_begin(DiagOpExport);
+        log_export_step(&app);
+        diag_end(DiagOpExport);
+        view_port_update(view_port);
+        return true;
+    }
+    if(app.check_status == JobRunning) {
+        diag_begin(DiagOpCheck);
+        log_check_step(&app);
+        diag_end(DiagOpCheck);
+        view_port_update(view_port);
+        return true;
+    }
+    if(app.import_status == JobRunning) {
+        diag_begin(DiagOpImport);
+        bool more = log_import_step(&app);
+        diag_end(DiagOpImport);
+        if(!more && app.import_status == JobDone) {
+            log_load_recent(&app); // Merged log replaced the local one
+            log_journal_clear(&app); // Deleted events are gone from it
+            log_sessions_rebuild(&app);
+            log_last_seed(&app);
+            log_stats_rebuild(&app); // Once the index is rebuilt
+        }
+        view_port_update(view_port);
+        return true;
+    }
+    if(app.sessions_status == JobRunning) {
+        // Nothing on screen waits for it; once done it can fill in the
+        // last event of types the ring no longer holds
+        if(!log_sessions_step(&app) && app.sessions_status == JobDone) {
+            log_last_seed(&app);
+        }
+        return true;
+    }
+    if(app.stats_status == JobRunning) {
+        // The forecast changes once it is done
+        if(!log_stats_step(&app) && current_screen == ScreenMain) view_port_update(view_port);
+        return true;
+    }
+    return false;
+}
+
+static void input_cb(InputEvent* event, void* ctx) {
+    UNUSED(ctx);
+    if(event->type != InputTypePress && event->type != InputTypeRepeat) return;
+    if(input_queue_push(event)) furi_thread_flags_set(main_thread, TICK_FLAG_WAKE);
+}
+
 int32_t baby_log_app(void* p) {
     UNUSED(p);
 
     // Initialize app data
     memset(&app, 0, sizeof(app));
+    app_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    diag_init();
+    scratch_init();
     
     load_config(&app);
-    load_state(&app);
+    tr_init(app.cfg.language);
+    child_init(&app); // Loads the active child's profile, timers and recent ring
 
     // Initialize defaults
     app.menu_index = 0;
@@ -495,37 +825,103 @@ int32_t baby_log_app(void* p) {
     strncpy(app.edit_name, app.cfg.name, sizeof(app.edit_name) - 1);
     app.edit_name[sizeof(app.edit_name) - 1] = '\0';
 
+    main_thread = furi_thread_get_current_id();
+    last_input_ms = clock_now_ms(); // Animate on launch, backlight is on
+    reminder_init(reminder_timer_cb, NULL);
+
     Gui* gui = furi_record_open(RECORD_GUI);
     view_port = view_port_alloc();
     view_port_draw_callback_set(view_port, draw_cb, NULL);
     view_port_input_callback_set(view_port, input_cb, view_port);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
-    // Periodic update for timers and diaper feedback
+    // Redraw only when the main screen changes: timers, diaper feedback, bird
     while(!should_exit) {
-        furi_delay_ms(1000);
+        // Queued keys first - Back may cancel a job, Exit ends the loop
+        InputRecord input;
+        while(!should_exit && input_queue_pop(&input)) {
+            app_lock();
+            input_handle(&input);
+            app_unlock();
+        }
+        if(should_exit) break;
         
-        // Clear diaper feedback after 3 seconds
-        uint32_t now = log_get_timestamp();
+        app_lock();
+        bool busy = jobs_step();
+        app_unlock();
+        if(busy) {
+            furi_delay_ms(JOB_STEP_DELAY_MS);
+            continue;
+        }
+        
+        // Events logged since the last pass move the reminder deadlines
+        app_lock();
+        app.now = clock_now();
+        reminder_sync(&app, app.now);
+        
+        uint32_t now_ms = clock_now_ms();
+        uint32_t delay = tick_next_delay(
+            &app, current_screen == ScreenMain, app.now, now_ms, last_input_ms);
+        uint32_t flush_delay = log_append_delay(now_ms);
+        if(flush_delay < delay) delay = flush_delay;
+        app_unlock();
+        uint32_t flags = furi_thread_flags_wait(
+            TICK_FLAG_WAKE | TICK_FLAG_REMINDER,
+            FuriFlagWaitAny,
+            (delay == FuriWaitForever) ? FuriWaitForever : furi_ms_to_ticks(delay));
+        app_lock();
+        app.now = clock_now(); // Draw reads it, never the RTC
+        if(flags != (uint32_t)FuriFlagErrorTimeout) {
+            if(!(flags & FuriFlagError) && (flags & TICK_FLAG_REMINDER) && reminder_fire(&app, app.now) &&
+               current_screen == ScreenMain) {
+                view_port_update(view_port);
+            }
+            app_unlock();
+            continue; // Handle the queued input, then plan again
+        }
+        
+        log_append_poll(clock_now_ms());
+        
+        // Clear diaper feedback once it has been shown long enough
+        uint32_t now = app.now;
         if(app.state.last_diaper_ts > 0 && 
            now >= app.state.last_diaper_ts && 
-           (now - app.state.last_diaper_ts) >= 3) {
+           (now - app.state.last_diaper_ts) >= DIAPER_FEEDBACK_SECONDS) {
             app.state.last_diaper_ts = 0;
         }
         
-        // Update display if timers are active or diaper feedback is showing
-        if(app.state.feeding_active || app.state.sleep_active || app.state.last_diaper_ts > 0) {
-            view_port_update(view_port);
-        }
+        if(current_screen == ScreenMain) view_port_update(view_port);
+        app_unlock();
     }
 
-    // Save state before exit
-    save_state(&app);
-
-    // Cleanup
+    // Off the screen first, so nothing draws while the jobs are wound up
     gui_remove_view_port(gui, view_port);
     view_port_free(view_port);
     furi_record_close(RECORD_GUI);
 
+    // Abort unfinished jobs so partial files are removed
+    if(app.export_status == JobRunning) {
+        log_export_cancel();
+        log_export_step(&app);
+    }
+    if(app.import_status == JobRunning) {
+        log_import_cancel();
+        log_import_step(&app);
+    }
+    if(app.check_status == JobRunning) {
+        log_check_cancel(); // Saves the position for next time
+        log_check_step(&app);
+    }
+    log_sessions_cancel(&app); // Left dirty, rebuilt on the next start
+    log_stats_cancel(&app);
+
+    reminder_free();
+    
+    // Save state before exit
+    save_state_deferred(&app);
+    diag_dump();
+    log_tables_close();
+    furi_mutex_free(app_mutex);
+
     return 0;
 }
@@ -0,0 +1,196 @@
+#include "child.h"
+#include "log_store.h"
+#include "log_archive.h"
+#include "log_patch.h"
+#include "log_check.h"
+#include "log_stats.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "log_tables.h"
+#include <storage/storage.h>
+#include <furi.h>
+#include <string.h>
+
+static ChildPaths g_paths;
+
+static void paths_set(uint8_t child);
+
+const ChildPaths* child_paths(void) {
+    if(g_paths.dir[0] == '\0') paths_set(0); // Before child_init()
+    return &g_paths;
+}
+
+static void child_file(const char* name, char* out) {
+    snprintf(out, CHILD_PATH_LEN, "%s/%s", g_paths.dir, name);
+}
+
+static void paths_set(uint8_t child) {
+    if(child == 0) {
+        snprintf(g_paths.dir, CHILD_PATH_LEN, "%s", CHILD_ROOT_DIR);
+    } else {
+        snprintf(g_paths.dir, CHILD_PATH_LEN, "%s/child_%u", CHILD_ROOT_DIR, child);
+    }
+    child_file("config.json", g_paths.config);
+    child_file("state.json", g_paths.state);
+    child_file("log.jsonl", g_paths.log);
+    child_file("deleted.jsonl", g_paths.deleted);
+    child_file("deleted.tmp", g_paths.deleted_tmp);
+    child_file("tombstones.bin", g_paths.tombstones);
+    child_file("tombstones.tmp", g_paths.tombstones_tmp);
+    child_file("patches.jsonl", g_paths.patches);
+    child_file("patches.tmp", g_paths.patches_tmp);
+    child_file("quarantine.jsonl", g_paths.quarantine);
+    child_file("check.state", g_paths.check_state);
+    child_file("stats.bin", g_paths.stats);
+    child_file("sessions_feed.bin", g_paths.sessions_feed);
+    child_file("sessions_sleep.bin", g_paths.sessions_sleep);
+    child_file("last.bin", g_paths.last);
+    child_file("tables.ok", g_paths.tables_ok);
+    child_file("log.tmp", g_paths.log_tmp);
+    child_file("log.bak", g_paths.log_bak);
+    child_file("archive", g_paths.archive_dir);
+    child_file("archive/pending.bin", g_paths.archive_pending);
+    child_file("archive/reset", g_paths.archive_reset);
+    child_file("export.csv", g_paths.export_csv);
+    child_file("export.json", g_paths.export_json);
+}
+
+// Stash the working copy of the active child
+static void slot_save(AppData* app) {
+    ChildSlot* slot = &app->children[app->active_child];
+    slot->cfg = app->cfg;
+    slot->state = app->state;
+    memcpy(slot->log_entries, app->log_entries, sizeof(slot->log_entries));
+    slot->log_head = app->log_head;
+    slot->log_count = app->log_count;
+    slot->journal = app->journal;
+    slot->stats = app->stats;
+    slot->stats_stale = app->stats_status == JobRunning;
+    memcpy(slot->last, app->last, sizeof(slot->last));
+    slot->loaded = true;
+}
+
+static void slot_restore(AppData* app) {
+    ChildSlot* slot = &app->children[app->active_child];
+    uint8_t language = app->cfg.language; // App-wide
+    app->cfg = slot->cfg;
+    app->cfg.language = language;
+    app->state = slot->state;
+    memcpy(app->log_entries, slot->log_entries, sizeof(app->log_entries));
+    app->log_head = slot->log_head;
+    app->log_count = slot->log_count;
+    app->log_generation++;
+    app->journal = slot->journal;
+    app->stats = slot->stats;
+    memcpy(app->last, slot->last, sizeof(app->last));
+}
+
+// First visit: finish storage housekeeping and seed the caches from disk
+static void slot_load(AppData* app) {
+    bool clean = log_tables_open();
+    load_profile(app);
+    load_state(app);
+    log_swap_recover();
+    app->check_repaired = log_check_tail();
+    log_patches_load();
+    log_archive_rotate();
+    log_load_recent(app);
+    log_journal_load(app);
+    if(!clean) {
+        log_tables_rebuild(app);
+    } else {
+        log_stats_load(app);
+        if(app->check_repaired > 0) {
+            log_sessions_rebuild(app); // Cut lines may be in the index
+        } else {
+            log_sessions_load(app);
+        }
+        log_last_load(app);
+    }
+    slot_save(app);
+}
+
+// What the reminders of a child that is not active need, without its log
+static void slot_peek(AppData* app, uint8_t child) {
+    ChildSlot* slot = &app->children[child];
+    paths_set(child);
+    if(child > 0) read_profile(&slot->cfg); // Child 0's is in the root config
+    read_state(&slot->state);
+    if(!log_last_read(slot->last)) memset(slot->last, 0, sizeof(slot->last));
+    slot->peeked = true;
+}
+
+void child_init(AppData* app) {
+    if(app->child_count < 1 || app->child_count > CHILD_MAX) app->child_count = 1;
+    if(app->active_child >= app->child_count) app->active_child = 0;
+
+    // Root config already holds child 0's profile
+    app->children[0].cfg = app->cfg;
+    for(uint8_t child = 0; child < app->child_count; child++) {
+        if(child != app->active_child) slot_peek(app, child);
+    }
+
+    paths_set(app->active_child);
+    slot_load(app);
+}
+
+void child_switch(AppData* app, uint8_t child) {
+    if(child >= app->child_count || child == app->active_child) return;
+    debug_log("child_switch: start");
+
+    log_tables_close(); // Before the paths change
+    slot_save(app);
+    log_stats_cancel(app);
+    app->active_child = child;
+    paths_set(child);
+    app->log_index = 0;
+
+    if(app->children[child].loaded) {
+        log_tables_open(); // The slot has the set as it was closed
+        slot_restore(app); // Warm - no log reads
+        log_patches_load(); // The overlay and tombstones are not per slot
+        log_tombstones_load();
+        log_sessions_load(app); // Header check, or a rebuild if the last one was cut short
+        app->stats_status = JobIdle;
+        if(app->children[child].stats_stale) log_stats_rebuild(app);
+    } else {
+        slot_load(app);
+    }
+    save_config(app); // Remember the active child
+    debug_log("child_switch: done");
+}
+
+bool child_add(AppData* app) {
+    if(app->child_count >= CHILD_MAX) return false;
+
+    uint8_t child = app->child_count++;
+    ChildSlot* slot = &app->children[child];
+    memset(slot, 0, sizeof(ChildSlot));
+    snprintf(slot->cfg.name, sizeof(slot->cfg.name), "BABY %u", child + 1);
+    slot->cfg.birth_y = app->cfg.birth_y;
+    slot->cfg.birth_m = app->cfg.birth_m;
+    slot->cfg.birth_d = app->cfg.birth_d;
+    slot->loaded = true; // Nothing on disk yet
+
+    log_tables_close(); // Before the paths change
+    slot_save(app);
+    log_stats_cancel(app);
+    app->active_child = child;
+    paths_set(child);
+    slot_restore(app);
+    app->stats_status = JobIdle;
+    log_patches_load();
+    log_tombstones_load();
+    app->log_index = 0;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, CHILD_ROOT_DIR);
+    storage_common_mkdir(storage, g_paths.dir);
+    furi_record_close(RECORD_STORAGE);
+    log_sessions_clear(app);
+
+    save_config(app);
+    save_state(app);
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "app_state.h"
+
+// ==== CHILD PROFILES ====
+// Each child has its own directory holding log, tombstones, patches, archive, exports
+// and active timers. Child 0 lives in the app root, so single-child setups
+// keep their existing files; child N uses apps/baby_log/child_N/.
+// config.json in the root also holds the app-wide settings.
+
+#define CHILD_ROOT_DIR EXT_PATH("apps/baby_log")
+#define CHILD_PATH_LEN 64
+
+typedef struct {
+    char dir[CHILD_PATH_LEN];
+    char config[CHILD_PATH_LEN];
+    char state[CHILD_PATH_LEN];
+    char log[CHILD_PATH_LEN];
+    char deleted[CHILD_PATH_LEN];
+    char deleted_tmp[CHILD_PATH_LEN];
+    char tombstones[CHILD_PATH_LEN];
+    char tombstones_tmp[CHILD_PATH_LEN];
+    char patches[CHILD_PATH_LEN];
+    char patches_tmp[CHILD_PATH_LEN];
+    char quarantine[CHILD_PATH_LEN];
+    char check_state[CHILD_PATH_LEN];
+    char stats[CHILD_PATH_LEN];
+    char sessions_feed[CHILD_PATH_LEN];
+    char sessions_sleep[CHILD_PATH_LEN];
+    char last[CHILD_PATH_LEN];
+    char tables_ok[CHILD_PATH_LEN];
+    char log_tmp[CHILD_PATH_LEN];
+    char log_bak[CHILD_PATH_LEN];
+    char archive_dir[CHILD_PATH_LEN];
+    char archive_pending[CHILD_PATH_LEN];
+    char archive_reset[CHILD_PATH_LEN];
+    char export_csv[CHILD_PATH_LEN];
+    char export_json[CHILD_PATH_LEN];
+} ChildPaths;
+
+const ChildPaths* child_paths(void); // Paths of the active child
+
+void child_init(AppData* app); // After load_config(): select the saved active child
+void child_switch(AppData* app, uint8_t child);
+bool child_add(AppData* app); // Create and switch to a new child
@@ -0,0 +1,48 @@
+#include "clock.h"
+#include <furi.h>
+#include <furi_hal_rtc.h>
+
+static struct {
+    bool simulated;
+    uint32_t now; // Simulated time
+    uint32_t skew_ms; // Time skipped by clock_advance(), never taken back
+} g_clock;
+
+uint32_t clock_now(void) {
+    if(g_clock.simulated) return g_clock.now;
+    DateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    return datetime_datetime_to_timestamp(&datetime);
+}
+
+void clock_now_datetime(DateTime* datetime) {
+    if(g_clock.simulated) {
+        datetime_timestamp_to_datetime(g_clock.now, datetime);
+    } else {
+        furi_hal_rtc_get_datetime(datetime);
+    }
+}
+
+uint32_t clock_now_ms(void) {
+    uint32_t ms = (uint32_t)((uint64_t)furi_get_tick() * 1000 / furi_kernel_get_tick_frequency());
+    return ms + g_clock.skew_ms;
+}
+
+void clock_simulate(uint32_t ts) {
+    g_clock.now = ts;
+    g_clock.simulated = true;
+}
+
+void clock_advance(uint32_t seconds) {
+    if(!g_clock.simulated) clock_simulate(clock_now());
+    g_clock.now += seconds;
+    g_clock.skew_ms += seconds * 1000;
+}
+
+void clock_use_rtc(void) {
+    g_clock.simulated = false;
+}
+
+bool clock_simulated(void) {
+    return g_clock.simulated;
+}
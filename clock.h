@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <datetime/datetime.h>
+
+// ==== CLOCK ====
+// Every read of the time goes through here. The RTC is the default source.
+// A simulated clock stands still at a chosen time and moves only when
+// fast-forwarded, so days of durations, forecasts, reminders and archive
+// cutoffs can be replayed the same way every run. Skipped time is added
+// to the millisecond clock too, so caches that expire on it (age at
+// midnight, the append buffer) see the jump.
+// Only the host tests simulate (test_timer replays random days of the
+// feed/sleep keys); the app always runs on the RTC.
+
+uint32_t clock_now(void); // Unix seconds, local time
+void clock_now_datetime(DateTime* datetime);
+uint32_t clock_now_ms(void); // Monotonic, for intervals only
+
+void clock_simulate(uint32_t ts); // Stand still at ts
+void clock_advance(uint32_t seconds); // Starts simulating from now if not already
+void clock_use_rtc(void);
+bool clock_simulated(void);
@@ -0,0 +1,79 @@
+#include "date_util.h"
+#include "clock.h"
+
+bool date_is_leap(uint16_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+uint8_t date_days_in_month(uint16_t year, uint8_t month) {
+    static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if(month < 1 || month > 12) return 0;
+    return (month == 2 && date_is_leap(year)) ? 29 : days[month - 1];
+}
+
+bool date_is_valid(uint16_t year, uint8_t month, uint8_t day) {
+    return day >= 1 && day <= date_days_in_month(year, month);
+}
+
+// Era-based conversion (400-year cycles of 146097 days), no tables or loops
+int32_t date_to_days(uint16_t year, uint8_t month, uint8_t day) {
+    int32_t y = (int32_t)year - (month <= 2);
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400); // [0, 399]
+    uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy; // [0, 146096]
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+void date_from_days(int32_t days, uint16_t* year, uint8_t* month, uint8_t* day) {
+    days += 719468;
+    int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t doe = (uint32_t)(days - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    *year = (uint16_t)((int32_t)yoe + era * 400 + (m <= 2));
+    *month = (uint8_t)m;
+    *day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+}
+
+int32_t date_today(void) {
+    DateTime now;
+    clock_now_datetime(&now);
+    return date_to_days(now.year, now.month, now.day);
+}
+
+bool date_is_valid_birth(uint16_t year, uint8_t month, uint8_t day) {
+    if(year < 2000 || year > 2100) return false;
+    if(!date_is_valid(year, month, day)) return false;
+    return date_to_days(year, month, day) <= date_today();
+}
+
+// Monthly birthday N months after birth, clamped to short months (Jan 31 -> Feb 28)
+static int32_t add_months(uint16_t year, uint8_t month, uint8_t day, uint32_t months) {
+    uint32_t index = (uint32_t)(month - 1) + months;
+    uint16_t y = year + index / 12;
+    uint8_t m = index % 12 + 1;
+    uint8_t last = date_days_in_month(y, m);
+    return date_to_days(y, m, day > last ? last : day);
+}
+
+void date_age(int32_t birth, int32_t today, DateAge* age) {
+    age->days = 0;
+    age->months = 0;
+    age->month_days = 0;
+    if(today <= birth) return;
+
+    uint16_t by, ty;
+    uint8_t bm, bd, tm, td;
+    date_from_days(birth, &by, &bm, &bd);
+    date_from_days(today, &ty, &tm, &td);
+
+    int32_t months = ((int32_t)ty - by) * 12 + ((int32_t)tm - bm);
+    if(months > 0 && add_months(by, bm, bd, months) > today) months--;
+
+    age->days = today - birth;
+    age->months = months;
+    age->month_days = today - add_months(by, bm, bd, months);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// ==== GREGORIAN DATES ====
+// Dates as day numbers (days since 1970-01-01), so differences are exact
+// across month lengths and leap years.
+
+bool date_is_leap(uint16_t year);
+uint8_t date_days_in_month(uint16_t year, uint8_t month);
+bool date_is_valid(uint16_t year, uint8_t month, uint8_t day);
+int32_t date_to_days(uint16_t year, uint8_t month, uint8_t day);
+void date_from_days(int32_t days, uint16_t* year, uint8_t* month, uint8_t* day);
+int32_t date_today(void); // Local date from clock_now()
+
+// Birth dates: valid, 2000-2100 and not in the future
+bool date_is_valid_birth(uint16_t year, uint8_t month, uint8_t day);
+
+typedef struct {
+    uint32_t days; // Total
+    uint32_t months; // Whole calendar months
+    uint32_t month_days; // Days since the last monthly birthday
+} DateAge;
+
+void date_age(int32_t birth, int32_t today, DateAge* age);
@@ -0,0 +1,112 @@
+#include "diag.h"
+#include "clock.h"
+#include "log_store.h"
+#include "input_queue.h"
+#include "scratch.h"
+#include "log_append.h"
+#include "log_sessions.h"
+
+typedef enum {
+    DiagThreadApp = 0,
+    DiagThreadGui,
+    DiagThreadCount,
+} DiagThread;
+
+static DiagOpStats g_ops[DiagOpCount];
+static uint32_t g_stack_low[DiagThreadCount]; // Lowest free stack seen per thread
+static FuriThreadId g_app_thread = NULL;
+
+static const char* const op_names[DiagOpCount] = {
+    [DiagOpLoad] = "load",
+    [DiagOpAdd] = "add",
+    [DiagOpDelete] = "delete",
+    [DiagOpUndo] = "undo",
+    [DiagOpRedo] = "redo",
+    [DiagOpExport] = "export",
+    [DiagOpImport] = "import",
+    [DiagOpCheck] = "check",
+    [DiagOpRotate] = "rotate",
+    [DiagOpDraw] = "draw",
+};
+
+void diag_init(void) {
+    memset(g_ops, 0, sizeof(g_ops));
+    for(int i = 0; i < DiagThreadCount; i++) {
+        g_stack_low[i] = UINT32_MAX;
+    }
+    g_app_thread = furi_thread_get_current_id();
+}
+
+void diag_begin(DiagOp op) {
+    DiagOpStats* stats = &g_ops[op];
+    stats->start_ms = clock_now_ms();
+    stats->start_heap_min = memmgr_get_minimum_free_heap();
+}
+
+void diag_end(DiagOp op) {
+    DiagOpStats* stats = &g_ops[op];
+    stats->count++;
+
+    uint32_t elapsed = clock_now_ms() - stats->start_ms;
+    if(elapsed > stats->max_ms) stats->max_ms = elapsed;
+
+    size_t heap_min = memmgr_get_minimum_free_heap();
+    if(heap_min < stats->start_heap_min && stats->start_heap_min - heap_min > stats->heap_drop) {
+        stats->heap_drop = stats->start_heap_min - heap_min;
+    }
+
+    // The high-water mark only moves down; a new low belongs to this op
+    uint32_t* low = &g_stack_low[(op == DiagOpDraw) ? DiagThreadGui : DiagThreadApp];
+    uint32_t free = furi_thread_get_stack_space(furi_thread_get_current_id());
+    if(free < *low) {
+        *low = free;
+        stats->stack_free = free;
+    }
+}
+
+const DiagOpStats* diag_op(DiagOp op) {
+    return &g_ops[op];
+}
+
+const char* diag_op_name(DiagOp op) {
+    return op_names[op];
+}
+
+uint32_t diag_app_stack_free(void) {
+    return g_app_thread ? furi_thread_get_stack_space(g_app_thread) : 0;
+}
+
+void diag_dump(void) {
+    char line[128];
+    snprintf(line, sizeof(line), "diag: stack_free=%lu heap_free=%lu heap_min=%lu scratch=%lu/%lu keys_dropped=%lu",
+        (unsigned long)diag_app_stack_free(),
+        (unsigned long)memmgr_get_free_heap(),
+        (unsigned long)memmgr_get_minimum_free_heap(),
+        (unsigned long)scratch_peak(),
+        (unsigned long)SCRATCH_ARENA_SIZE,
+        (unsigned long)input_queue_dropped());
+    debug_log(line);
+
+    for(int i = 0; i < DiagOpCount; i++) {
+        const DiagOpStats* stats = &g_ops[i];
+        snprintf(line, sizeof(line), "diag: %s n=%lu stack_free=%lu heap_drop=%lu max_ms=%lu",
+            op_names[i],
+            (unsigned long)stats->count,
+            (unsigned long)stats->stack_free,
+            (unsigned long)stats->heap_drop,
+            (unsigned long)stats->max_ms);
+        debug_log(line);
+    }
+
+    const LogAppendStats* append = log_append_stats();
+    snprintf(line, sizeof(line), "diag: log_append lines=%lu writes=%lu sectors=%lu",
+        (unsigned long)append->lines,
+        (unsigned long)append->writes,
+        (unsigned long)append->sectors);
+    debug_log(line);
+
+    snprintf(line, sizeof(line), "diag: log_sessions feed=%lu sleep=%lu",
+        (unsigned long)log_sessions_count(SessionFeeding),
+        (unsigned long)log_sessions_count(SessionSleep));
+    debug_log(line);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <furi.h>
+
+// ==== DIAGNOSTICS ====
+// Stack and heap high-water marks, to see how close to the edge the app
+// runs. Instrumented operations record, per operation:
+//   stack_free  lowest free stack of its thread, if this op set a new low
+//   heap_drop   how far it pushed the heap's minimum-free mark down
+//   max_ms      slowest run
+// Draw runs on the GUI thread, everything else on the app thread; each
+// thread's mark is tracked separately. The counters are shared by both
+// threads, so ops run under the app lock (see baby_log.c), which the
+// Diagnostics screen also holds while it reads them. Costs one stack
+// high-water query per operation. Shown on the hidden Diagnostics screen (Right on the
+// menu) and written to debug.log on exit.
+
+typedef enum {
+    DiagOpLoad = 0, // Recent ring seeded from the log
+    DiagOpAdd,
+    DiagOpDelete,
+    DiagOpUndo,
+    DiagOpRedo,
+    DiagOpExport, // One step of the job
+    DiagOpImport, // One step of the job
+    DiagOpCheck, // One step of the job
+    DiagOpRotate, // Archive rotation, when due
+    DiagOpDraw,
+    DiagOpCount,
+} DiagOp;
+
+#define DIAG_ROWS 4 // Operation rows the Diagnostics screen fits, Up/Down scroll
+
+typedef struct {
+    uint32_t count;
+    uint32_t stack_free; // 0 = never set a new low
+    uint32_t heap_drop;
+    uint32_t max_ms;
+    uint32_t start_ms;
+    size_t start_heap_min;
+} DiagOpStats;
+
+void diag_init(void); // On the app thread
+void diag_begin(DiagOp op);
+void diag_end(DiagOp op);
+const DiagOpStats* diag_op(DiagOp op);
+const char* diag_op_name(DiagOp op);
+uint32_t diag_app_stack_free(void); // App thread's lowest free stack ever
+void diag_dump(void); // Into debug.log
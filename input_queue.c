@@ -0,0 +1,38 @@
+#include "input_queue.h"
+#include <stdatomic.h>
+
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+static InputRecord g_ring[INPUT_QUEUE_SIZE];
+static atomic_uint g_head; // Next slot to write, written by the producer only
+static atomic_uint g_tail; // Next slot to read, written by the consumer only
+static atomic_uint g_dropped;
+
+bool input_queue_push(const InputEvent* event) {
+    unsigned head = atomic_load_explicit(&g_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&g_tail, memory_order_acquire);
+    if(head - tail == INPUT_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    InputRecord* record = &g_ring[head & INPUT_QUEUE_MASK];
+    record->key = (uint8_t)event->key;
+    record->type = (uint8_t)event->type;
+    atomic_store_explicit(&g_head, head + 1, memory_order_release); // Record visible first
+    return true;
+}
+
+bool input_queue_pop(InputRecord* record) {
+    unsigned tail = atomic_load_explicit(&g_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&g_head, memory_order_acquire);
+    if(head == tail) return false;
+
+    *record = g_ring[tail & INPUT_QUEUE_MASK];
+    atomic_store_explicit(&g_tail, tail + 1, memory_order_release); // Slot free after the copy
+    return true;
+}
+
+uint32_t input_queue_dropped(void) {
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <furi.h>
+#include <input/input.h>
+
+// ==== INPUT QUEUE ====
+// Single-producer/single-consumer ring between the GUI input callback and
+// the app thread. The callback only pushes a 2-byte record and wakes the
+// app thread, which drains the queue and runs all handling (including SD
+// I/O), so app state has one writer and the input callback never blocks.
+// Draw still reads app state; baby_log.c's app lock keeps it from seeing
+// a half-made change.
+// Wait-free: each side owns one index and publishes it with release
+// semantics. A full queue drops the new press.
+
+#define INPUT_QUEUE_SIZE 16 // Power of two
+
+typedef struct {
+    uint8_t key; // InputKey
+    uint8_t type; // InputType
+} InputRecord;
+
+bool input_queue_push(const InputEvent* event); // Producer (input callback) only
+bool input_queue_pop(InputRecord* record); // Consumer (app thread) only
+uint32_t input_queue_dropped(void); // Presses lost to a full queue
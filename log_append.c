@@ -0,0 +1,103 @@
+#include "log_append.h"
+#include "app_state.h"
+#include "log_store.h"
+#include "clock.h"
+#include <storage/storage.h>
+#include <string.h>
+
+static struct {
+    uint8_t buffer[LOG_SECTOR_SIZE];
+    size_t fill;
+    uint32_t base; // File size on the card when buffer[0] lands, valid while fill > 0
+    uint32_t since_ms; // When the oldest buffered byte arrived
+    char path[CHILD_PATH_LEN]; // log.jsonl the buffer belongs to
+    LogAppendStats stats;
+} g_append;
+
+// Room left before the buffer ends on a sector boundary of the file
+static size_t append_room(void) {
+    return LOG_SECTOR_SIZE - (g_append.base % LOG_SECTOR_SIZE) - g_append.fill;
+}
+
+static void append_start(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FileInfo info;
+    g_append.base = (storage_common_stat(storage, LOG_PATH, &info) == FSE_OK) ? (uint32_t)info.size : 0;
+    furi_record_close(RECORD_STORAGE);
+
+    strncpy(g_append.path, LOG_PATH, sizeof(g_append.path) - 1);
+    g_append.path[sizeof(g_append.path) - 1] = '\0';
+    g_append.since_ms = clock_now_ms();
+}
+
+bool log_append_flush(void) {
+    if(g_append.fill == 0) return true;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, LOG_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, g_append.path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        ok = storage_file_write(file, g_append.buffer, g_append.fill) == g_append.fill;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!ok) {
+        debug_log("log_append_flush: write failed");
+        return false;
+    }
+
+    uint32_t offset = g_append.base % LOG_SECTOR_SIZE;
+    g_append.stats.writes++;
+    g_append.stats.sectors += (offset + g_append.fill + LOG_SECTOR_SIZE - 1) / LOG_SECTOR_SIZE;
+    g_append.base += g_append.fill;
+    g_append.fill = 0;
+    return true;
+}
+
+bool log_append_pending(void) {
+    return g_append.fill > 0;
+}
+
+bool log_append(const char* line, size_t len) {
+    if(g_append.fill == 0) append_start();
+
+    // A line is at most LOG_LINE_MAX, so it needs at most one sector write
+    size_t fill_before = g_append.fill;
+    size_t room = append_room();
+    size_t head = (len < room) ? len : room;
+    memcpy(g_append.buffer + g_append.fill, line, head);
+    g_append.fill += head;
+
+    if(head == room) {
+        if(!log_append_flush()) {
+            g_append.fill = fill_before; // Drop the whole line, not part of it
+            return false;
+        }
+        g_append.since_ms = clock_now_ms();
+        memcpy(g_append.buffer, line + head, len - head);
+        g_append.fill = len - head;
+    }
+    g_append.stats.lines++;
+    return true;
+}
+
+void log_append_discard(void) {
+    g_append.fill = 0;
+}
+
+uint32_t log_append_delay(uint32_t now_ms) {
+    if(g_append.fill == 0) return FuriWaitForever;
+    uint32_t waited = now_ms - g_append.since_ms;
+    return (waited >= LOG_APPEND_HOLD_MS) ? 0 : LOG_APPEND_HOLD_MS - waited;
+}
+
+void log_append_poll(uint32_t now_ms) {
+    if(log_append_delay(now_ms) == 0) log_append_flush();
+}
+
+const LogAppendStats* log_append_stats(void) {
+    return &g_append.stats;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <furi.h>
+
+// ==== APPEND BUFFER ====
+// New log.jsonl lines are collected in one sector-sized buffer instead of
+// opening, writing and closing the file per event. FAT rewrites a whole
+// 512-byte sector (and the directory entry) for every small append, so the
+// buffer only ever ends a write on a sector boundary of the file: a line
+// that crosses the boundary is split, the full sector is written and the
+// rest waits in the buffer.
+// What is buffered is written out when the sector fills, after
+// LOG_APPEND_HOLD_MS, before anything reads or replaces log.jsonl, on child
+// switch and on exit. A crash loses at most the buffer; a line cut at a
+// sector boundary is removed by log_check_tail() at the next start.
+
+#define LOG_SECTOR_SIZE 512
+#define LOG_APPEND_HOLD_MS (2 * 60 * 1000) // Oldest buffered line waits at most this long
+
+// Counted since launch, written to debug.log by diag_dump()
+typedef struct {
+    uint32_t lines;
+    uint32_t writes; // File writes (open, write, close)
+    uint32_t sectors; // Sectors those writes touched
+} LogAppendStats;
+
+bool log_append(const char* line, size_t len); // False if a sector write failed; nothing is kept then
+bool log_append_flush(void); // Write out what is buffered
+bool log_append_pending(void); // Lines are waiting in the buffer
+void log_append_discard(void); // log.jsonl was removed
+uint32_t log_append_delay(uint32_t now_ms); // Until the hold expires, FuriWaitForever if empty
+void log_append_poll(uint32_t now_ms); // Flush once the hold has expired
+const LogAppendStats* log_append_stats(void);
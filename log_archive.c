@@ -0,0 +1,618 @@
+#include "log_archive.h"
+#include "log_store.h"
+#include "log_patch.h"
+#include "log_append.h"
+#include "log_tables.h"
+#include "scratch.h"
+#include "clock.h"
+#include "diag.h"
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+#define RESTARTS_PER_BLOCK (LOG_BLOCK_MAX_RECORDS / LOG_BLOCK_RESTART_INTERVAL)
+
+void log_archive_segment_path(uint32_t index, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s/seg_%04lu.bin", ARCHIVE_DIR, (unsigned long)index);
+}
+
+static uint32_t segment_count(Storage* storage) {
+    char path[64];
+    uint32_t count = 0;
+    while(count < ARCHIVE_MAX_SEGMENTS) {
+        log_archive_segment_path(count + 1, path, sizeof(path));
+        if(!storage_common_exists(storage, path)) break;
+        count++;
+    }
+    return count;
+}
+
+uint32_t log_archive_segment_count(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    uint32_t count = segment_count(storage);
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
+
+static void remove_segments(Storage* storage) {
+    char path[64];
+    uint32_t count = segment_count(storage);
+    for(uint32_t i = count; i > 0; i--) {
+        log_archive_segment_path(i, path, sizeof(path));
+        storage_common_remove(storage, path);
+    }
+}
+
+// Called once the swapped log is in place
+void log_archive_commit(Storage* storage) {
+    if(storage_common_exists(storage, ARCHIVE_RESET_PATH)) {
+        // New log already holds the full history
+        remove_segments(storage);
+        storage_common_remove(storage, ARCHIVE_RESET_PATH);
+    }
+    if(storage_common_exists(storage, ARCHIVE_PENDING_PATH)) {
+        char path[64];
+        log_archive_segment_path(segment_count(storage) + 1, path, sizeof(path));
+        storage_common_rename(storage, ARCHIVE_PENDING_PATH, path);
+    }
+}
+
+// Called when a swap is rolled back
+void log_archive_abort(Storage* storage) {
+    storage_common_remove(storage, ARCHIVE_PENDING_PATH);
+    storage_common_remove(storage, ARCHIVE_RESET_PATH);
+}
+
+void log_archive_clear(Storage* storage) {
+    remove_segments(storage);
+    log_archive_abort(storage);
+}
+
+// ==== SEGMENT WRITER ====
+
+// The segment is reserved as one contiguous extent when it is created, so
+// block writes land in allocated clusters instead of growing the chain one
+// cluster at a time. writer_finish() cuts the file back to its logical end
+// (the footer); readers only ever see the trimmed file.
+#define ARCHIVE_SEGMENT_MAX_SIZE                                      \
+    (LOG_ARCHIVE_HEADER_SIZE + ARCHIVE_MAX_BLOCKS * LOG_BLOCK_MAX_SIZE + \
+     ARCHIVE_MAX_BLOCKS * LOG_ARCHIVE_INDEX_ENTRY_SIZE + LOG_ARCHIVE_FOOTER_SIZE)
+#define ARCHIVE_EXTENT_ALIGN 512
+
+static struct {
+    File* file;
+    bool reserved; // Extent preallocated, trim on finish
+    uint32_t offset; // Next write position
+    uint32_t record_count;
+    uint32_t block_count;
+    uint8_t block[LOG_BLOCK_MAX_SIZE];
+    size_t payload_len;
+    uint8_t block_records;
+    uint8_t restart_count;
+    uint16_t restarts[RESTARTS_PER_BLOCK];
+    uint32_t base_ts;
+    uint32_t prev_ts;
+    uint8_t index[ARCHIVE_MAX_BLOCKS * LOG_ARCHIVE_INDEX_ENTRY_SIZE];
+} g_writer;
+
+static bool writer_write(const uint8_t* data, size_t len) {
+    if(storage_file_write(g_writer.file, data, len) != len) return false;
+    g_writer.offset += len;
+    return true;
+}
+
+static bool writer_flush_block(void) {
+    if(g_writer.block_records == 0) return true;
+
+    uint8_t* hdr = g_writer.block;
+    log_put_u16(hdr, (uint16_t)g_writer.payload_len);
+    hdr[2] = g_writer.block_records;
+    hdr[3] = g_writer.restart_count;
+    log_put_u32(hdr + 4, g_writer.base_ts);
+
+    size_t len = LOG_BLOCK_HEADER_SIZE + g_writer.payload_len;
+    for(uint8_t i = 0; i < g_writer.restart_count; i++) {
+        log_put_u16(g_writer.block + len, g_writer.restarts[i]);
+        len += 2;
+    }
+
+    uint8_t* entry = g_writer.index + g_writer.block_count * LOG_ARCHIVE_INDEX_ENTRY_SIZE;
+    log_put_u32(entry, g_writer.base_ts);
+    log_put_u32(entry + 4, g_writer.offset);
+    g_writer.block_count++;
+
+    g_writer.payload_len = 0;
+    g_writer.block_records = 0;
+    g_writer.restart_count = 0;
+    return writer_write(g_writer.block, len);
+}
+
+static bool writer_full(void) {
+    return g_writer.block_count >= ARCHIVE_MAX_BLOCKS;
+}
+
+static bool writer_add(const LogRecord* rec) {
+    if(g_writer.block_records == 0) {
+        g_writer.base_ts = rec->ts;
+    }
+    if(g_writer.block_records % LOG_BLOCK_RESTART_INTERVAL == 0) {
+        g_writer.restarts[g_writer.restart_count++] = (uint16_t)g_writer.payload_len;
+        g_writer.prev_ts = g_writer.base_ts;
+    }
+
+    g_writer.payload_len += log_record_encode(
+        rec, g_writer.prev_ts, g_writer.block + LOG_BLOCK_HEADER_SIZE + g_writer.payload_len);
+    g_writer.prev_ts = rec->ts;
+    g_writer.block_records++;
+    g_writer.record_count++;
+
+    if(g_writer.block_records >= LOG_BLOCK_MAX_RECORDS ||
+       g_writer.payload_len >= LOG_BLOCK_PAYLOAD_TARGET) {
+        return writer_flush_block();
+    }
+    return true;
+}
+
+// source_size is the log being rotated: encoded records are shorter than
+// their text, so only records patched in from the overlay can make the
+// segment outgrow the extent - the file then just grows past it
+static bool writer_open(Storage* storage, uint32_t source_size) {
+    memset(&g_writer, 0, sizeof(g_writer));
+    storage_common_mkdir(storage, ARCHIVE_DIR);
+    g_writer.file = storage_file_alloc(storage);
+    if(!storage_file_open(g_writer.file, ARCHIVE_PENDING_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(g_writer.file);
+        g_writer.file = NULL;
+        return false;
+    }
+
+    uint32_t extent = source_size + LOG_ARCHIVE_HEADER_SIZE +
+                      ARCHIVE_MAX_BLOCKS * LOG_ARCHIVE_INDEX_ENTRY_SIZE + LOG_ARCHIVE_FOOTER_SIZE;
+    if(extent > ARCHIVE_SEGMENT_MAX_SIZE) extent = ARCHIVE_SEGMENT_MAX_SIZE;
+    extent = (extent + ARCHIVE_EXTENT_ALIGN - 1) / ARCHIVE_EXTENT_ALIGN * ARCHIVE_EXTENT_ALIGN;
+    // Best effort - no contiguous space just means the old cluster-by-cluster growth
+    g_writer.reserved = storage_file_expand(g_writer.file, extent);
+    if(!g_writer.reserved) debug_log("log_archive: extent not reserved");
+    uint8_t header[LOG_ARCHIVE_HEADER_SIZE] = {0}; // Patched in writer_finish
+    return writer_write(header, sizeof(header));
+}
+
+static bool writer_finish(void) {
+    bool ok = writer_flush_block();
+
+    // Block index + footer
+    uint32_t index_offset = g_writer.offset;
+    ok = ok && writer_write(g_writer.index, g_writer.block_count * LOG_ARCHIVE_INDEX_ENTRY_SIZE);
+    uint8_t footer[LOG_ARCHIVE_FOOTER_SIZE];
+    log_put_u32(footer, index_offset);
+    memcpy(footer + 4, LOG_ARCHIVE_FOOTER_MAGIC, 4);
+    ok = ok && writer_write(footer, sizeof(footer));
+
+    uint8_t header[LOG_ARCHIVE_HEADER_SIZE];
+    memcpy(header, LOG_ARCHIVE_MAGIC, 4);
+    log_put_u16(header + 4, LOG_ARCHIVE_VERSION);
+    log_put_u16(header + 6, 0);
+    log_put_u32(header + 8, g_writer.record_count);
+    log_put_u32(header + 12, g_writer.block_count);
+    ok = ok && storage_file_seek(g_writer.file, 0, true);
+    ok = ok && (storage_file_write(g_writer.file, header, sizeof(header)) == sizeof(header));
+
+    // Logical end: the footer is located from the file size
+    if(g_writer.reserved) {
+        ok = ok && storage_file_seek(g_writer.file, g_writer.offset, true) &&
+             storage_file_truncate(g_writer.file);
+    }
+
+    storage_file_close(g_writer.file);
+    storage_file_free(g_writer.file);
+    g_writer.file = NULL;
+    return ok;
+}
+
+// ==== ROTATION ====
+// Records older than ARCHIVE_KEEP_SECONDS move into a new segment, everything
+// else is copied to log.tmp, then both are published by log_swap_in().
+// Tombstoned records are dropped on the way, then their deletes are compacted
+// (see log_store.h), and patches for the records in log.jsonl are folded in
+// (see log_patch.h).
+
+static bool rotate_write(Stream* out, const char* line, size_t len) {
+    return (stream_write(out, (const uint8_t*)line, len) == len) &&
+           (stream_write(out, (const uint8_t*)"\n", 1) == 1);
+}
+
+// line is the original text, NULL for records rewritten from patches
+static uint32_t g_rotate_dropped;
+
+static bool rotate_emit(Stream* out, uint32_t cutoff, const LogRecord* rec, const char* line) {
+    if(log_tombstone_drop(rec->id)) {
+        g_rotate_dropped++;
+        return true;
+    }
+    if(rec->ts > 0 && rec->ts < cutoff && !writer_full()) return writer_add(rec);
+    if(line) return rotate_write(out, line, strlen(line));
+
+    ScratchMark mark = scratch_mark();
+    char* buf = scratch_alloc(LOG_LINE_MAX);
+    int len = log_format_record(rec, buf, LOG_LINE_MAX);
+    bool ok = len > 0 && stream_write(out, (const uint8_t*)buf, len) == (size_t)len;
+    scratch_release(mark);
+    return ok;
+}
+
+static bool rotate_run(uint32_t log_size) {
+    debug_log("log_archive_rotate: start");
+
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    if(!log_reader_open(&reader, LOG_PATH)) return false;
+    g_rotate_dropped = 0;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* out = buffered_file_stream_alloc(storage);
+    bool ok = writer_open(storage, log_size) &&
+              buffered_file_stream_open(out, LOG_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    uint32_t cutoff = clock_now() - ARCHIVE_KEEP_SECONDS;
+    uint32_t folded = 0;
+    uint8_t inject = 0;
+    bool first = true;
+    const char* line;
+    const LogRecord* injected;
+    LogRecord rec;
+    LogRecord scratch;
+    while(ok && (line = log_reader_next(&reader)) != NULL) {
+        if(!log_parse_record(line, &rec)) {
+            ok = rotate_write(out, line, strlen(line));
+            continue;
+        }
+
+        // Added/moved records older than log.jsonl stay in the overlay
+        while(first && (injected = log_patch_injected(inject)) != NULL && injected->ts < rec.ts) {
+            inject++;
+        }
+        first = false;
+        while(ok && (injected = log_patch_injected(inject)) != NULL && injected->ts < rec.ts) {
+            inject++;
+            log_patch_mark_emitted(injected->id);
+            ok = rotate_emit(out, cutoff, injected, NULL);
+            folded++;
+        }
+
+        const LogRecord* patched = log_patch_apply(&rec, &scratch);
+        if(patched != &rec) {
+            log_patch_mark_seen(rec.id);
+            folded++;
+        }
+        if(patched) ok = ok && rotate_emit(out, cutoff, patched, (patched == &rec) ? line : NULL);
+    }
+    log_reader_close(&reader);
+    while(ok && !first && (injected = log_patch_injected(inject++)) != NULL) {
+        log_patch_mark_emitted(injected->id);
+        ok = rotate_emit(out, cutoff, injected, NULL);
+        folded++;
+    }
+
+    uint32_t archived = g_writer.record_count;
+    if(g_writer.file) ok = writer_finish() && ok;
+    buffered_file_stream_close(out);
+    stream_free(out);
+    if(archived == 0) storage_common_remove(storage, ARCHIVE_PENDING_PATH);
+    if(ok && folded > 0) ok = log_patches_write_unfolded();
+
+    if(!ok || (archived == 0 && folded == 0 && g_rotate_dropped == 0)) {
+        storage_common_remove(storage, LOG_TMP_PATH);
+        storage_common_remove(storage, PATCHES_TMP_PATH);
+        log_archive_abort(storage);
+        furi_record_close(RECORD_STORAGE);
+        debug_log("log_archive_rotate: nothing archived");
+        return false;
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    ok = log_swap_in();
+    if(ok && folded > 0) log_patches_commit();
+    if(ok && g_rotate_dropped > 0) log_tombstones_compact();
+    debug_log(ok ? "log_archive_rotate: done" : "log_archive_rotate: swap failed");
+    return ok;
+}
+
+bool log_archive_rotate(void) {
+    log_append_flush();
+    log_tombstones_load();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FileInfo info;
+    bool due = (storage_common_stat(storage, LOG_PATH, &info) == FSE_OK) &&
+               (info.size >= ARCHIVE_ROTATE_SIZE || log_patch_count() >= PATCH_FOLD_AT ||
+                log_tombstone_count() >= TOMBSTONE_FOLD_AT || log_tombstones_full());
+    furi_record_close(RECORD_STORAGE);
+    if(!due) return false;
+
+    log_tables_save(); // Rotation rewrites the log under them
+    diag_begin(DiagOpRotate);
+    bool ok = rotate_run((uint32_t)info.size);
+    diag_end(DiagOpRotate);
+    return ok;
+}
+
+// ==== SEGMENT READER ====
+
+bool log_archive_open(ArchiveReader* reader, const char* path) {
+    memset(reader, 0, sizeof(ArchiveReader));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    reader->file = storage_file_alloc(storage);
+    if(!storage_file_open(reader->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        log_archive_close(reader);
+        return false;
+    }
+    reader->size = (uint32_t)storage_file_size(reader->file);
+
+    uint8_t header[LOG_ARCHIVE_HEADER_SIZE];
+    uint8_t footer[LOG_ARCHIVE_FOOTER_SIZE];
+    bool ok = reader->size >= LOG_ARCHIVE_HEADER_SIZE + LOG_ARCHIVE_FOOTER_SIZE &&
+              storage_file_read(reader->file, header, sizeof(header)) == sizeof(header) &&
+              memcmp(header, LOG_ARCHIVE_MAGIC, 4) == 0 &&
+              storage_file_seek(reader->file, reader->size - LOG_ARCHIVE_FOOTER_SIZE, true) &&
+              storage_file_read(reader->file, footer, sizeof(footer)) == sizeof(footer) &&
+              memcmp(footer + 4, LOG_ARCHIVE_FOOTER_MAGIC, 4) == 0;
+    if(!ok) {
+        debug_log("log_archive_open: bad segment");
+        log_archive_close(reader);
+        return false;
+    }
+
+    reader->block_count = log_get_u32(header + 12);
+    reader->data_end = log_get_u32(footer);
+    if(reader->data_end > reader->size) reader->data_end = reader->size;
+    reader->next_block_offset = LOG_ARCHIVE_HEADER_SIZE;
+    return true;
+}
+
+static bool load_block(ArchiveReader* reader, uint32_t offset) {
+    if(offset + LOG_BLOCK_HEADER_SIZE > reader->data_end) return false;
+    if(!storage_file_seek(reader->file, offset, true)) return false;
+    if(storage_file_read(reader->file, reader->block, LOG_BLOCK_HEADER_SIZE) != LOG_BLOCK_HEADER_SIZE) {
+        return false;
+    }
+
+    size_t payload_len = log_get_u16(reader->block);
+    size_t restart_count = reader->block[3];
+    size_t rest = payload_len + 2 * restart_count;
+    if(LOG_BLOCK_HEADER_SIZE + rest > LOG_BLOCK_MAX_SIZE) return false;
+    if(offset + LOG_BLOCK_HEADER_SIZE + rest > reader->data_end) return false;
+    if(storage_file_read(reader->file, reader->block + LOG_BLOCK_HEADER_SIZE, rest) != rest) {
+        return false;
+    }
+
+    reader->payload_len = payload_len;
+    reader->payload_pos = 0;
+    reader->block_records = reader->block[2];
+    reader->record_index = 0;
+    reader->base_ts = log_get_u32(reader->block + 4);
+    reader->prev_ts = reader->base_ts;
+    reader->next_block_offset = offset + LOG_BLOCK_HEADER_SIZE + rest;
+    return true;
+}
+
+// Decode the record at the cursor of the loaded block
+static bool decode_at_cursor(ArchiveReader* reader) {
+    uint32_t prev = (reader->record_index % LOG_BLOCK_RESTART_INTERVAL == 0) ? reader->base_ts :
+                                                                              reader->prev_ts;
+    size_t len = log_record_decode(
+        reader->block + LOG_BLOCK_HEADER_SIZE + reader->payload_pos,
+        reader->payload_len - reader->payload_pos,
+        prev,
+        &reader->record);
+    if(len == 0) return false;
+    reader->payload_pos += len;
+    reader->prev_ts = reader->record.ts;
+    reader->record_index++;
+    return true;
+}
+
+const LogRecord* log_archive_next(ArchiveReader* reader) {
+    if(!reader->file) return NULL;
+
+    while(reader->record_index >= reader->block_records) {
+        if(!load_block(reader, reader->next_block_offset)) return NULL;
+    }
+    if(!decode_at_cursor(reader)) {
+        debug_log("log_archive_next: corrupt block");
+        reader->block_records = 0;
+        reader->next_block_offset = reader->data_end;
+        return NULL;
+    }
+    return &reader->record;
+}
+
+bool log_archive_seek(ArchiveReader* reader, uint32_t ts) {
+    if(!reader->file || reader->block_count == 0) return false;
+
+    // Binary search the block index for the last block starting before ts -
+    // records equal to ts may end the block before one that starts with ts
+    uint32_t lo = 0;
+    uint32_t hi = reader->block_count - 1;
+    uint32_t block_offset = LOG_ARCHIVE_HEADER_SIZE;
+    uint8_t entry[LOG_ARCHIVE_INDEX_ENTRY_SIZE];
+    while(lo <= hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if(!storage_file_seek(reader->file, reader->data_end + mid * LOG_ARCHIVE_INDEX_ENTRY_SIZE, true) ||
+           storage_file_read(reader->file, entry, sizeof(entry)) != sizeof(entry)) {
+            return false;
+        }
+        if(log_get_u32(entry) < ts) {
+            block_offset = log_get_u32(entry + 4);
+            lo = mid + 1;
+        } else {
+            if(mid == 0) break;
+            hi = mid - 1;
+        }
+    }
+    if(!load_block(reader, block_offset)) return false;
+
+    // Binary search restart points, each decodable without its predecessors
+    const uint8_t* restarts = reader->block + LOG_BLOCK_HEADER_SIZE + reader->payload_len;
+    uint8_t restart_count = reader->block[3];
+    uint8_t best = 0;
+    uint8_t rlo = 1;
+    uint8_t rhi = restart_count;
+    while(rlo < rhi) {
+        uint8_t mid = rlo + (rhi - rlo) / 2;
+        LogRecord probe;
+        size_t pos = log_get_u16(restarts + mid * 2);
+        if(pos >= reader->payload_len ||
+           log_record_decode(reader->block + LOG_BLOCK_HEADER_SIZE + pos, reader->payload_len - pos,
+               reader->base_ts, &probe) == 0) {
+            return false;
+        }
+        if(probe.ts < ts) {
+            best = mid;
+            rlo = mid + 1;
+        } else {
+            rhi = mid;
+        }
+    }
+    reader->payload_pos = log_get_u16(restarts + best * 2);
+    reader->record_index = best * LOG_BLOCK_RESTART_INTERVAL;
+
+    // Linear scan to the first record >= ts, leaving the cursor in front of it
+    while(true) {
+        if(reader->record_index >= reader->block_records) {
+            if(!load_block(reader, reader->next_block_offset)) return false;
+            continue;
+        }
+        size_t pos = reader->payload_pos;
+        uint8_t index = reader->record_index;
+        uint32_t prev = reader->prev_ts;
+        if(!decode_at_cursor(reader)) return false;
+        if(reader->record.ts >= ts) {
+            reader->payload_pos = pos;
+            reader->record_index = index;
+            reader->prev_ts = prev;
+            return true;
+        }
+    }
+}
+
+uint32_t log_archive_consumed(ArchiveReader* reader) {
+    return reader->next_block_offset;
+}
+
+void log_archive_close(ArchiveReader* reader) {
+    if(!reader->file) return;
+    storage_file_close(reader->file);
+    storage_file_free(reader->file);
+    reader->file = NULL;
+    furi_record_close(RECORD_STORAGE);
+}
+
+// ==== HISTORY READER ====
+
+static void history_open_segment(LogHistory* history) {
+    char path[64];
+    while(history->segment > 0) {
+        log_archive_segment_path(history->segment, path, sizeof(path));
+        if(log_archive_open(&history->archive, path)) return;
+        // Unreadable segment - skip it
+        history->segment = (history->segment < history->segment_count) ? history->segment + 1 : 0;
+    }
+    log_reader_open(&history->jsonl, LOG_PATH);
+}
+
+bool log_history_open(LogHistory* history) {
+    memset(history, 0, sizeof(LogHistory));
+    log_append_flush();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    history->segment_count = segment_count(storage);
+    char path[64];
+    FileInfo info;
+    for(uint32_t i = 1; i <= history->segment_count; i++) {
+        log_archive_segment_path(i, path, sizeof(path));
+        if(storage_common_stat(storage, path, &info) == FSE_OK) history->total_size += info.size;
+    }
+    if(storage_common_stat(storage, LOG_PATH, &info) == FSE_OK) history->total_size += info.size;
+    furi_record_close(RECORD_STORAGE);
+
+    history->segment = (history->segment_count > 0) ? 1 : 0;
+    history_open_segment(history);
+    return true;
+}
+
+static const LogRecord* history_stream_next(LogHistory* history) {
+    while(history->segment > 0) {
+        const LogRecord* rec = log_archive_next(&history->archive);
+        if(rec) return rec;
+
+        history->done_size += history->archive.size;
+        log_archive_close(&history->archive);
+        history->segment = (history->segment < history->segment_count) ? history->segment + 1 : 0;
+        history_open_segment(history);
+    }
+
+    const char* line;
+    while((line = log_reader_next(&history->jsonl)) != NULL) {
+        if(log_parse_record(line, &history->record)) return &history->record;
+    }
+    return NULL;
+}
+
+// Stream and overlay merged in time order
+static const LogRecord* history_merged_next(LogHistory* history) {
+    while(!history->head_valid) {
+        const LogRecord* rec = history_stream_next(history);
+        if(!rec) {
+            history->head = NULL;
+            history->head_valid = true;
+        } else {
+            history->head = log_patch_apply(rec, &history->patched);
+            history->head_valid = (history->head != NULL); // Moved - comes from the overlay
+        }
+    }
+
+    const LogRecord* injected = log_patch_injected(history->inject);
+    if(injected && (!history->head || injected->ts < history->head->ts)) {
+        history->inject++;
+        return injected;
+    }
+    history->head_valid = false;
+    return history->head;
+}
+
+const LogRecord* log_history_next(LogHistory* history) {
+    const LogRecord* rec;
+    while((rec = history_merged_next(history)) != NULL && rec->ts < history->since) {
+    }
+    return rec;
+}
+
+// Whole segments before ts are skipped by their block index, and the first
+// one reaching it is positioned by log_archive_seek()
+void log_history_seek(LogHistory* history, uint32_t ts) {
+    history->since = ts;
+    while(history->segment > 0) {
+        if(log_archive_seek(&history->archive, ts)) return;
+        history->done_size += history->archive.size;
+        log_archive_close(&history->archive);
+        history->segment = (history->segment < history->segment_count) ? history->segment + 1 : 0;
+        history_open_segment(history);
+    }
+}
+
+uint8_t log_history_percent(LogHistory* history) {
+    if(history->total_size == 0) return 100;
+    size_t done = history->done_size;
+    if(history->segment > 0) {
+        done += log_archive_consumed(&history->archive);
+    } else {
+        done += log_reader_consumed(&history->jsonl);
+    }
+    if(done > history->total_size) done = history->total_size;
+    return (uint8_t)((uint64_t)done * 100 / history->total_size);
+}
+
+void log_history_close(LogHistory* history) {
+    log_archive_close(&history->archive);
+    log_reader_close(&history->jsonl);
+}
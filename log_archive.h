@@ -0,0 +1,73 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+#include "log_codec.h"
+#include "log_reader.h"
+#include <storage/storage.h>
+
+// ==== ARCHIVE SEGMENTS ====
+// Old history is moved out of log.jsonl into closed, compact segments
+// (see LOG_ARCHIVE_* in log_codec.h for the encoding). Segments are numbered
+// seg_0001.bin upward; a new one is built as pending.bin and published when
+// the trimmed log.jsonl is swapped in.
+
+#define ARCHIVE_DIR (child_paths()->archive_dir)
+#define ARCHIVE_PENDING_PATH (child_paths()->archive_pending)
+#define ARCHIVE_RESET_PATH (child_paths()->archive_reset) // Drop all segments on commit
+#define ARCHIVE_MAX_SEGMENTS 999
+#define ARCHIVE_MAX_BLOCKS 64 // Per segment, bounds the in-RAM block index
+#define ARCHIVE_ROTATE_SIZE (32 * 1024) // Rotate once log.jsonl grows past this
+#define ARCHIVE_KEEP_SECONDS (14 * 86400) // Recent history that stays in log.jsonl
+
+void log_archive_segment_path(uint32_t index, char* out, size_t out_size); // index starts at 1
+uint32_t log_archive_segment_count(void);
+bool log_archive_rotate(void);
+void log_archive_commit(Storage* storage);
+void log_archive_abort(Storage* storage);
+void log_archive_clear(Storage* storage);
+
+// Streaming segment decoder
+typedef struct {
+    File* file;
+    uint32_t size;
+    uint32_t data_end; // Offset of the block index
+    uint32_t block_count;
+    uint32_t next_block_offset;
+    uint8_t block[LOG_BLOCK_MAX_SIZE];
+    size_t payload_len;
+    size_t payload_pos;
+    uint8_t block_records;
+    uint8_t record_index;
+    uint32_t base_ts;
+    uint32_t prev_ts;
+    LogRecord record;
+} ArchiveReader;
+
+bool log_archive_open(ArchiveReader* reader, const char* path);
+const LogRecord* log_archive_next(ArchiveReader* reader); // NULL at end or on corruption
+bool log_archive_seek(ArchiveReader* reader, uint32_t ts); // Position at first record with ts >= given
+uint32_t log_archive_consumed(ArchiveReader* reader);
+void log_archive_close(ArchiveReader* reader);
+
+// Whole history: archive segments oldest first, then log.jsonl, with the
+// patch overlay applied
+typedef struct {
+    ArchiveReader archive;
+    LogReader jsonl;
+    uint32_t segment; // Segment being read, 0 once on log.jsonl
+    uint32_t segment_count;
+    size_t total_size;
+    size_t done_size; // Size of fully read files
+    LogRecord record;
+    LogRecord patched; // Stream record with a duration patch applied
+    const LogRecord* head; // Next stream record, held while patches go first
+    bool head_valid;
+    uint8_t inject; // Next added/moved record from the patch overlay
+    uint32_t since; // Records before this are skipped, see log_history_seek()
+} LogHistory;
+
+bool log_history_open(LogHistory* history);
+void log_history_seek(LogHistory* history, uint32_t ts); // Right after open: start at the first record >= ts
+const LogRecord* log_history_next(LogHistory* history);
+uint8_t log_history_percent(LogHistory* history);
+void log_history_close(LogHistory* history);
@@ -0,0 +1,247 @@
+#include "log_check.h"
+#include "log_store.h"
+#include "log_codec.h"
+#include "log_reader.h"
+#include "log_append.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CHECK_LINES_PER_STEP 64
+#define CHECK_SAVE_EVERY 16 // Steps between check.state updates
+
+static void quarantine_write(Storage* storage, const char* data, size_t len) {
+    Stream* stream = buffered_file_stream_alloc(storage);
+    if(buffered_file_stream_open(stream, QUARANTINE_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        stream_write(stream, (const uint8_t*)data, len);
+        if(len > 0 && data[len - 1] != '\n') stream_write(stream, (const uint8_t*)"\n", 1);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+}
+
+// ==== TAIL CHECK ====
+
+static char* g_tail; // Scratch, only during log_check_tail()
+
+static bool line_ok(char* line, size_t len) {
+    if(len > 0 && line[len - 1] == '\r') len--;
+    if(len == 0) return true; // Blank line
+    if(memchr(line, '\0', len)) return false; // Unwritten sectors read back as zeros
+
+    char saved = line[len];
+    line[len] = '\0';
+    bool ok = log_line_check(line);
+    line[len] = saved;
+    return ok;
+}
+
+// Length of the tail block to keep; *terminate is set when the last line
+// is a good record that only lost its newline
+static size_t tail_keep(size_t len, bool from_file_start, bool* terminate) {
+    size_t end = len;
+    *terminate = false;
+    while(end > 0) {
+        bool terminated = (g_tail[end - 1] == '\n');
+        size_t content_end = terminated ? end - 1 : end;
+        size_t start = content_end;
+        while(start > 0 && g_tail[start - 1] != '\n') start--;
+        if(start == 0 && !from_file_start) return end; // Line begins before the block
+
+        if(line_ok(g_tail + start, content_end - start)) {
+            *terminate = !terminated && content_end > start;
+            return end;
+        }
+        end = start;
+    }
+    return 0;
+}
+
+static uint32_t check_tail(Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    uint32_t cut = 0;
+    if(storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        uint32_t size = (uint32_t)storage_file_size(file);
+        uint32_t start = (size > LOG_CHECK_TAIL) ? size - LOG_CHECK_TAIL : 0;
+        size_t len = size - start;
+        if(len > 0 && storage_file_seek(file, start, true) &&
+           storage_file_read(file, g_tail, len) == len) {
+            bool terminate;
+            size_t keep = tail_keep(len, start == 0, &terminate);
+            if(keep < len) {
+                quarantine_write(storage, g_tail + keep, len - keep);
+                if(storage_file_seek(file, start + keep, true) && storage_file_truncate(file)) {
+                    cut = len - keep;
+                }
+            }
+            if(terminate && storage_file_seek(file, start + keep, true)) {
+                storage_file_write(file, "\n", 1);
+            }
+        }
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    return cut;
+}
+
+uint32_t log_check_tail(void) {
+    ScratchMark mark = scratch_mark();
+    g_tail = scratch_alloc(LOG_CHECK_TAIL + 1);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    uint32_t cut = check_tail(storage, LOG_PATH);
+    cut += check_tail(storage, DELETED_PATH);
+    cut += check_tail(storage, PATCHES_PATH);
+    furi_record_close(RECORD_STORAGE);
+    scratch_release(mark);
+    g_tail = NULL;
+
+    if(cut > 0) debug_log("log_check_tail: torn tail cut");
+    return cut;
+}
+
+// ==== FULL SCAN ====
+
+static struct {
+    LogReader reader;
+    Stream* quarantine;
+    uint16_t steps;
+    bool cancel;
+} g_check;
+
+// check.state: "<offset> <good> <bad>"
+static bool state_load(uint32_t* offset, uint32_t* good, uint32_t* bad) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    char buf[40] = {0};
+    bool ok = false;
+    if(buffered_file_stream_open(stream, CHECK_STATE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t len = stream_read(stream, (uint8_t*)buf, sizeof(buf) - 1);
+        buf[len] = '\0';
+        char* pos = buf;
+        *offset = strtoul(pos, &pos, 10);
+        *good = strtoul(pos, &pos, 10);
+        *bad = strtoul(pos, &pos, 10);
+        ok = (len > 0);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+static void state_save(AppData* app) {
+    char buf[40];
+    int len = snprintf(buf, sizeof(buf), "%lu %lu %lu\n",
+        (unsigned long)log_reader_consumed(&g_check.reader),
+        (unsigned long)app->check_good, (unsigned long)app->check_bad);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    if(buffered_file_stream_open(stream, CHECK_STATE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        stream_write(stream, (uint8_t*)buf, len);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+}
+
+bool log_check_resumable(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool exists = storage_common_exists(storage, CHECK_STATE_PATH);
+    furi_record_close(RECORD_STORAGE);
+    return exists;
+}
+
+static void check_finish(AppData* app, JobStatus status) {
+    if(status == JobDone) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        storage_common_remove(storage, CHECK_STATE_PATH);
+        furi_record_close(RECORD_STORAGE);
+        app->check_percent = 100;
+    } else if(g_check.reader.stream) {
+        state_save(app); // Resume from here next time
+    }
+    app->check_resumable = (status != JobDone) && log_check_resumable();
+    log_reader_close(&g_check.reader);
+    if(g_check.quarantine) {
+        buffered_file_stream_close(g_check.quarantine);
+        stream_free(g_check.quarantine);
+        g_check.quarantine = NULL;
+    }
+    app->check_status = status;
+    debug_log("log_check: finished");
+}
+
+bool log_check_start(AppData* app) {
+    debug_log("log_check_start: start");
+
+    memset(&g_check, 0, sizeof(g_check));
+    app->check_good = 0;
+    app->check_bad = 0;
+    app->check_percent = 0;
+    app->check_status = JobRunning;
+
+    log_append_flush();
+    if(!log_reader_open(&g_check.reader, LOG_PATH)) {
+        check_finish(app, JobDone); // No log, nothing to check
+        return false;
+    }
+
+    uint32_t offset;
+    uint32_t good;
+    uint32_t bad;
+    if(state_load(&offset, &good, &bad) && log_reader_seek(&g_check.reader, offset)) {
+        app->check_good = good;
+        app->check_bad = bad;
+        debug_log("log_check_start: resumed");
+    }
+    return true;
+}
+
+bool log_check_step(AppData* app) {
+    if(app->check_status != JobRunning) return false;
+
+    if(g_check.cancel) {
+        check_finish(app, JobCancelled);
+        return false;
+    }
+
+    for(int i = 0; i < CHECK_LINES_PER_STEP; i++) {
+        const char* line = log_reader_next(&g_check.reader);
+        if(!line) {
+            check_finish(app, JobDone);
+            return false;
+        }
+        if(log_line_check(line)) {
+            app->check_good++;
+            continue;
+        }
+
+        app->check_bad++;
+        if(!g_check.quarantine) {
+            Storage* storage = furi_record_open(RECORD_STORAGE);
+            g_check.quarantine = buffered_file_stream_alloc(storage);
+            furi_record_close(RECORD_STORAGE);
+            if(!buffered_file_stream_open(
+                   g_check.quarantine, QUARANTINE_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+                check_finish(app, JobFailed);
+                return false;
+            }
+        }
+        size_t len = strlen(line);
+        stream_write(g_check.quarantine, (const uint8_t*)line, len);
+        stream_write(g_check.quarantine, (const uint8_t*)"\n", 1);
+    }
+
+    if(++g_check.steps % CHECK_SAVE_EVERY == 0) state_save(app);
+    app->check_percent = log_reader_percent(&g_check.reader);
+    return true;
+}
+
+void log_check_cancel(void) {
+    g_check.cancel = true;
+}
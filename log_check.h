@@ -0,0 +1,23 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+
+// ==== LOG CHECK ====
+// Power loss mid-append can leave a torn last line in the append-only files
+// (log.jsonl, deleted.jsonl, patches.jsonl), and the next append would be
+// glued onto it. At startup log_check_tail() reads only the last
+// LOG_CHECK_TAIL bytes of each: trailing lines that fail framing or checksum
+// are cut off and moved to quarantine.jsonl.
+// The full scan (Menu > Check log) verifies every line of log.jsonl in steps
+// and copies damaged ones to quarantine.jsonl; readers already skip them.
+// Its position is kept in check.state, so an interrupted scan resumes.
+
+#define QUARANTINE_PATH (child_paths()->quarantine)
+#define CHECK_STATE_PATH (child_paths()->check_state)
+#define LOG_CHECK_TAIL 512
+
+uint32_t log_check_tail(void); // Bytes cut off, all files
+bool log_check_resumable(void);
+bool log_check_start(AppData* app);
+bool log_check_step(AppData* app); // Process one chunk, returns true while work remains
+void log_check_cancel(void);
@@ -0,0 +1,359 @@
+#include "log_codec.h"
+#include <datetime/datetime.h>
+#include <string.h>
+#include <stdio.h>
+
+const char* log_type_name(LogEventType type) {
+    switch(type) {
+        case LogEventDiaper: return "diaper";
+        case LogEventFeedingStart: return "feeding_start";
+        case LogEventFeedingStop: return "feeding_stop";
+        case LogEventSleepStart: return "sleep_start";
+        case LogEventSleepStop: return "sleep_stop";
+    }
+    return "unknown";
+}
+
+// Parse event type from line
+LogEventType log_parse_type(const char* line) {
+    if(strstr(line, "\"type\":\"diaper\"")) return LogEventDiaper;
+    if(strstr(line, "\"type\":\"feeding_start\"")) return LogEventFeedingStart;
+    if(strstr(line, "\"type\":\"feeding_stop\"")) return LogEventFeedingStop;
+    if(strstr(line, "\"type\":\"sleep_start\"")) return LogEventSleepStart;
+    if(strstr(line, "\"type\":\"sleep_stop\"")) return LogEventSleepStop;
+    return LogEventDiaper; // Default
+}
+
+// Extract ID from line into buffer (max 32 chars)
+bool log_parse_id(const char* line, char* id_out) {
+    const char* id_pos = strstr(line, "\"id\":\"");
+    if(!id_pos) {
+        id_out[0] = '\0';
+        return false;
+    }
+    id_pos += 6;
+    int i = 0;
+    while(*id_pos != '"' && *id_pos != '\0' && i < LOG_ID_LEN) {
+        id_out[i++] = *id_pos++;
+    }
+    id_out[i] = '\0';
+    return (i > 0);
+}
+
+// Extract duration from line
+uint32_t log_parse_duration(const char* line) {
+    const char* dur_pos = strstr(line, "\"dur\":");
+    if(!dur_pos) {
+        dur_pos = strstr(line, "\"duration\":");
+        if(!dur_pos) return 0;
+        dur_pos += 11;
+    } else {
+        dur_pos += 6;
+    }
+    uint32_t dur = 0;
+    while(*dur_pos >= '0' && *dur_pos <= '9') {
+        dur = dur * 10 + (*dur_pos - '0');
+        dur_pos++;
+    }
+    return dur;
+}
+
+// FNV-1a hash of an ID string
+uint32_t log_hash_id(const char* id) {
+    uint32_t hash = 2166136261u;
+    while(*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Read exactly `digits` decimal digits, returns false on any non-digit
+static bool parse_fixed(const char* str, int digits, uint32_t* out) {
+    uint32_t val = 0;
+    for(int i = 0; i < digits; i++) {
+        if(str[i] < '0' || str[i] > '9') return false;
+        val = val * 10 + (str[i] - '0');
+    }
+    *out = val;
+    return true;
+}
+
+// Parse "ts":"YYYY-MM-DDTHH:MM:SS" into epoch seconds
+uint32_t log_parse_ts(const char* line) {
+    const char* ts_pos = strstr(line, "\"ts\":\"");
+    if(!ts_pos) return 0;
+    ts_pos += 6;
+
+    uint32_t year, month, day, hour, minute, second;
+    if(!parse_fixed(ts_pos, 4, &year) || ts_pos[4] != '-') return 0;
+    if(!parse_fixed(ts_pos + 5, 2, &month) || ts_pos[7] != '-') return 0;
+    if(!parse_fixed(ts_pos + 8, 2, &day) || ts_pos[10] != 'T') return 0;
+    if(!parse_fixed(ts_pos + 11, 2, &hour) || ts_pos[13] != ':') return 0;
+    if(!parse_fixed(ts_pos + 14, 2, &minute) || ts_pos[16] != ':') return 0;
+    if(!parse_fixed(ts_pos + 17, 2, &second)) return 0;
+    if(year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    if(hour > 23 || minute > 59 || second > 59) return 0;
+
+    DateTime datetime = {
+        .year = year,
+        .month = month,
+        .day = day,
+        .hour = hour,
+        .minute = minute,
+        .second = second,
+    };
+    return datetime_datetime_to_timestamp(&datetime);
+}
+
+// Format epoch seconds as "YYYY-MM-DDTHH:MM:SS"
+void log_format_ts(uint32_t ts, char* out, size_t out_size) {
+    DateTime datetime;
+    datetime_timestamp_to_datetime(ts, &datetime);
+    snprintf(out, out_size, "%04u-%02u-%02uT%02u:%02u:%02u",
+        datetime.year, datetime.month, datetime.day,
+        datetime.hour, datetime.minute, datetime.second);
+}
+
+// Format the 16 hex char ID used for new events
+void log_format_id(uint32_t seed, char* id_out) {
+    snprintf(id_out, LOG_ID_LEN + 1, "%08lx%08lx",
+        (unsigned long)seed, (unsigned long)(seed * 1103515245 + 12345));
+}
+
+bool log_parse_record(const char* line, LogRecord* rec) {
+    if(!log_line_check(line)) return false;
+    if(!log_parse_id(line, rec->id)) return false;
+    rec->ts = log_parse_ts(line);
+    rec->type = log_parse_type(line);
+    rec->duration = log_parse_duration(line);
+    return true;
+}
+
+// "{" + tags + record fields, left open for log_line_seal()
+static int format_body(const char* tags, const LogRecord* rec, char* out, size_t out_size) {
+    char time_str[LOG_TS_STR_LEN];
+    log_format_ts(rec->ts, time_str, sizeof(time_str));
+
+    int len = snprintf(out, out_size, "{%s\"ts\":\"%s\",\"type\":\"%s\",\"id\":\"%s\"",
+        tags, time_str, log_type_name(rec->type), rec->id);
+    if(len <= 0 || len >= (int)out_size) return 0;
+    if(rec->duration > 0) {
+        int more = snprintf(out + len, out_size - len, ",\"dur\":%lu", (unsigned long)rec->duration);
+        if(more <= 0 || more >= (int)(out_size - len)) return 0;
+        len += more;
+    }
+    return len;
+}
+
+int log_format_record(const LogRecord* rec, char* out, size_t out_size) {
+    return log_format_record_tagged("", rec, out, out_size);
+}
+
+int log_format_record_tagged(const char* tags, const LogRecord* rec, char* out, size_t out_size) {
+    int len = format_body(tags, rec, out, out_size);
+    return (len > 0) ? log_line_seal(out, len, out_size) : 0;
+}
+
+JournalOp log_parse_op(const char* line) {
+    return strstr(line, "\"op\":\"undel\"") ? JournalOpRestore : JournalOpDelete;
+}
+
+int log_format_journal(JournalOp op, const LogRecord* rec, char* out, size_t out_size) {
+    if(op == JournalOpRestore) {
+        int len = snprintf(out, out_size, "{\"op\":\"undel\",\"id\":\"%s\"", rec->id);
+        if(len <= 0 || len >= (int)out_size) return 0;
+        return log_line_seal(out, len, out_size);
+    }
+
+    // Delete carries the whole record so undo can put it back without a log scan
+    return log_format_record_tagged("\"op\":\"del\",", rec, out, out_size);
+}
+
+// ==== LINE CHECKSUMS ====
+
+#define LOG_CRC_TAG ",\"crc\":\""
+#define LOG_CRC_TAG_LEN 8
+
+// CRC-32 (IEEE), a nibble at a time - 64 bytes of table instead of 1 KB
+static const uint32_t crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t log_crc32(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* bytes = data;
+    crc = ~crc;
+    while(len--) {
+        crc ^= *bytes++;
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+int log_line_seal(char* out, size_t len, size_t out_size) {
+    uint32_t crc = log_crc32(0, out, len);
+    int more = snprintf(out + len, out_size - len, LOG_CRC_TAG "%08lx\"}\n", (unsigned long)crc);
+    if(more <= 0 || more >= (int)(out_size - len)) return 0;
+    return len + more;
+}
+
+bool log_line_check(const char* line) {
+    size_t len = strlen(line);
+    if(len < 2 || line[0] != '{' || line[len - 1] != '}') return false;
+
+    const char* tag = strstr(line, LOG_CRC_TAG);
+    if(!tag) return true; // Written before checksums
+
+    const char* hex = tag + LOG_CRC_TAG_LEN;
+    uint32_t stored = 0;
+    for(int i = 0; i < 8; i++) {
+        char c = hex[i];
+        uint32_t digit;
+        if(c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        stored = (stored << 4) | digit;
+    }
+    return hex[8] == '"' && stored == log_crc32(0, line, tag - line);
+}
+
+// ==== ARCHIVE ENCODING ====
+
+#define ID_KIND_FROM_TS 0 // Generated ID, seed == ts
+#define ID_KIND_SEED_DELTA 1 // Generated ID, seed stored relative to ts
+#define ID_KIND_RAW 2 // Anything else, stored verbatim
+
+static uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+size_t log_varint_put(uint8_t* out, uint32_t value) {
+    size_t len = 0;
+    while(value >= 0x80) {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+size_t log_varint_get(const uint8_t* in, size_t avail, uint32_t* value) {
+    uint32_t result = 0;
+    for(size_t i = 0; i < avail && i < 5; i++) {
+        result |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+        if(!(in[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Recover the seed of an ID produced by log_format_id, false for other IDs
+bool log_id_seed(const char* id, uint32_t* seed) {
+    if(strlen(id) != 16) return false;
+    uint32_t words[2] = {0, 0};
+    for(int i = 0; i < 16; i++) {
+        char c = id[i];
+        uint32_t nibble;
+        if(c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        words[i / 8] = (words[i / 8] << 4) | nibble;
+    }
+    if(words[1] != words[0] * 1103515245 + 12345) return false;
+    *seed = words[0];
+    return true;
+}
+
+size_t log_record_encode(const LogRecord* rec, uint32_t prev_ts, uint8_t* out) {
+    size_t len = log_varint_put(out, zigzag_encode((int32_t)(rec->ts - prev_ts)));
+
+    uint32_t seed;
+    uint32_t id_kind = ID_KIND_RAW;
+    if(log_id_seed(rec->id, &seed)) {
+        id_kind = (seed == rec->ts) ? ID_KIND_FROM_TS : ID_KIND_SEED_DELTA;
+    }
+
+    // Durations are capped to fit the 27 bits left next to kind and type
+    uint32_t duration = (rec->duration > 0x7FFFFFF) ? 0x7FFFFFF : rec->duration;
+    len += log_varint_put(out + len, (duration << 5) | (id_kind << 3) | ((uint32_t)rec->type & 0x7));
+
+    if(id_kind == ID_KIND_SEED_DELTA) {
+        len += log_varint_put(out + len, zigzag_encode((int32_t)(seed - rec->ts)));
+    } else if(id_kind == ID_KIND_RAW) {
+        size_t id_len = strlen(rec->id);
+        out[len++] = (uint8_t)id_len;
+        memcpy(out + len, rec->id, id_len);
+        len += id_len;
+    }
+    return len;
+}
+
+size_t log_record_decode(const uint8_t* in, size_t avail, uint32_t prev_ts, LogRecord* rec) {
+    uint32_t value;
+    size_t len = log_varint_get(in, avail, &value);
+    if(len == 0) return 0;
+    rec->ts = prev_ts + (uint32_t)zigzag_decode(value);
+
+    size_t n = log_varint_get(in + len, avail - len, &value);
+    if(n == 0) return 0;
+    len += n;
+    rec->type = (LogEventType)(value & 0x7);
+    rec->duration = value >> 5;
+    uint32_t id_kind = (value >> 3) & 0x3;
+    if(rec->type > LogEventSleepStop) return 0;
+
+    if(id_kind == ID_KIND_FROM_TS) {
+        log_format_id(rec->ts, rec->id);
+    } else if(id_kind == ID_KIND_SEED_DELTA) {
+        n = log_varint_get(in + len, avail - len, &value);
+        if(n == 0) return 0;
+        len += n;
+        log_format_id(rec->ts + (uint32_t)zigzag_decode(value), rec->id);
+    } else if(id_kind == ID_KIND_RAW) {
+        if(len >= avail) return 0;
+        size_t id_len = in[len++];
+        if(id_len > LOG_ID_LEN || len + id_len > avail) return 0;
+        memcpy(rec->id, in + len, id_len);
+        rec->id[id_len] = '\0';
+        len += id_len;
+    } else {
+        return 0;
+    }
+    return len;
+}
+
+uint16_t log_get_u16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+uint32_t log_get_u32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+void log_put_u16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+void log_put_u32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "app_state.h"
+#include <stddef.h>
+
+// Record encoding/decoding for log.jsonl lines and archive segments
+// (shared by store, export, import, archive)
+
+#define LOG_ID_LEN 32
+#define LOG_TS_STR_LEN 20 // "YYYY-MM-DDTHH:MM:SS" + NUL
+#define LOG_LINE_MAX 128
+
+// One decoded log event
+typedef struct {
+    uint32_t ts;
+    uint32_t duration;
+    LogEventType type;
+    char id[LOG_ID_LEN + 1];
+} LogRecord;
+
+const char* log_type_name(LogEventType type);
+LogEventType log_parse_type(const char* line);
+bool log_parse_id(const char* line, char* id_out); // id_out must hold LOG_ID_LEN + 1
+uint32_t log_parse_duration(const char* line);
+uint32_t log_hash_id(const char* id);
+uint32_t log_parse_ts(const char* line); // Epoch seconds, 0 if missing/invalid
+void log_format_ts(uint32_t ts, char* out, size_t out_size);
+void log_format_id(uint32_t seed, char* id_out); // id_out must hold LOG_ID_LEN + 1
+bool log_id_seed(const char* id, uint32_t* seed); // Inverse of log_format_id, false for other IDs
+
+bool log_parse_record(const char* line, LogRecord* rec); // False for non-record and damaged lines
+int log_format_record(const LogRecord* rec, char* out, size_t out_size); // JSONL line incl. newline
+// Same, with extra "key":"value", pairs in front of the record fields
+int log_format_record_tagged(const char* tags, const LogRecord* rec, char* out, size_t out_size);
+
+// Every written line ends in ,"crc":"xxxxxxxx"} - the CRC-32 of the text in
+// front of that comma. Lines from older versions have none and are only
+// checked for framing.
+uint32_t log_crc32(uint32_t crc, const void* data, size_t len);
+int log_line_seal(char* out, size_t len, size_t out_size); // Close an open "{..." line, returns full length
+bool log_line_check(const char* line); // Framing and checksum of a line without its newline
+
+// deleted.jsonl journal lines: {"op":"del",<record fields>} / {"op":"undel","id":...}
+// A bare {"id":...} line (older versions) is a delete without record fields.
+JournalOp log_parse_op(const char* line);
+int log_format_journal(JournalOp op, const LogRecord* rec, char* out, size_t out_size);
+
+// ==== ARCHIVE ENCODING ====
+// Segment file:  header | block... | index | footer
+//   header  "BLA1" u16 version u16 reserved u32 record_count u32 block_count
+//   block   u16 payload_len u8 record_count u8 restart_count u32 base_ts
+//           payload | restart_count x u16 restart offsets into payload
+//   index   block_count x (u32 first_ts, u32 block_offset)
+//   footer  u32 index_offset "BLAX"
+// Record:   varint zigzag(ts - prev_ts)
+//           varint (duration << 5 | id_kind << 3 | type)
+//           id_kind 1: varint zigzag(seed - ts), id_kind 2: u8 len + raw id
+// Restart records encode their delta from the block base_ts instead of the
+// previous record, so decoding can start at any restart point.
+// All integers are little-endian.
+
+#define LOG_ARCHIVE_MAGIC "BLA1"
+#define LOG_ARCHIVE_FOOTER_MAGIC "BLAX"
+#define LOG_ARCHIVE_VERSION 1
+#define LOG_ARCHIVE_HEADER_SIZE 16
+#define LOG_ARCHIVE_FOOTER_SIZE 8
+#define LOG_ARCHIVE_INDEX_ENTRY_SIZE 8
+#define LOG_BLOCK_HEADER_SIZE 8
+#define LOG_BLOCK_MAX_RECORDS 64
+#define LOG_BLOCK_RESTART_INTERVAL 16
+#define LOG_BLOCK_PAYLOAD_TARGET 448 // Block is closed once payload reaches this
+#define LOG_RECORD_MAX_ENCODED (5 + 5 + 1 + LOG_ID_LEN)
+#define LOG_BLOCK_MAX_SIZE                                                        \
+    (LOG_BLOCK_HEADER_SIZE + LOG_BLOCK_PAYLOAD_TARGET + LOG_RECORD_MAX_ENCODED + \
+     2 * (LOG_BLOCK_MAX_RECORDS / LOG_BLOCK_RESTART_INTERVAL))
+
+size_t log_varint_put(uint8_t* out, uint32_t value);
+size_t log_varint_get(const uint8_t* in, size_t avail, uint32_t* value); // 0 if truncated
+size_t log_record_encode(const LogRecord* rec, uint32_t prev_ts, uint8_t* out);
+size_t log_record_decode(const uint8_t* in, size_t avail, uint32_t prev_ts, LogRecord* rec); // 0 if corrupt
+
+uint16_t log_get_u16(const uint8_t* in);
+uint32_t log_get_u32(const uint8_t* in);
+void log_put_u16(uint8_t* out, uint16_t value);
+void log_put_u32(uint8_t* out, uint32_t value);
@@ -0,0 +1,243 @@
+#include "log_export.h"
+#include "log_store.h"
+#include "log_codec.h"
+#include "log_archive.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+// ==== STREAMING EXPORT ====
+// The history (archive segments, then log.jsonl) is read in fixed-size chunks
+// and written out in fixed-size chunks, so RAM use does not depend on log
+// length. Deleted entries are filtered against the tombstone set as records
+// are read, and start/stop records are joined into one session row.
+
+#define EXPORT_LINES_PER_STEP 16
+#define EXPORT_OUT_CHUNK 256
+#define EXPORT_ROW_MAX 128
+
+typedef struct {
+    bool open; // Start seen, waiting for stop
+    uint32_t start_ts;
+} PendingSession;
+
+static struct {
+    LogHistory history;
+    Stream* out;
+    char out_buf[EXPORT_OUT_CHUNK];
+    size_t out_len;
+    ExportFormat format;
+    bool first_row;
+    PendingSession feeding;
+    PendingSession sleep;
+    volatile bool cancel;
+} g_export;
+
+static const char* export_path(ExportFormat format) {
+    return (format == ExportFormatJson) ? EXPORT_JSON_PATH : EXPORT_CSV_PATH;
+}
+
+static bool export_flush(void) {
+    if(g_export.out_len == 0) return true;
+    size_t written = stream_write(g_export.out, (uint8_t*)g_export.out_buf, g_export.out_len);
+    bool ok = (written == g_export.out_len);
+    g_export.out_len = 0;
+    return ok;
+}
+
+static bool export_write(const char* str, size_t len) {
+    if(g_export.out_len + len > EXPORT_OUT_CHUNK) {
+        if(!export_flush()) return false;
+    }
+    if(len > EXPORT_OUT_CHUNK) return false;
+    memcpy(g_export.out_buf + g_export.out_len, str, len);
+    g_export.out_len += len;
+    return true;
+}
+
+// Write one session row. end_ts == 0 means the session is still open.
+static bool export_row(AppData* app, const char* kind, uint32_t start_ts, uint32_t end_ts, uint32_t duration) {
+    char start_str[LOG_TS_STR_LEN];
+    char end_str[LOG_TS_STR_LEN];
+    log_format_ts(start_ts, start_str, sizeof(start_str));
+    if(end_ts > 0) {
+        log_format_ts(end_ts, end_str, sizeof(end_str));
+    }
+
+    ScratchMark mark = scratch_mark();
+    char* row = scratch_alloc(EXPORT_ROW_MAX);
+    int len;
+    if(g_export.format == ExportFormatJson) {
+        const char* sep = g_export.first_row ? "" : ",\n";
+        if(end_ts > 0) {
+            len = snprintf(row, EXPORT_ROW_MAX,
+                "%s{\"start\":\"%s\",\"end\":\"%s\",\"type\":\"%s\",\"dur\":%lu}",
+                sep, start_str, end_str, kind, (unsigned long)duration);
+        } else {
+            len = snprintf(row, EXPORT_ROW_MAX,
+                "%s{\"start\":\"%s\",\"end\":null,\"type\":\"%s\",\"dur\":null}",
+                sep, start_str, kind);
+        }
+    } else {
+        if(end_ts > 0) {
+            len = snprintf(row, EXPORT_ROW_MAX, "%s,%s,%s,%lu\n",
+                start_str, end_str, kind, (unsigned long)duration);
+        } else {
+            len = snprintf(row, EXPORT_ROW_MAX, "%s,,%s,\n", start_str, kind);
+        }
+    }
+    bool ok = len > 0 && len < EXPORT_ROW_MAX && export_write(row, len);
+    scratch_release(mark);
+    if(!ok) return false;
+
+    g_export.first_row = false;
+    app->export_rows++;
+    return true;
+}
+
+// Handle a start record: an unmatched earlier start is emitted as open
+static bool export_session_start(AppData* app, PendingSession* pending, const char* kind, uint32_t ts) {
+    bool ok = true;
+    if(pending->open) {
+        ok = export_row(app, kind, pending->start_ts, 0, 0);
+    }
+    pending->open = true;
+    pending->start_ts = ts;
+    return ok;
+}
+
+// Handle a stop record: join with the pending start, or derive start from duration
+static bool export_session_stop(AppData* app, PendingSession* pending, const char* kind, uint32_t ts, uint32_t duration) {
+    uint32_t start_ts;
+    if(pending->open && pending->start_ts <= ts) {
+        start_ts = pending->start_ts;
+        if(duration == 0) duration = ts - start_ts;
+    } else {
+        start_ts = (ts > duration) ? ts - duration : ts;
+    }
+    pending->open = false;
+    return export_row(app, kind, start_ts, ts, duration);
+}
+
+static bool export_record(AppData* app, const LogRecord* rec) {
+    if(log_is_deleted(rec->id)) return true; // Tombstoned - filtered on the fly
+    if(rec->ts == 0) return true;
+
+    switch(rec->type) {
+        case LogEventDiaper:
+            return export_row(app, "diaper", rec->ts, rec->ts, 0);
+        case LogEventFeedingStart:
+            return export_session_start(app, &g_export.feeding, "feeding", rec->ts);
+        case LogEventFeedingStop:
+            return export_session_stop(app, &g_export.feeding, "feeding", rec->ts, rec->duration);
+        case LogEventSleepStart:
+            return export_session_start(app, &g_export.sleep, "sleep", rec->ts);
+        case LogEventSleepStop:
+            return export_session_stop(app, &g_export.sleep, "sleep", rec->ts, rec->duration);
+    }
+    return true;
+}
+
+static void export_close(bool keep_file) {
+    log_history_close(&g_export.history);
+    if(g_export.out) {
+        buffered_file_stream_close(g_export.out);
+        stream_free(g_export.out);
+        g_export.out = NULL;
+
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        if(!keep_file) {
+            storage_common_remove(storage, export_path(g_export.format));
+        }
+        furi_record_close(RECORD_STORAGE);
+    }
+}
+
+static void export_finish(AppData* app, JobStatus status) {
+    export_close(status == JobDone);
+    app->export_status = status;
+    if(status == JobDone) app->export_percent = 100;
+    debug_log("log_export: finished");
+}
+
+bool log_export_start(AppData* app, ExportFormat format, uint32_t since) {
+    debug_log("log_export_start: start");
+
+    memset(&g_export, 0, sizeof(g_export));
+    g_export.format = format;
+    g_export.first_row = true;
+    app->export_rows = 0;
+    app->export_percent = 0;
+
+    log_tombstones_load();
+
+    // A missing log just exports an empty file
+    log_history_open(&g_export.history);
+    if(since > 0) log_history_seek(&g_export.history, since);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, LOG_DIR);
+    g_export.out = buffered_file_stream_alloc(storage);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!g_export.out ||
+       !buffered_file_stream_open(g_export.out, export_path(format), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        if(g_export.out) {
+            stream_free(g_export.out);
+            g_export.out = NULL;
+        }
+        log_history_close(&g_export.history);
+        app->export_status = JobFailed;
+        debug_log("log_export_start: open failed");
+        return false;
+    }
+
+    const char* header = (format == ExportFormatJson) ? "[\n" : "start,end,type,duration_s\n";
+    export_write(header, strlen(header));
+
+    app->export_status = JobRunning;
+    return true;
+}
+
+bool log_export_step(AppData* app) {
+    if(app->export_status != JobRunning) return false;
+
+    if(g_export.cancel) {
+        export_finish(app, JobCancelled);
+        return false;
+    }
+
+    for(int i = 0; i < EXPORT_LINES_PER_STEP; i++) {
+        const LogRecord* rec = log_history_next(&g_export.history);
+        if(!rec) {
+            // End of log - sessions still running are exported as open
+            bool ok = true;
+            if(g_export.feeding.open) {
+                ok &= export_row(app, "feeding", g_export.feeding.start_ts, 0, 0);
+            }
+            if(g_export.sleep.open) {
+                ok &= export_row(app, "sleep", g_export.sleep.start_ts, 0, 0);
+            }
+            if(g_export.format == ExportFormatJson) {
+                ok &= export_write("\n]\n", 3);
+            }
+            ok &= export_flush();
+            export_finish(app, ok ? JobDone : JobFailed);
+            return false;
+        }
+        if(!export_record(app, rec)) {
+            export_finish(app, JobFailed);
+            return false;
+        }
+    }
+
+    app->export_percent = log_history_percent(&g_export.history);
+    return true;
+}
+
+void log_export_cancel(void) {
+    g_export.cancel = true;
+}
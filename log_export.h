@@ -0,0 +1,10 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+
+#define EXPORT_CSV_PATH (child_paths()->export_csv)
+#define EXPORT_JSON_PATH (child_paths()->export_json)
+
+bool log_export_start(AppData* app, ExportFormat format, uint32_t since); // since 0 = whole history
+bool log_export_step(AppData* app); // Process one chunk, returns true while work remains
+void log_export_cancel(void);
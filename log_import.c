@@ -0,0 +1,257 @@
+#include "log_import.h"
+#include "log_store.h"
+#include "log_codec.h"
+#include "log_reader.h"
+#include "log_archive.h"
+#include "log_patch.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+// ==== MERGE IMPORT ====
+// Both logs are append-ordered by time, so a single k-way merge pass by
+// timestamp produces the combined log. Each source only keeps its current
+// record in RAM. IDs are derived from the event time, so a duplicate can only
+// meet its twin among records with the same timestamp - a small window of
+// (id, type) hashes for the current second is enough to drop it.
+// The local side is the whole history including archive segments; the merged
+// log is written to log.tmp and replaces both on swap-in (the next rotation
+// re-archives the old part).
+
+#define MERGE_SOURCES 2 // Local log + imported log
+#define MERGE_LINES_PER_STEP 16
+#define MERGE_OUT_CHUNK 256
+#define MERGE_DEDUP_WINDOW 16
+
+typedef struct {
+    const LogRecord* rec; // Current head record, NULL when exhausted
+    uint32_t ts;
+} MergeSource;
+
+static struct {
+    MergeSource sources[MERGE_SOURCES];
+    LogHistory local;
+    LogReader remote;
+    LogRecord remote_record;
+    size_t remote_size;
+    Stream* out;
+    char out_buf[MERGE_OUT_CHUNK];
+    size_t out_len;
+    uint32_t window_ts;
+    uint32_t window[MERGE_DEDUP_WINDOW];
+    int window_count;
+    volatile bool cancel;
+} g_import;
+
+static bool merge_flush(void) {
+    if(g_import.out_len == 0) return true;
+    size_t written = stream_write(g_import.out, (uint8_t*)g_import.out_buf, g_import.out_len);
+    bool ok = (written == g_import.out_len);
+    g_import.out_len = 0;
+    return ok;
+}
+
+static bool merge_write_record(const LogRecord* rec) {
+    ScratchMark mark = scratch_mark();
+    char* line = scratch_alloc(LOG_LINE_MAX);
+    int len = log_format_record(rec, line, LOG_LINE_MAX);
+    bool ok = len > 0 && (g_import.out_len + len <= MERGE_OUT_CHUNK || merge_flush());
+    if(ok) {
+        memcpy(g_import.out_buf + g_import.out_len, line, len);
+        g_import.out_len += len;
+    }
+    scratch_release(mark);
+    return ok;
+}
+
+static const LogRecord* merge_read(int idx) {
+    if(idx == 0) return log_history_next(&g_import.local);
+
+    const char* line;
+    while((line = log_reader_next(&g_import.remote)) != NULL) {
+        if(log_parse_record(line, &g_import.remote_record)) return &g_import.remote_record;
+    }
+    return NULL;
+}
+
+// Move a source to its next live record, skipping malformed and tombstoned lines
+static void merge_advance(int idx) {
+    MergeSource* src = &g_import.sources[idx];
+    const LogRecord* rec;
+    while((rec = merge_read(idx)) != NULL) {
+        if(log_is_deleted(rec->id)) continue;
+        // The local copy is gone, the other device may still have it
+        if(idx > 0 && log_tombstone_archived(rec->id)) continue;
+        // Unparseable timestamps can't be written back - drop them
+        if(rec->ts == 0) continue;
+
+        src->ts = rec->ts;
+        src->rec = rec;
+        return;
+    }
+    src->rec = NULL;
+}
+
+// Returns true if this (id, type) was already written for the current second
+static bool merge_is_duplicate(const LogRecord* rec) {
+    if(rec->ts != g_import.window_ts) {
+        g_import.window_ts = rec->ts;
+        g_import.window_count = 0;
+    }
+
+    uint32_t key = log_hash_id(rec->id) ^ ((uint32_t)rec->type * 0x9E3779B9u);
+
+    for(int i = 0; i < g_import.window_count; i++) {
+        if(g_import.window[i] == key) return true;
+    }
+    if(g_import.window_count < MERGE_DEDUP_WINDOW) {
+        g_import.window[g_import.window_count++] = key;
+    }
+    return false;
+}
+
+static void merge_close(void) {
+    log_tombstones_archive_close();
+    log_history_close(&g_import.local);
+    log_reader_close(&g_import.remote);
+    if(g_import.out) {
+        buffered_file_stream_close(g_import.out);
+        stream_free(g_import.out);
+        g_import.out = NULL;
+    }
+}
+
+// Replace log.jsonl and the archive with the merged log.tmp
+static bool merge_swap_in(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, ARCHIVE_DIR);
+    File* marker = storage_file_alloc(storage);
+    bool ok = storage_file_open(marker, ARCHIVE_RESET_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    storage_file_close(marker);
+    storage_file_free(marker);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!ok || !log_swap_in()) return false;
+    log_patches_clear(); // Merged log was read through the overlay
+    return true;
+}
+
+static void merge_finish(AppData* app, JobStatus status) {
+    merge_close();
+
+    if(status == JobDone && !merge_swap_in()) {
+        status = JobFailed;
+    }
+    if(status != JobDone) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        storage_common_remove(storage, LOG_TMP_PATH);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    app->import_status = status;
+    if(status == JobDone) app->import_percent = 100;
+    debug_log("log_import: finished");
+}
+
+bool log_import_start(AppData* app) {
+    debug_log("log_import_start: start");
+
+    memset(&g_import, 0, sizeof(g_import));
+    app->import_added = 0;
+    app->import_dups = 0;
+    app->import_percent = 0;
+    app->import_deletes_full = false;
+
+    // Both tombstone sets apply to the merged log
+    log_tombstones_load();
+    log_tombstones_add_file(IMPORT_DELETED_PATH);
+    if(log_tombstones_full()) {
+        // A delete that didn't fit would bring its event back
+        app->import_deletes_full = true;
+        app->import_status = JobFailed;
+        log_tombstones_load();
+        debug_log("log_import_start: tombstones full");
+        return false;
+    }
+    log_tombstones_archive_open(); // Missing until a rotation compacted deletes
+
+    if(!log_reader_open(&g_import.remote, IMPORT_LOG_PATH)) {
+        app->import_status = JobFailed;
+        debug_log("log_import_start: no import/log.jsonl");
+        return false;
+    }
+    g_import.remote_size = g_import.remote.size;
+    log_history_open(&g_import.local); // Local log may not exist yet
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    g_import.out = buffered_file_stream_alloc(storage);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!g_import.out ||
+       !buffered_file_stream_open(g_import.out, LOG_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        merge_finish(app, JobFailed);
+        debug_log("log_import_start: open log.tmp failed");
+        return false;
+    }
+
+    for(int i = 0; i < MERGE_SOURCES; i++) {
+        merge_advance(i);
+    }
+
+    app->import_status = JobRunning;
+    return true;
+}
+
+bool log_import_step(AppData* app) {
+    if(app->import_status != JobRunning) return false;
+
+    if(g_import.cancel) {
+        merge_finish(app, JobCancelled);
+        return false;
+    }
+
+    for(int n = 0; n < MERGE_LINES_PER_STEP; n++) {
+        // Pick the source with the oldest head record (local wins ties)
+        MergeSource* next = NULL;
+        int next_idx = 0;
+        for(int i = 0; i < MERGE_SOURCES; i++) {
+            MergeSource* src = &g_import.sources[i];
+            if(src->rec && (!next || src->ts < next->ts)) {
+                next = src;
+                next_idx = i;
+            }
+        }
+
+        if(!next) {
+            merge_finish(app, merge_flush() ? JobDone : JobFailed);
+            return false;
+        }
+
+        if(merge_is_duplicate(next->rec)) {
+            app->import_dups++;
+        } else {
+            if(!merge_write_record(next->rec)) {
+                merge_finish(app, JobFailed);
+                return false;
+            }
+            if(next_idx > 0) app->import_added++;
+        }
+        merge_advance(next_idx);
+    }
+
+    // Weighted by file size across both sides
+    size_t total = g_import.local.total_size + g_import.remote_size;
+    if(total > 0) {
+        size_t consumed = (size_t)log_history_percent(&g_import.local) * g_import.local.total_size / 100 +
+                          log_reader_consumed(&g_import.remote);
+        app->import_percent = (uint8_t)((uint64_t)consumed * 100 / total);
+    }
+    return true;
+}
+
+void log_import_cancel(void) {
+    g_import.cancel = true;
+}
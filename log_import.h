@@ -0,0 +1,11 @@
+#pragma once
+#include "app_state.h"
+
+// Files copied over from the second device
+#define IMPORT_DIR EXT_PATH("apps/baby_log/import")
+#define IMPORT_LOG_PATH EXT_PATH("apps/baby_log/import/log.jsonl")
+#define IMPORT_DELETED_PATH EXT_PATH("apps/baby_log/import/deleted.jsonl")
+
+bool log_import_start(AppData* app);
+bool log_import_step(AppData* app); // Merge a batch of lines, returns true while work remains
+void log_import_cancel(void);
@@ -0,0 +1,156 @@
+#include "log_last.h"
+#include "log_store.h"
+#include "log_sessions.h"
+#include <storage/storage.h>
+#include <furi.h>
+#include <string.h>
+
+#define LAST_MAGIC "BLL1"
+
+// Table changed since the last save of the derived tables, written by
+// log_last_checkpoint() (see log_tables.h)
+static struct {
+    bool pending;
+    LastEvent last[LOG_EVENT_TYPE_COUNT];
+} g_last;
+
+// ==== PERSISTENCE ====
+
+static bool last_write(const LastEvent* last) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, LAST_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        size_t size = sizeof(LastEvent) * LOG_EVENT_TYPE_COUNT;
+        ok = storage_file_write(file, LAST_MAGIC, 4) == 4 &&
+             storage_file_write(file, last, size) == size;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    if(!ok) debug_log("log_last: save failed");
+    return ok;
+}
+
+bool log_last_read(LastEvent* last) {
+    size_t size = sizeof(LastEvent) * LOG_EVENT_TYPE_COUNT;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, LAST_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        char magic[4];
+        ok = storage_file_size(file) == 4 + size &&
+             storage_file_read(file, magic, 4) == 4 && memcmp(magic, LAST_MAGIC, 4) == 0 &&
+             storage_file_read(file, last, size) == size;
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+static void last_save(const AppData* app) {
+    memcpy(g_last.last, app->last, sizeof(g_last.last));
+    g_last.pending = true;
+}
+
+bool log_last_checkpoint(void) {
+    if(!g_last.pending) return true;
+    g_last.pending = false;
+    return last_write(g_last.last);
+}
+
+// ==== LOOKUP ====
+
+static void last_set(LastEvent* last, uint32_t ts, uint32_t id, uint32_t duration) {
+    last->ts = ts;
+    last->id = id;
+    last->duration = duration;
+}
+
+// Newest event of a type in the ring
+static bool last_from_ring(AppData* app, LogEventType type, LastEvent* last) {
+    for(int i = app->log_count - 1; i >= 0; i--) {
+        const LogEntry* entry = log_recent_get(app, i);
+        if(entry->type != type) continue;
+        uint32_t id = entry->id; // Foreign IDs are kept as their hash
+        if(!entry->foreign) {
+            char text[LOG_ID_LEN + 1];
+            log_format_id(entry->id, text);
+            id = log_hash_id(text);
+        }
+        last_set(last, entry->timestamp, id, entry->duration);
+        return true;
+    }
+    return false;
+}
+
+// Newest start or stop of a session kind: it is in one of the last two records
+static bool last_from_sessions(LogEventType type, LastEvent* last) {
+    SessionKind kind = (type == LogEventFeedingStart || type == LogEventFeedingStop) ? SessionFeeding :
+                                                                                       SessionSleep;
+    bool is_start = (type == LogEventFeedingStart || type == LogEventSleepStart);
+    uint32_t count = log_sessions_count(kind);
+    if(count == 0) return false;
+
+    SessionRecord sessions[2];
+    uint32_t first = (count > 2) ? count - 2 : 0;
+    uint32_t n = log_sessions_read(kind, first, sessions, 2);
+    for(int i = (int)n - 1; i >= 0; i--) {
+        const SessionRecord* session = &sessions[i];
+        if(is_start && session->start_id) {
+            last_set(last, session->start_ts, session->start_id, 0);
+            return true;
+        }
+        if(!is_start && session->stop_id) {
+            last_set(last, session->end_ts, session->stop_id, session->duration);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void last_find(AppData* app, LogEventType type) {
+    LastEvent* last = &app->last[type];
+    if(last_from_ring(app, type, last)) return;
+    if(type != LogEventDiaper && last_from_sessions(type, last)) return;
+    last_set(last, 0, 0, 0);
+}
+
+// ==== UPDATES ====
+
+void log_last_seed(AppData* app) {
+    debug_log("log_last_seed: start");
+    for(int type = 0; type < LOG_EVENT_TYPE_COUNT; type++) {
+        last_find(app, (LogEventType)type);
+    }
+    last_save(app);
+}
+
+void log_last_load(AppData* app) {
+    g_last.pending = false;
+    if(!log_last_read(app->last)) log_last_seed(app);
+}
+
+void log_last_add(AppData* app, const LogRecord* rec) {
+    if(rec->ts == 0 || rec->type >= LOG_EVENT_TYPE_COUNT) return;
+    LastEvent* last = &app->last[rec->type];
+    if(rec->ts < last->ts) return; // Past event, older than the newest
+    last_set(last, rec->ts, log_hash_id(rec->id), rec->duration);
+    last_save(app);
+}
+
+void log_last_remove(AppData* app, const LogRecord* rec) {
+    if(rec->type >= LOG_EVENT_TYPE_COUNT) return;
+    if(app->last[rec->type].id != log_hash_id(rec->id)) return;
+    last_find(app, rec->type);
+    last_save(app);
+}
+
+void log_last_clear(AppData* app) {
+    memset(app->last, 0, sizeof(app->last));
+    g_last.pending = false;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, LAST_PATH);
+    furi_record_close(RECORD_STORAGE);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+#include "log_codec.h"
+
+// ==== LAST EVENT TABLE ====
+// The newest live event of each type (timestamp, ID hash, duration) in
+// AppData, so "time since" on the main screen and the reminder deadlines
+// are O(1) and never touch the card. Logging an event that is newer than
+// the entry replaces it. Delete, redo and edit look for the replacement in
+// the recent ring, which always holds the newest events, then in the
+// session index; a diaper older than the ring is forgotten.
+// Kept in last.bin, written with the other derived tables (log_tables.h).
+// A missing last.bin, or one not closed cleanly, is seeded from the ring
+// and the session index.
+
+#define LAST_PATH (child_paths()->last)
+
+void log_last_load(AppData* app); // After log_load_recent() and log_sessions_load()
+void log_last_seed(AppData* app); // Log replaced (import)
+void log_last_add(AppData* app, const LogRecord* rec);
+void log_last_remove(AppData* app, const LogRecord* rec); // After the ring dropped it
+void log_last_clear(AppData* app);
+bool log_last_read(LastEvent* last); // last.bin as saved, for a child slot; false if missing
+bool log_last_checkpoint(void); // Called by log_tables_save()
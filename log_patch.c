@@ -0,0 +1,217 @@
+#include "log_patch.h"
+#include "log_store.h"
+#include "log_reader.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+static PatchEntry g_patches[PATCH_MAX];
+static uint8_t g_patch_count = 0;
+static uint8_t g_injected[PATCH_MAX]; // Indices of added/moved entries, by time
+static uint8_t g_injected_count = 0;
+static uint8_t g_fold[PATCH_MAX];
+
+#define PATCH_LINE_MAX (LOG_LINE_MAX + 32) // Record plus the op prefix
+
+#define FOLD_EMITTED 0x01
+#define FOLD_SEEN 0x02
+
+static int patch_index(uint32_t hash) {
+    for(int i = 0; i < g_patch_count; i++) {
+        if(g_patches[i].hash == hash) return i;
+    }
+    return -1;
+}
+
+static void injected_rebuild(void) {
+    g_injected_count = 0;
+    for(uint8_t i = 0; i < g_patch_count; i++) {
+        if(!(g_patches[i].flags & (PATCH_ADDED | PATCH_MOVED))) continue;
+
+        // Insertion sort - the overlay is tiny
+        uint8_t pos = g_injected_count++;
+        while(pos > 0 && g_patches[g_injected[pos - 1]].rec.ts > g_patches[i].rec.ts) {
+            g_injected[pos] = g_injected[pos - 1];
+            pos--;
+        }
+        g_injected[pos] = i;
+    }
+}
+
+// Merge one patch into the overlay; false when full
+static bool overlay_put(const LogRecord* rec, uint8_t flags) {
+    uint32_t hash = log_hash_id(rec->id);
+    int idx = patch_index(hash);
+    if(idx < 0) {
+        if(g_patch_count >= PATCH_MAX) return false;
+        idx = g_patch_count++;
+        g_patches[idx].hash = hash;
+        g_patches[idx].flags = 0;
+        g_fold[idx] = 0;
+    }
+    g_patches[idx].flags |= flags;
+    g_patches[idx].rec = *rec;
+    return true;
+}
+
+static uint8_t parse_flags(const char* line) {
+    if(strstr(line, "\"op\":\"add\"")) return PATCH_ADDED;
+    if(strstr(line, "\"field\":\"ts\"")) return PATCH_MOVED;
+    return PATCH_DUR;
+}
+
+static int format_patch(const LogRecord* rec, uint8_t flags, char* out, size_t out_size) {
+    const char* tags;
+    if(flags & PATCH_ADDED) {
+        tags = "\"op\":\"add\",";
+    } else if(flags & PATCH_MOVED) {
+        tags = "\"op\":\"set\",\"field\":\"ts\",";
+    } else {
+        tags = "\"op\":\"set\",\"field\":\"dur\",";
+    }
+    return log_format_record_tagged(tags, rec, out, out_size);
+}
+
+void log_patches_load(void) {
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    g_patch_count = 0;
+    g_injected_count = 0;
+    if(!log_reader_open(&reader, PATCHES_PATH)) return;
+
+    const char* line;
+    LogRecord rec;
+    while((line = log_reader_next(&reader)) != NULL) {
+        if(!log_parse_record(line, &rec) || rec.ts == 0) continue;
+        if(!overlay_put(&rec, parse_flags(line))) {
+            debug_log("log_patches_load: overlay full");
+            break;
+        }
+    }
+    log_reader_close(&reader);
+    injected_rebuild();
+}
+
+uint8_t log_patch_count(void) {
+    return g_patch_count;
+}
+
+static bool append_line(const char* path, const char* line, size_t len) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, LOG_DIR);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    bool ok = false;
+    if(buffered_file_stream_open(stream, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        ok = (stream_write(stream, (const uint8_t*)line, len) == len);
+        buffered_file_stream_close(stream);
+    }
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+bool log_patch_write(const LogRecord* rec, uint8_t flags) {
+    if(g_patch_count >= PATCH_MAX && !log_patch_find(rec->id)) {
+        debug_log("log_patch_write: overlay full");
+        return false;
+    }
+
+    ScratchMark mark = scratch_mark();
+    char* line = scratch_alloc(PATCH_LINE_MAX);
+    int len = format_patch(rec, flags, line, PATCH_LINE_MAX);
+    bool ok = len > 0 && append_line(PATCHES_PATH, line, len);
+    scratch_release(mark);
+    if(!ok) return false;
+
+    overlay_put(rec, flags);
+    injected_rebuild();
+    return true;
+}
+
+const PatchEntry* log_patch_find(const char* id) {
+    if(g_patch_count == 0) return NULL;
+    int idx = patch_index(log_hash_id(id));
+    return (idx < 0) ? NULL : &g_patches[idx];
+}
+
+const LogRecord* log_patch_apply(const LogRecord* rec, LogRecord* scratch) {
+    const PatchEntry* patch = log_patch_find(rec->id);
+    if(!patch) return rec;
+    if(patch->flags & (PATCH_ADDED | PATCH_MOVED)) return NULL;
+
+    *scratch = *rec;
+    scratch->duration = patch->rec.duration;
+    return scratch;
+}
+
+uint8_t log_patch_injected_count(void) {
+    return g_injected_count;
+}
+
+const LogRecord* log_patch_injected(uint8_t index) {
+    if(index >= g_injected_count) return NULL;
+    return &g_patches[g_injected[index]].rec;
+}
+
+// ==== FOLDING ====
+
+static void mark(const char* id, uint8_t bit) {
+    int idx = patch_index(log_hash_id(id));
+    if(idx >= 0) g_fold[idx] |= bit;
+}
+
+void log_patch_mark_emitted(const char* id) {
+    mark(id, FOLD_EMITTED);
+}
+
+void log_patch_mark_seen(const char* id) {
+    mark(id, FOLD_SEEN);
+}
+
+static bool folded(uint8_t i) {
+    if(g_patches[i].flags & PATCH_ADDED) return g_fold[i] & FOLD_EMITTED;
+    if(g_patches[i].flags & PATCH_MOVED) return g_fold[i] == (FOLD_EMITTED | FOLD_SEEN);
+    return g_fold[i] & FOLD_SEEN;
+}
+
+bool log_patches_write_unfolded(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PATCHES_TMP_PATH);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    bool ok = buffered_file_stream_open(stream, PATCHES_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    ScratchMark mark = scratch_mark();
+    char* line = scratch_alloc(PATCH_LINE_MAX);
+    for(uint8_t i = 0; ok && i < g_patch_count; i++) {
+        if(folded(i)) continue;
+        int len = format_patch(&g_patches[i].rec, g_patches[i].flags, line, PATCH_LINE_MAX);
+        ok = len > 0 && stream_write(stream, (uint8_t*)line, len) == (size_t)len;
+    }
+    scratch_release(mark);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    if(!ok) storage_common_remove(storage, PATCHES_TMP_PATH);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+void log_patches_commit(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(storage_common_exists(storage, PATCHES_TMP_PATH)) {
+        storage_common_remove(storage, PATCHES_PATH);
+        storage_common_rename(storage, PATCHES_TMP_PATH, PATCHES_PATH);
+    }
+    furi_record_close(RECORD_STORAGE);
+    log_patches_load();
+}
+
+void log_patches_clear(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PATCHES_PATH);
+    storage_common_remove(storage, PATCHES_TMP_PATH);
+    furi_record_close(RECORD_STORAGE);
+    g_patch_count = 0;
+    g_injected_count = 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "app_state.h"
+#include "log_codec.h"
+
+// ==== PATCH OVERLAY ====
+// Retroactive entries and corrections are appended to patches.jsonl instead
+// of rewriting the log. Each line is the full record with its new values:
+//   {"op":"add",<record>}                 event inserted at a past time
+//   {"op":"set","field":"ts",<record>}    event moved to another time
+//   {"op":"set","field":"dur",<record>}   duration fixed
+// The newest line per ID wins. Readers apply them through an in-RAM overlay:
+// moved and added records are skipped in the stream and merged back in at
+// their new time, duration fixes are applied in place. Archive rotation and
+// import fold the patches into the rewritten log.
+
+#define PATCH_MAX 32
+#define PATCH_FOLD_AT 24 // Fold at next startup once the overlay is this full
+
+#define PATCH_ADDED 0x01 // Not in the log at all
+#define PATCH_MOVED 0x02 // Time changed - emitted from the overlay, not the stream
+#define PATCH_DUR 0x04
+
+typedef struct {
+    uint32_t hash;
+    uint8_t flags;
+    LogRecord rec;
+} PatchEntry;
+
+void log_patches_load(void);
+uint8_t log_patch_count(void);
+bool log_patch_write(const LogRecord* rec, uint8_t flags); // False if the overlay is full or the write failed
+const PatchEntry* log_patch_find(const char* id);
+
+// Overlay a stream record: returns rec, scratch holding the patched copy,
+// or NULL if the record is emitted from the overlay instead
+const LogRecord* log_patch_apply(const LogRecord* rec, LogRecord* scratch);
+
+// Added and moved records, in time order
+uint8_t log_patch_injected_count(void);
+const LogRecord* log_patch_injected(uint8_t index);
+
+// Folding: a rewrite reports what it wrote, then only patches it did not
+// fully absorb are kept. A move is absorbed once its new copy was written
+// and its old one was passed in the stream.
+void log_patch_mark_emitted(const char* id); // Injected copy written
+void log_patch_mark_seen(const char* id); // Stream copy passed through the overlay
+bool log_patches_write_unfolded(void); // Into patches.tmp
+void log_patches_commit(void); // patches.tmp replaces patches.jsonl
+void log_patches_clear(void); // Every patch folded in
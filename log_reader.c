@@ -0,0 +1,103 @@
+#include "log_reader.h"
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+bool log_reader_open(LogReader* reader, const char* path) {
+    memset(reader, 0, sizeof(LogReader));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    reader->stream = buffered_file_stream_alloc(storage);
+    if(!reader->stream) {
+        furi_record_close(RECORD_STORAGE);
+        return false;
+    }
+
+    if(!buffered_file_stream_open(reader->stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        stream_free(reader->stream);
+        reader->stream = NULL;
+        furi_record_close(RECORD_STORAGE);
+        return false;
+    }
+
+    reader->size = stream_size(reader->stream);
+    return true;
+}
+
+const char* log_reader_next(LogReader* reader) {
+    if(!reader->stream) return NULL;
+
+    while(true) {
+        // Refill chunk
+        if(reader->chunk_pos >= reader->chunk_len) {
+            reader->chunk_len = stream_read(reader->stream, (uint8_t*)reader->chunk, LOG_READER_CHUNK);
+            reader->chunk_pos = 0;
+            reader->offset += reader->chunk_len;
+
+            if(reader->chunk_len == 0) {
+                // End of file - flush an unterminated last line
+                if(reader->line_len > 0 && !reader->overflow) {
+                    reader->line[reader->line_len] = '\0';
+                    reader->line_len = 0;
+                    return reader->line;
+                }
+                reader->line_len = 0;
+                reader->overflow = false;
+                return NULL;
+            }
+        }
+
+        while(reader->chunk_pos < reader->chunk_len) {
+            char c = reader->chunk[reader->chunk_pos++];
+
+            if(c == '\n' || c == '\r') {
+                bool complete = (reader->line_len > 0 && !reader->overflow);
+                size_t len = reader->line_len;
+                reader->line_len = 0;
+                reader->overflow = false;
+                if(complete) {
+                    reader->line[len] = '\0';
+                    return reader->line;
+                }
+                continue;
+            }
+
+            if(reader->line_len < LOG_READER_LINE - 1) {
+                reader->line[reader->line_len++] = c;
+            } else {
+                reader->overflow = true;
+            }
+        }
+    }
+}
+
+bool log_reader_seek(LogReader* reader, size_t offset) {
+    if(!reader->stream || offset > reader->size) return false;
+
+    // Start one byte early: a newline there means offset is a line start
+    size_t start = (offset > 0) ? offset - 1 : 0;
+    if(!stream_seek(reader->stream, start, StreamOffsetFromStart)) return false;
+    reader->offset = start;
+    reader->chunk_len = 0;
+    reader->chunk_pos = 0;
+    reader->line_len = 0;
+    reader->overflow = (offset > 0); // Drop up to the next line break
+    return true;
+}
+
+size_t log_reader_consumed(LogReader* reader) {
+    return reader->offset - (reader->chunk_len - reader->chunk_pos);
+}
+
+uint8_t log_reader_percent(LogReader* reader) {
+    if(reader->size == 0) return 100;
+    return (uint8_t)((uint64_t)log_reader_consumed(reader) * 100 / reader->size);
+}
+
+void log_reader_close(LogReader* reader) {
+    if(!reader->stream) return;
+    buffered_file_stream_close(reader->stream);
+    stream_free(reader->stream);
+    reader->stream = NULL;
+    furi_record_close(RECORD_STORAGE);
+}
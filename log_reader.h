@@ -0,0 +1,28 @@
+#pragma once
+#include <storage/storage.h>
+#include <stream/stream.h>
+
+// Chunked line reader for JSONL files.
+// Reads fixed-size chunks so RAM use is bounded regardless of file size.
+
+#define LOG_READER_CHUNK 256
+#define LOG_READER_LINE 160
+
+typedef struct {
+    Stream* stream;
+    size_t size;
+    size_t offset; // Bytes pulled from the file so far
+    char chunk[LOG_READER_CHUNK];
+    size_t chunk_len;
+    size_t chunk_pos;
+    char line[LOG_READER_LINE];
+    size_t line_len;
+    bool overflow; // Current line exceeded LOG_READER_LINE and is being dropped
+} LogReader;
+
+bool log_reader_open(LogReader* reader, const char* path);
+const char* log_reader_next(LogReader* reader); // Next non-empty line, NULL at end of file
+bool log_reader_seek(LogReader* reader, size_t offset); // To the first line starting at or after offset
+size_t log_reader_consumed(LogReader* reader); // Bytes handed out as lines so far
+uint8_t log_reader_percent(LogReader* reader);
+void log_reader_close(LogReader* reader);
@@ -0,0 +1,591 @@
+#include "log_sessions.h"
+#include "log_store.h"
+#include "log_archive.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <furi.h>
+#include <string.h>
+
+#define SESSIONS_MAGIC "BLI1"
+#define SESSIONS_HEADER_SIZE 8 // Magic + flags
+#define SESSIONS_DIRTY 0x01 // Records may not match the log
+#define SESSIONS_MOVE_CHUNK 8 // Records moved per read/write when shifting
+#define SESSIONS_RECORDS_PER_STEP 64
+#define SESSIONS_QUEUE_MAX 16 // Live feeds and sleeps indexed in one go
+
+static struct {
+    // Live events not indexed yet, written when the queue fills, before
+    // the index is read and with the other derived tables (log_tables.h).
+    // Power loss drops them; the index is rebuilt at the next start.
+    LogRecord queued[SESSIONS_QUEUE_MAX];
+    uint8_t queued_count;
+    AppData* app;
+} g_sessions;
+
+static struct {
+    bool running;
+    bool restart; // The log changed under the running rebuild
+    LogHistory history;
+    Stream* out[SessionKindCount];
+    SessionRecord pending[SessionKindCount];
+    bool open[SessionKindCount]; // pending holds a start waiting for its stop
+} g_rebuild;
+
+static const char* session_path(SessionKind kind) {
+    return (kind == SessionFeeding) ? SESSIONS_FEED_PATH : SESSIONS_SLEEP_PATH;
+}
+
+static bool session_kind(LogEventType type, SessionKind* kind, bool* is_start) {
+    switch(type) {
+        case LogEventFeedingStart:
+        case LogEventFeedingStop:
+            *kind = SessionFeeding;
+            *is_start = (type == LogEventFeedingStart);
+            return true;
+        case LogEventSleepStart:
+        case LogEventSleepStop:
+            *kind = SessionSleep;
+            *is_start = (type == LogEventSleepStart);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Time of the first event - the sort key
+static uint32_t session_key(const SessionRecord* session) {
+    return session->start_id ? session->start_ts : session->end_ts;
+}
+
+static void session_open_at(SessionRecord* session, SessionKind kind, uint32_t ts, uint32_t start_id) {
+    memset(session, 0, sizeof(SessionRecord));
+    session->type = (kind == SessionFeeding) ? LogEventFeedingStart : LogEventSleepStart;
+    session->start_ts = ts;
+    session->start_id = start_id;
+}
+
+static void session_close_at(SessionRecord* session, uint32_t ts, uint32_t duration, uint32_t stop_id) {
+    session->end_ts = ts;
+    session->duration = duration;
+    session->stop_id = stop_id;
+}
+
+// Stop without a start: the start is derived from the duration, like the export
+static void session_stop_only(SessionRecord* session, SessionKind kind, uint32_t ts, uint32_t duration, uint32_t stop_id) {
+    session_open_at(session, kind, (ts > duration) ? ts - duration : ts, 0);
+    session_close_at(session, ts, duration, stop_id);
+}
+
+// ==== INDEX FILE ====
+
+void log_sessions_encode(const SessionRecord* session, uint8_t* out) {
+    log_put_u32(out, session->start_ts);
+    log_put_u32(out + 4, session->end_ts);
+    log_put_u32(out + 8, session->duration);
+    log_put_u32(out + 12, session->start_id);
+    log_put_u32(out + 16, session->stop_id);
+    out[20] = session->type;
+    memset(out + 21, 0, 3);
+}
+
+void log_sessions_decode(const uint8_t* in, SessionRecord* session) {
+    session->start_ts = log_get_u32(in);
+    session->end_ts = log_get_u32(in + 4);
+    session->duration = log_get_u32(in + 8);
+    session->start_id = log_get_u32(in + 12);
+    session->stop_id = log_get_u32(in + 16);
+    session->type = in[20];
+    memset(session->reserved, 0, sizeof(session->reserved));
+}
+
+typedef struct {
+    File* file;
+    SessionKind kind;
+    uint32_t count;
+} SessionFile;
+
+static void file_close(SessionFile* sf) {
+    storage_file_close(sf->file);
+    storage_file_free(sf->file);
+    sf->file = NULL;
+}
+
+// Fails if the file is missing, damaged, or dirty and dirty_ok is not set
+static bool file_open(Storage* storage, SessionFile* sf, SessionKind kind, bool dirty_ok) {
+    sf->kind = kind;
+    sf->count = 0;
+    sf->file = storage_file_alloc(storage);
+    if(!storage_file_open(sf->file, session_path(kind), FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        file_close(sf);
+        return false;
+    }
+
+    uint8_t header[SESSIONS_HEADER_SIZE];
+    uint64_t size = storage_file_size(sf->file);
+    bool ok = size >= SESSIONS_HEADER_SIZE &&
+              (size - SESSIONS_HEADER_SIZE) % SESSIONS_RECORD_SIZE == 0 &&
+              storage_file_read(sf->file, header, SESSIONS_HEADER_SIZE) == SESSIONS_HEADER_SIZE &&
+              memcmp(header, SESSIONS_MAGIC, 4) == 0 &&
+              (!(log_get_u32(header + 4) & SESSIONS_DIRTY) || dirty_ok);
+    if(!ok) {
+        file_close(sf);
+        return false;
+    }
+    sf->count = (uint32_t)((size - SESSIONS_HEADER_SIZE) / SESSIONS_RECORD_SIZE);
+    return true;
+}
+
+static bool file_mark(SessionFile* sf, bool dirty) {
+    uint8_t flags[4];
+    log_put_u32(flags, dirty ? SESSIONS_DIRTY : 0);
+    return storage_file_seek(sf->file, 4, true) && storage_file_write(sf->file, flags, 4) == 4;
+}
+
+static bool file_seek(SessionFile* sf, uint32_t index) {
+    return storage_file_seek(sf->file, SESSIONS_HEADER_SIZE + index * SESSIONS_RECORD_SIZE, true);
+}
+
+static bool record_get(SessionFile* sf, uint32_t index, SessionRecord* session) {
+    uint8_t data[SESSIONS_RECORD_SIZE];
+    if(index >= sf->count || !file_seek(sf, index) ||
+       storage_file_read(sf->file, data, SESSIONS_RECORD_SIZE) != SESSIONS_RECORD_SIZE) {
+        return false;
+    }
+    log_sessions_decode(data, session);
+    return true;
+}
+
+static bool record_put(SessionFile* sf, uint32_t index, const SessionRecord* session) {
+    uint8_t data[SESSIONS_RECORD_SIZE];
+    log_sessions_encode(session, data);
+    return file_seek(sf, index) &&
+           storage_file_write(sf->file, data, SESSIONS_RECORD_SIZE) == SESSIONS_RECORD_SIZE;
+}
+
+// First record whose key is after ts; equal keys stay in front
+static uint32_t record_upper_bound(SessionFile* sf, uint32_t ts) {
+    uint32_t low = 0;
+    uint32_t high = sf->count;
+    SessionRecord session;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if(!record_get(sf, mid, &session)) return sf->count;
+        if(session_key(&session) <= ts) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static bool record_move(SessionFile* sf, uint32_t from, uint32_t to, uint32_t n, void* buffer) {
+    size_t size = n * SESSIONS_RECORD_SIZE;
+    return file_seek(sf, from) && storage_file_read(sf->file, buffer, size) == size &&
+           file_seek(sf, to) && storage_file_write(sf->file, buffer, size) == size;
+}
+
+// Records after index move up one; the file is dirty while they move
+static bool record_insert(SessionFile* sf, uint32_t index, const SessionRecord* session) {
+    bool shift = index < sf->count;
+    bool ok = !shift || file_mark(sf, true);
+
+    ScratchMark mark = scratch_mark();
+    void* buffer = scratch_alloc(SESSIONS_MOVE_CHUNK * SESSIONS_RECORD_SIZE);
+    uint32_t end = sf->count;
+    while(ok && end > index) {
+        uint32_t n = (end - index < SESSIONS_MOVE_CHUNK) ? end - index : SESSIONS_MOVE_CHUNK;
+        end -= n;
+        ok = record_move(sf, end, end + 1, n, buffer);
+    }
+    scratch_release(mark);
+
+    ok = ok && record_put(sf, index, session);
+    if(ok) sf->count++;
+    return ok && (!shift || file_mark(sf, false));
+}
+
+static bool record_delete(SessionFile* sf, uint32_t index) {
+    bool shift = index + 1 < sf->count;
+    bool ok = !shift || file_mark(sf, true);
+
+    ScratchMark mark = scratch_mark();
+    void* buffer = scratch_alloc(SESSIONS_MOVE_CHUNK * SESSIONS_RECORD_SIZE);
+    uint32_t start = index + 1;
+    while(ok && start < sf->count) {
+        uint32_t n = (sf->count - start < SESSIONS_MOVE_CHUNK) ? sf->count - start : SESSIONS_MOVE_CHUNK;
+        ok = record_move(sf, start, start - 1, n, buffer);
+        start += n;
+    }
+    scratch_release(mark);
+
+    ok = ok && file_seek(sf, sf->count - 1) && storage_file_truncate(sf->file);
+    if(ok) sf->count--;
+    return ok && (!shift || file_mark(sf, false));
+}
+
+// ==== INCREMENTAL UPDATES ====
+// Per kind the records form one chain in event order, so an event only
+// changes the pairing with its neighbours: the record it lands in or after
+// (prev) and the one after it (next).
+
+static bool insert_event(SessionFile* sf, bool is_start, const LogRecord* rec) {
+    uint32_t id = log_hash_id(rec->id);
+    uint32_t index = record_upper_bound(sf, rec->ts);
+    SessionRecord prev;
+    SessionRecord next;
+    SessionRecord added;
+    bool has_prev = index > 0 && record_get(sf, index - 1, &prev);
+    bool has_next = record_get(sf, index, &next);
+
+    if(has_prev && prev.start_id && prev.end_ts > rec->ts) {
+        // Lands inside a closed session and splits it
+        if(is_start) {
+            // The earlier start stays open, this one takes the stop
+            session_open_at(&added, sf->kind, rec->ts, id);
+            session_close_at(&added, prev.end_ts, prev.duration, prev.stop_id);
+            session_close_at(&prev, 0, 0, 0);
+        } else {
+            // This stop closes the start, the later stop is left without one
+            session_stop_only(&added, sf->kind, prev.end_ts, prev.duration, prev.stop_id);
+            session_close_at(&prev, rec->ts, rec->duration, id);
+        }
+        return record_put(sf, index - 1, &prev) && record_insert(sf, index, &added);
+    }
+
+    if(is_start) {
+        if(has_next && next.start_id == 0) {
+            next.start_ts = rec->ts; // Start for a stop that had none
+            next.start_id = id;
+            return record_put(sf, index, &next);
+        }
+        session_open_at(&added, sf->kind, rec->ts, id);
+        return record_insert(sf, index, &added);
+    }
+
+    if(has_prev && prev.start_id && prev.end_ts == 0) {
+        session_close_at(&prev, rec->ts, rec->duration, id);
+        return record_put(sf, index - 1, &prev);
+    }
+    session_stop_only(&added, sf->kind, rec->ts, rec->duration, id);
+    return record_insert(sf, index, &added);
+}
+
+// False if the event is not in the index
+static bool remove_event(SessionFile* sf, bool is_start, const LogRecord* rec) {
+    uint32_t id = log_hash_id(rec->id);
+    uint32_t index = record_upper_bound(sf, rec->ts);
+    SessionRecord session;
+    bool found = false;
+    while(!found && index > 0) {
+        index--;
+        if(!record_get(sf, index, &session)) return false;
+        found = is_start ? session.start_id == id : session.stop_id == id;
+        if(!found && session_key(&session) < rec->ts) return false;
+    }
+    if(!found) return false;
+
+    SessionRecord other;
+    if(is_start) {
+        if(session.end_ts == 0) return record_delete(sf, index);
+        if(index > 0 && record_get(sf, index - 1, &other) && other.start_id && other.end_ts == 0) {
+            // The open start before it takes over the stop
+            session_close_at(&other, session.end_ts, session.duration, session.stop_id);
+            return record_put(sf, index - 1, &other) && record_delete(sf, index);
+        }
+        session_stop_only(&session, sf->kind, session.end_ts, session.duration, session.stop_id);
+        return record_put(sf, index, &session);
+    }
+
+    if(session.start_id == 0) return record_delete(sf, index);
+    if(record_get(sf, index + 1, &other) && other.start_id == 0) {
+        // The stop after it now closes this start
+        session_close_at(&session, other.end_ts, other.duration, other.stop_id);
+        return record_put(sf, index, &session) && record_delete(sf, index + 1);
+    }
+    session_close_at(&session, 0, 0, 0);
+    return record_put(sf, index, &session);
+}
+
+// Each kind's file is opened once for all the events of that kind
+static void update_events(AppData* app, const LogRecord* recs, int count, bool add) {
+    if(g_rebuild.running) {
+        g_rebuild.restart = true;
+        return;
+    }
+
+    bool ok = true;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    for(int kind = 0; ok && kind < SessionKindCount; kind++) {
+        SessionFile sf;
+        bool open = false;
+        for(int i = 0; ok && i < count; i++) {
+            SessionKind rec_kind;
+            bool is_start;
+            const LogRecord* rec = &recs[i];
+            if(rec->ts == 0 || !session_kind(rec->type, &rec_kind, &is_start)) continue;
+            if((int)rec_kind != kind) continue;
+            if(!open) ok = open = file_open(storage, &sf, rec_kind, false);
+            ok = ok && (add ? insert_event(&sf, is_start, rec) : remove_event(&sf, is_start, rec));
+        }
+        if(open) file_close(&sf);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    if(!ok) {
+        debug_log("log_sessions: index out of step, rebuilding");
+        log_sessions_rebuild(app);
+    }
+}
+
+void log_sessions_add(AppData* app, const LogRecord* rec) {
+    update_events(app, rec, 1, true);
+}
+
+void log_sessions_append(AppData* app, const LogRecord* rec) {
+    SessionKind kind;
+    bool is_start;
+    if(rec->ts == 0 || !session_kind(rec->type, &kind, &is_start)) return;
+    if(g_rebuild.running) {
+        update_events(app, rec, 1, true); // Restarts it
+        return;
+    }
+    if(g_sessions.queued_count == SESSIONS_QUEUE_MAX) log_sessions_checkpoint();
+    g_sessions.queued[g_sessions.queued_count++] = *rec;
+    g_sessions.app = app;
+}
+
+void log_sessions_remove(AppData* app, const LogRecord* rec) {
+    // Not indexed yet: the pairing only depends on which events there are,
+    // so dropping it from the queue is the same as removing it later
+    for(int i = 0; i < g_sessions.queued_count; i++) {
+        if(strcmp(g_sessions.queued[i].id, rec->id) != 0) continue;
+        g_sessions.queued_count--;
+        memmove(&g_sessions.queued[i], &g_sessions.queued[i + 1],
+                (g_sessions.queued_count - i) * sizeof(LogRecord));
+        return;
+    }
+    update_events(app, rec, 1, false);
+}
+
+void log_sessions_checkpoint(void) {
+    uint8_t count = g_sessions.queued_count;
+    g_sessions.queued_count = 0;
+    if(count) update_events(g_sessions.app, g_sessions.queued, count, true);
+}
+
+// ==== REBUILD ====
+// The history is paired the same way as the export and written out in
+// order; both files stay marked dirty until the last record is written.
+
+static bool file_create(Storage* storage, SessionKind kind, uint32_t flags) {
+    uint8_t header[SESSIONS_HEADER_SIZE];
+    memcpy(header, SESSIONS_MAGIC, 4);
+    log_put_u32(header + 4, flags);
+
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, session_path(kind), FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+              storage_file_write(file, header, SESSIONS_HEADER_SIZE) == SESSIONS_HEADER_SIZE;
+    storage_file_close(file);
+    storage_file_free(file);
+    return ok;
+}
+
+static void rebuild_close(void) {
+    for(int kind = 0; kind < SessionKindCount; kind++) {
+        if(!g_rebuild.out[kind]) continue;
+        buffered_file_stream_close(g_rebuild.out[kind]);
+        stream_free(g_rebuild.out[kind]);
+        g_rebuild.out[kind] = NULL;
+    }
+    log_history_close(&g_rebuild.history);
+    g_rebuild.running = false;
+}
+
+static bool rebuild_emit(SessionKind kind, const SessionRecord* session) {
+    uint8_t data[SESSIONS_RECORD_SIZE];
+    log_sessions_encode(session, data);
+    return stream_write(g_rebuild.out[kind], data, SESSIONS_RECORD_SIZE) == SESSIONS_RECORD_SIZE;
+}
+
+static bool rebuild_event(const LogRecord* rec) {
+    SessionKind kind;
+    bool is_start;
+    if(rec->ts == 0 || !session_kind(rec->type, &kind, &is_start)) return true;
+    if(log_is_deleted(rec->id)) return true;
+
+    SessionRecord* pending = &g_rebuild.pending[kind];
+    uint32_t id = log_hash_id(rec->id);
+    if(is_start) {
+        bool ok = !g_rebuild.open[kind] || rebuild_emit(kind, pending); // Left open
+        session_open_at(pending, kind, rec->ts, id);
+        g_rebuild.open[kind] = true;
+        return ok;
+    }
+    if(g_rebuild.open[kind] && pending->start_ts <= rec->ts) {
+        session_close_at(pending, rec->ts, rec->duration, id);
+        g_rebuild.open[kind] = false;
+        return rebuild_emit(kind, pending);
+    }
+    SessionRecord orphan;
+    session_stop_only(&orphan, kind, rec->ts, rec->duration, id);
+    return rebuild_emit(kind, &orphan);
+}
+
+static void rebuild_finish(AppData* app, bool ok) {
+    for(int kind = 0; ok && kind < SessionKindCount; kind++) {
+        if(g_rebuild.open[kind]) ok = rebuild_emit((SessionKind)kind, &g_rebuild.pending[kind]);
+    }
+    rebuild_close();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    for(int kind = 0; ok && kind < SessionKindCount; kind++) {
+        SessionFile sf;
+        ok = file_open(storage, &sf, (SessionKind)kind, true);
+        if(ok) {
+            ok = file_mark(&sf, false);
+            file_close(&sf);
+        }
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    app->sessions_status = ok ? JobDone : JobFailed;
+    debug_log(ok ? "log_sessions: rebuilt" : "log_sessions: rebuild failed");
+}
+
+void log_sessions_rebuild(AppData* app) {
+    debug_log("log_sessions_rebuild: start");
+    if(g_rebuild.running) rebuild_close();
+    memset(&g_rebuild, 0, sizeof(g_rebuild));
+    memset(&g_sessions, 0, sizeof(g_sessions));
+
+    log_tombstones_load();
+    log_history_open(&g_rebuild.history); // A missing log rebuilds an empty index
+    g_rebuild.running = true;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, LOG_DIR);
+    bool ok = true;
+    for(int kind = 0; ok && kind < SessionKindCount; kind++) {
+        ok = file_create(storage, (SessionKind)kind, SESSIONS_DIRTY);
+        g_rebuild.out[kind] = buffered_file_stream_alloc(storage);
+        ok = ok && buffered_file_stream_open(
+                       g_rebuild.out[kind], session_path(kind), FSAM_WRITE, FSOM_OPEN_APPEND);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    if(!ok) {
+        rebuild_close();
+        app->sessions_status = JobFailed;
+        debug_log("log_sessions_rebuild: open failed");
+        return;
+    }
+    app->sessions_status = JobRunning;
+}
+
+bool log_sessions_step(AppData* app) {
+    if(app->sessions_status != JobRunning) return false;
+    if(g_rebuild.restart) {
+        log_sessions_rebuild(app);
+        return app->sessions_status == JobRunning;
+    }
+
+    for(int i = 0; i < SESSIONS_RECORDS_PER_STEP; i++) {
+        const LogRecord* rec = log_history_next(&g_rebuild.history);
+        if(!rec) {
+            rebuild_finish(app, true);
+            return false;
+        }
+        if(!rebuild_event(rec)) {
+            rebuild_finish(app, false);
+            return false;
+        }
+    }
+    return true;
+}
+
+void log_sessions_cancel(AppData* app) {
+    if(!g_rebuild.running) return;
+    rebuild_close();
+    app->sessions_status = JobCancelled;
+    debug_log("log_sessions: rebuild cancelled");
+}
+
+// ==== LOAD / CLEAR ====
+
+void log_sessions_load(AppData* app) {
+    log_sessions_cancel(app); // A rebuild for the previous child
+    memset(&g_sessions, 0, sizeof(g_sessions));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool ok = true;
+    for(int kind = 0; ok && kind < SessionKindCount; kind++) {
+        SessionFile sf;
+        ok = file_open(storage, &sf, (SessionKind)kind, false);
+        if(ok) file_close(&sf);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    if(ok) {
+        app->sessions_status = JobIdle;
+    } else {
+        log_sessions_rebuild(app);
+    }
+}
+
+void log_sessions_clear(AppData* app) {
+    log_sessions_cancel(app);
+    memset(&g_sessions, 0, sizeof(g_sessions));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, LOG_DIR);
+    bool ok = true;
+    for(int kind = 0; kind < SessionKindCount; kind++) {
+        ok = file_create(storage, (SessionKind)kind, 0) && ok;
+    }
+    furi_record_close(RECORD_STORAGE);
+    app->sessions_status = ok ? JobIdle : JobFailed;
+}
+
+// ==== QUERIES ====
+// While a rebuild runs the index reads as empty
+
+uint32_t log_sessions_count(SessionKind kind) {
+    if(g_rebuild.running) return 0;
+    log_sessions_checkpoint();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    SessionFile sf;
+    uint32_t count = 0;
+    if(file_open(storage, &sf, kind, false)) {
+        count = sf.count;
+        file_close(&sf);
+    }
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
+
+uint32_t log_sessions_read(SessionKind kind, uint32_t first, SessionRecord* out, uint32_t max) {
+    if(g_rebuild.running) return 0;
+    log_sessions_checkpoint();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    SessionFile sf;
+    uint32_t n = 0;
+    if(file_open(storage, &sf, kind, false)) {
+        if(first < sf.count) {
+            n = (sf.count - first < max) ? sf.count - first : max;
+            size_t size = n * SESSIONS_RECORD_SIZE;
+            if(!file_seek(&sf, first) || storage_file_read(sf.file, out, size) != size) n = 0;
+            // Same size, so each record decodes over its own bytes
+            for(uint32_t i = 0; i < n; i++) {
+                SessionRecord session;
+                log_sessions_decode((const uint8_t*)&out[i], &session);
+                out[i] = session;
+            }
+        }
+        file_close(&sf);
+    }
+    furi_record_close(RECORD_STORAGE);
+    return n;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+#include "log_codec.h"
+
+// ==== SESSION INDEX ====
+// Feeds and sleeps are logged as separate start and stop events. The index
+// pairs them once, as they are logged, into fixed-size records in one file
+// per kind, so the N-th session is a single seek and a time lookup is a
+// binary search. Records are in event order: sorted by their first event
+// (the start, or the stop for a session whose start is missing).
+// Pairing matches the export: a stop closes the start right before it;
+// a start followed by another start stays open; a stop without a start
+// gets its start from its duration.
+// Adds, deletes, undo/redo, past events and edits update only the records
+// next to the event. Live events wait in memory and are indexed
+// SESSIONS_QUEUE_MAX at a time, before the index is read, and with the
+// other derived tables (log_tables.h). A missing file, one left dirty by
+// power loss, a set not closed cleanly, or an import starts a rebuild from
+// the whole history, run in steps by the main loop; until it finishes the
+// index reads as empty.
+
+#define SESSIONS_FEED_PATH (child_paths()->sessions_feed)
+#define SESSIONS_SLEEP_PATH (child_paths()->sessions_sleep)
+
+typedef enum {
+    SessionFeeding = 0,
+    SessionSleep,
+    SessionKindCount,
+} SessionKind;
+
+// IDs are 32-bit hashes (log_hash_id), like the tombstone set. On the card
+// each record is SESSIONS_RECORD_SIZE bytes: the five fields as
+// little-endian u32 in this order, then type and three zero bytes.
+typedef struct {
+    uint32_t start_ts; // Derived from the duration when start_id is 0
+    uint32_t end_ts; // 0 while the session is open
+    uint32_t duration; // As logged on the stop event
+    uint32_t start_id; // 0 = no start event
+    uint32_t stop_id; // 0 = no stop event yet
+    uint8_t type; // LogEventFeedingStart or LogEventSleepStart
+    uint8_t reserved[3];
+} SessionRecord;
+
+#define SESSIONS_RECORD_SIZE 24
+
+// log_sessions_read() decodes in place
+_Static_assert(sizeof(SessionRecord) == SESSIONS_RECORD_SIZE, "SessionRecord must fit its record");
+
+void log_sessions_encode(const SessionRecord* session, uint8_t* out); // SESSIONS_RECORD_SIZE bytes
+void log_sessions_decode(const uint8_t* in, SessionRecord* session);
+
+void log_sessions_load(AppData* app); // After child paths change; rebuilds if needed
+void log_sessions_add(AppData* app, const LogRecord* rec);
+void log_sessions_append(AppData* app, const LogRecord* rec); // Its line went to the append buffer
+void log_sessions_remove(AppData* app, const LogRecord* rec);
+void log_sessions_clear(AppData* app); // Log cleared - empty index
+void log_sessions_checkpoint(void); // Index the queued events; called by log_tables_save()
+
+void log_sessions_rebuild(AppData* app);
+bool log_sessions_step(AppData* app); // Returns true while work remains
+void log_sessions_cancel(AppData* app); // Files stay dirty, rebuilt on the next load
+
+uint32_t log_sessions_count(SessionKind kind);
+uint32_t log_sessions_read(SessionKind kind, uint32_t first, SessionRecord* out, uint32_t max); // Sessions read
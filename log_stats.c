@@ -0,0 +1,248 @@
+#include "log_stats.h"
+#include "log_store.h"
+#include "log_sessions.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <furi.h>
+#include <string.h>
+
+#define STATS_MAGIC "BLS1"
+#define STATS_EWMA_SHIFT 2 // Weight of a new sample is 1/4
+#define STATS_MEDIAN_MIN 3 // Fewer samples fall back to the EWMA
+#define STATS_RECORDS_PER_STEP 16 // Session records read per rebuild step
+
+// Statistics changed since the last save of the derived tables, written by
+// log_stats_checkpoint() (see log_tables.h)
+static struct {
+    bool pending;
+    LogStats stats;
+} g_stats;
+
+// Rebuild from the session index, stepped by the main loop
+static struct {
+    LogStats stats;
+    SessionKind kind; // Series being read
+    uint32_t next; // Next record of that kind
+    bool restart; // An event was logged meanwhile
+} g_rebuild;
+
+// ==== SERIES ====
+
+static void series_add(IntervalStats* stats, uint32_t sample) {
+    if(stats->count == 0) {
+        stats->ewma = sample;
+    } else {
+        int32_t delta = (int32_t)sample - (int32_t)stats->ewma;
+        stats->ewma = (uint32_t)((int32_t)stats->ewma + delta / (1 << STATS_EWMA_SHIFT));
+    }
+
+    // Window: replace the oldest sample once full
+    uint8_t n = stats->count;
+    if(n == STATS_WINDOW) {
+        uint32_t evicted = stats->window[stats->head];
+        stats->window[stats->head] = sample;
+        stats->head = (stats->head + 1) % STATS_WINDOW;
+
+        uint8_t i = 0;
+        while(i < n - 1 && stats->sorted[i] != evicted) i++;
+        memmove(&stats->sorted[i], &stats->sorted[i + 1], (n - 1 - i) * sizeof(uint32_t));
+        n--;
+    } else {
+        stats->window[n] = sample;
+        stats->count++;
+    }
+
+    // Sorted copy: one insertion step
+    uint8_t i = n;
+    while(i > 0 && stats->sorted[i - 1] > sample) {
+        stats->sorted[i] = stats->sorted[i - 1];
+        i--;
+    }
+    stats->sorted[i] = sample;
+}
+
+uint32_t log_stats_percentile(const IntervalStats* stats, uint8_t percent) {
+    if(stats->count == 0) return 0;
+    if(percent > 100) percent = 100;
+    return stats->sorted[(stats->count - 1) * percent / 100];
+}
+
+uint32_t log_stats_typical(const IntervalStats* stats) {
+    if(stats->count < STATS_MEDIAN_MIN) return stats->ewma;
+    return log_stats_percentile(stats, 50);
+}
+
+// Returns true if the statistics changed
+static bool stats_apply(LogStats* stats, LogEventType type, uint32_t ts, uint32_t duration) {
+    if(type == LogEventFeedingStart) {
+        if(stats->last_feed_ts == 0 || ts < stats->last_feed_ts) {
+            stats->last_feed_ts = ts;
+            return true;
+        }
+        uint32_t gap = ts - stats->last_feed_ts;
+        if(gap < STATS_FEED_MIN) return false;
+        if(gap <= STATS_FEED_MAX) series_add(&stats->feed, gap);
+        stats->last_feed_ts = ts;
+        return true;
+    }
+    if(type == LogEventSleepStop) {
+        if(duration < STATS_SLEEP_MIN || duration > STATS_SLEEP_MAX) return false;
+        series_add(&stats->sleep, duration);
+        return true;
+    }
+    return false;
+}
+
+// ==== PERSISTENCE ====
+
+static bool stats_write(const LogStats* stats) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, STATS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        ok = storage_file_write(file, STATS_MAGIC, 4) == 4 &&
+             storage_file_write(file, stats, sizeof(LogStats)) == sizeof(LogStats);
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    if(!ok) debug_log("log_stats: save failed");
+    return ok;
+}
+
+static bool stats_read(LogStats* stats) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool ok = false;
+    if(storage_file_open(file, STATS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        char magic[4];
+        ok = storage_file_size(file) == 4 + sizeof(LogStats) &&
+             storage_file_read(file, magic, 4) == 4 && memcmp(magic, STATS_MAGIC, 4) == 0 &&
+             storage_file_read(file, stats, sizeof(LogStats)) == sizeof(LogStats);
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return ok && stats->feed.count <= STATS_WINDOW && stats->feed.head < STATS_WINDOW &&
+           stats->sleep.count <= STATS_WINDOW && stats->sleep.head < STATS_WINDOW;
+}
+
+static void stats_save(const AppData* app) {
+    g_stats.stats = app->stats;
+    g_stats.pending = true;
+}
+
+bool log_stats_checkpoint(void) {
+    if(!g_stats.pending) return true;
+    g_stats.pending = false;
+    return stats_write(&g_stats.stats);
+}
+
+// ==== UPDATES ====
+
+// Feed starts and sleep stops are the only events that feed a series
+static bool stats_counts(LogEventType type) {
+    return type == LogEventFeedingStart || type == LogEventSleepStop;
+}
+
+// The statistics stay as they were until the rebuild finishes; stats.bin
+// is removed so a rebuild cut short by exit or power loss runs again
+void log_stats_rebuild(AppData* app) {
+    debug_log("log_stats_rebuild: start");
+    memset(&g_rebuild, 0, sizeof(g_rebuild));
+    g_stats.pending = false;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, STATS_PATH);
+    furi_record_close(RECORD_STORAGE);
+    app->stats_status = JobRunning;
+}
+
+// A feed interval needs the start event, a sleep length the stop
+static void rebuild_session(const SessionRecord* session) {
+    if(session->type == LogEventFeedingStart) {
+        if(session->start_id != 0) {
+            stats_apply(&g_rebuild.stats, LogEventFeedingStart, session->start_ts, 0);
+        }
+    } else if(session->stop_id != 0) {
+        stats_apply(&g_rebuild.stats, LogEventSleepStop, session->end_ts, session->duration);
+    }
+}
+
+bool log_stats_step(AppData* app) {
+    if(app->stats_status != JobRunning) return false;
+    if(app->sessions_status == JobRunning) return true; // Index reads as empty until then
+    if(app->sessions_status == JobFailed || app->sessions_status == JobCancelled) {
+        app->stats_status = JobFailed;
+        debug_log("log_stats_rebuild: no session index");
+        return false;
+    }
+    if(g_rebuild.restart) memset(&g_rebuild, 0, sizeof(g_rebuild));
+
+    ScratchMark mark = scratch_mark();
+    SessionRecord* records = scratch_alloc(STATS_RECORDS_PER_STEP * sizeof(SessionRecord));
+    uint32_t n = log_sessions_read(g_rebuild.kind, g_rebuild.next, records, STATS_RECORDS_PER_STEP);
+    for(uint32_t i = 0; i < n; i++) rebuild_session(&records[i]);
+    scratch_release(mark);
+    g_rebuild.next += n;
+    if(n == STATS_RECORDS_PER_STEP) return true;
+    if(g_rebuild.kind == SessionFeeding) {
+        g_rebuild.kind = SessionSleep;
+        g_rebuild.next = 0;
+        return true;
+    }
+
+    app->stats = g_rebuild.stats;
+    app->stats_status = JobDone;
+    stats_save(app);
+    debug_log("log_stats_rebuild: done");
+    return false;
+}
+
+void log_stats_cancel(AppData* app) {
+    if(app->stats_status != JobRunning) return;
+    app->stats_status = JobCancelled; // stats.bin stays missing, rebuilt on the next load
+    debug_log("log_stats_rebuild: cancelled");
+}
+
+void log_stats_load(AppData* app) {
+    g_stats.pending = false;
+    app->stats_status = JobIdle;
+    if(stats_read(&app->stats)) return;
+    memset(&app->stats, 0, sizeof(LogStats)); // First run or damaged file
+    log_stats_rebuild(app);
+}
+
+void log_stats_add(AppData* app, LogEventType type, uint32_t ts, uint32_t duration) {
+    if(!stats_apply(&app->stats, type, ts, duration)) return;
+    if(app->stats_status == JobRunning) {
+        g_rebuild.restart = true; // Shown now, counted by the rebuild
+        return;
+    }
+    stats_save(app);
+}
+
+void log_stats_changed(AppData* app, LogEventType type) {
+    if(stats_counts(type)) log_stats_rebuild(app);
+}
+
+void log_stats_clear(AppData* app) {
+    memset(&app->stats, 0, sizeof(LogStats));
+    app->stats_status = JobIdle;
+    g_stats.pending = false;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, STATS_PATH);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// ==== FORECAST ====
+
+uint32_t log_stats_next_feed(const AppData* app) {
+    const LogStats* stats = &app->stats;
+    if(stats->last_feed_ts == 0 || stats->feed.count == 0) return 0;
+    return stats->last_feed_ts + log_stats_typical(&stats->feed);
+}
+
+uint32_t log_stats_wake_at(const AppData* app) {
+    if(!app->state.sleep_active || app->stats.sleep.count == 0) return 0;
+    return app->state.sleep_start_ts + log_stats_typical(&app->stats.sleep);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+
+// ==== INTERVAL STATISTICS ====
+// Rolling statistics of feed intervals (start to next start) and sleep
+// lengths, updated in O(1) as events are logged and kept in stats.bin, so
+// the next-feed forecast on the main screen never scans the history.
+// Each series has an EWMA and a window of the newest STATS_WINDOW samples,
+// held both in arrival order and sorted for median and percentiles.
+// Taking out or bringing back a feed start or sleep stop (delete, undo,
+// redo, edit, past event) can change any sample, so it rebuilds them from
+// the session index (log_sessions.h), which holds every feed and sleep in
+// time order; so do an import and a missing stats.bin. The rebuild runs in
+// steps from the main loop and the forecast keeps its old value until then.
+// Kept in stats.bin, written with the other derived tables (log_tables.h);
+// one not closed cleanly is rebuilt like a missing one.
+
+#define STATS_PATH (child_paths()->stats)
+
+#define STATS_FEED_MIN (15 * 60) // Shorter gaps continue the same feed
+#define STATS_FEED_MAX (8 * 3600) // Longer gaps are missed logs, not rhythm
+#define STATS_SLEEP_MIN 60
+#define STATS_SLEEP_MAX (16 * 3600)
+
+void log_stats_load(AppData* app); // After log_load_recent()
+void log_stats_rebuild(AppData* app); // Log replaced (import)
+bool log_stats_step(AppData* app); // Returns true while work remains
+void log_stats_cancel(AppData* app); // Rebuilt on the next load
+void log_stats_add(AppData* app, LogEventType type, uint32_t ts, uint32_t duration);
+void log_stats_changed(AppData* app, LogEventType type); // An event of this type left or rejoined the log
+void log_stats_clear(AppData* app);
+bool log_stats_checkpoint(void); // Called by log_tables_save()
+
+uint32_t log_stats_percentile(const IntervalStats* stats, uint8_t percent); // 0 = no samples
+uint32_t log_stats_typical(const IntervalStats* stats); // Median, EWMA while samples are few
+
+uint32_t log_stats_next_feed(const AppData* app); // Timestamp, 0 = unknown
+uint32_t log_stats_wake_at(const AppData* app); // While sleeping, 0 = unknown
@@ -1,22 +1,38 @@
-#include "app_state.h"
+#include "log_store.h"
+#include "log_codec.h"
+#include "log_reader.h"
+#include "log_archive.h"
+#include "log_patch.h"
+#include "log_check.h"
+#include "log_stats.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "diag.h"
+#include "scratch.h"
+#include "clock.h"
 #include <storage/storage.h>
 #include <stream/stream.h>
 #include <stream/buffered_file_stream.h>
 #include <furi.h>
-#include <furi_hal_rtc.h>
 #include <string.h>
 
-#define LOG_PATH EXT_PATH("apps/baby_log/log.jsonl")
-#define DELETED_PATH EXT_PATH("apps/baby_log/deleted.jsonl")
-#define DEBUG_PATH EXT_PATH("apps/baby_log/debug.log")
-
 // ==== DEBUG LOGGING ====
-// Write debug message to file for crash investigation
-static void debug_log(const char* msg) {
+// Write debug message to file for crash investigation. Release builds
+// collect the lines in one sector and write it when it fills and with the
+// derived tables (log_tables.h); debug builds write each line at once so
+// the last one before a crash is on the card.
+static struct {
+    char buffer[LOG_SECTOR_SIZE];
+    size_t fill;
+} g_debug;
+
+void debug_log_flush(void) {
+    if(g_debug.fill == 0) return;
     Storage* storage = furi_record_open(RECORD_STORAGE);
     if(!storage) return;
     
-    storage_common_mkdir(storage, EXT_PATH("apps/baby_log"));
+    storage_common_mkdir(storage, CHILD_ROOT_DIR);
     
     Stream* stream = buffered_file_stream_alloc(storage);
     if(!stream) {
@@ -25,176 +41,567 @@ static void debug_log(const char* msg) {
     }
     
     if(buffered_file_stream_open(stream, DEBUG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        stream_write(stream, (uint8_t*)msg, strlen(msg));
-        stream_write(stream, (uint8_t*)"\n", 1);
+        stream_write(stream, (uint8_t*)g_debug.buffer, g_debug.fill);
         buffered_file_stream_close(stream);
     }
+    g_debug.fill = 0; // Dropped if the write failed: there is nowhere to report it
     
     stream_free(stream);
     furi_record_close(RECORD_STORAGE);
 }
 
+void debug_log(const char* msg) {
+    size_t len = strlen(msg);
+    if(len >= sizeof(g_debug.buffer)) len = sizeof(g_debug.buffer) - 1;
+    if(g_debug.fill + len + 1 > sizeof(g_debug.buffer)) debug_log_flush();
+    memcpy(g_debug.buffer + g_debug.fill, msg, len);
+    g_debug.buffer[g_debug.fill + len] = '\n';
+    g_debug.fill += len + 1;
+#ifdef FURI_DEBUG
+    debug_log_flush();
+#endif
+}
+
+// Last ID seed handed out - events logged in the same second (e.g. sleep stop
+// + feeding start on one keypress) must still get distinct IDs
+static uint32_t g_last_id_seed = 0;
+
 // Generate a simple hex ID from timestamp
 static void generate_id(uint32_t ts, char* id_out) {
-    snprintf(id_out, 33, "%08lx%08lx", (unsigned long)ts, (unsigned long)(ts * 1103515245 + 12345));
+    uint32_t seed = (ts > g_last_id_seed) ? ts : g_last_id_seed + 1;
+    g_last_id_seed = seed;
+    log_format_id(seed, id_out);
+}
+
+// ==== TOMBSTONES ====
+// Deleted IDs are kept as 32-bit hashes so the set has a fixed RAM cost.
+// Rotation drops deleted records from log.jsonl and the set is compacted
+// after it (see TOMBSTONE COMPACTION), so it only holds deletes the log
+// still contains. A delete that does not fit is refused, never dropped.
+static uint32_t g_tombstones[LOG_TOMBSTONE_MAX];
+static uint32_t g_tombstone_dropped[LOG_TOMBSTONE_MAX / 32]; // By slot: record left out by rotation
+static int g_tombstone_count = 0;
+static bool g_tombstone_overflow = false; // The journal holds more deletes than fit
+
+static int tombstone_find(uint32_t hash) {
+    for(int i = 0; i < g_tombstone_count; i++) {
+        if(g_tombstones[i] == hash) return i;
+    }
+    return -1;
+}
+
+static bool tombstone_is_dropped(int slot) {
+    return g_tombstone_dropped[slot / 32] & (1u << (slot % 32));
+}
+
+static void tombstone_set_dropped(int slot, bool dropped) {
+    if(dropped) {
+        g_tombstone_dropped[slot / 32] |= 1u << (slot % 32);
+    } else {
+        g_tombstone_dropped[slot / 32] &= ~(1u << (slot % 32));
+    }
+}
+
+static void tombstone_add(const char* id) {
+    if(log_is_deleted(id)) return;
+    if(g_tombstone_count >= LOG_TOMBSTONE_MAX) {
+        g_tombstone_overflow = true;
+        debug_log("tombstone_add: set full");
+        return;
+    }
+    tombstone_set_dropped(g_tombstone_count, false);
+    g_tombstones[g_tombstone_count++] = log_hash_id(id);
+}
+
+static void tombstone_remove(const char* id) {
+    int slot = tombstone_find(log_hash_id(id));
+    if(slot < 0) return;
+    int last = --g_tombstone_count;
+    g_tombstones[slot] = g_tombstones[last];
+    tombstone_set_dropped(slot, tombstone_is_dropped(last));
+}
+
+bool log_is_deleted(const char* id) {
+    if(!id || id[0] == '\0') return false;
+    return tombstone_find(log_hash_id(id)) >= 0;
+}
+
+int log_tombstone_count(void) {
+    return g_tombstone_count;
+}
+
+bool log_tombstones_full(void) {
+    return g_tombstone_count >= LOG_TOMBSTONE_MAX || g_tombstone_overflow;
+}
+
+bool log_tombstone_drop(const char* id) {
+    if(!id || id[0] == '\0') return false;
+    int slot = tombstone_find(log_hash_id(id));
+    if(slot < 0) return false;
+    tombstone_set_dropped(slot, true);
+    return true;
+}
+
+// Replay a deleted.jsonl journal into the tombstone set (adds to what is loaded)
+void log_tombstones_add_file(const char* path) {
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    if(!log_reader_open(&reader, path)) return;
+
+    const char* line;
+    char id[LOG_ID_LEN + 1];
+    while((line = log_reader_next(&reader)) != NULL) {
+        if(!log_line_check(line) || !log_parse_id(line, id)) continue;
+        if(log_parse_op(line) == JournalOpRestore) {
+            tombstone_remove(id);
+        } else {
+            tombstone_add(id);
+        }
+    }
+    log_reader_close(&reader);
+}
+
+// Reload the tombstone set from deleted.jsonl
+void log_tombstones_load(void) {
+    g_tombstone_count = 0;
+    g_tombstone_overflow = false;
+    memset(g_tombstone_dropped, 0, sizeof(g_tombstone_dropped));
+    log_tombstones_add_file(DELETED_PATH);
+}
+
+// ==== TOMBSTONE COMPACTION ====
+// Once a swapped-in rotation has left a deleted record out of log.jsonl,
+// nothing local can bring it back: its lines leave deleted.jsonl and its
+// hash leaves RAM. The hash moves to tombstones.bin (sorted u32s), which
+// only an import reads, as the other device may still have the record.
+
+static int hash_compare(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Merge the sorted dropped hashes into tombstones.bin through its .tmp
+static bool compact_archive(Storage* storage, const uint32_t* dropped, int count) {
+    File* in = storage_file_alloc(storage);
+    File* out = storage_file_alloc(storage);
+    bool has_in = storage_file_open(in, TOMBSTONES_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    bool ok = storage_file_open(out, TOMBSTONES_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    uint32_t hash = 0;
+    bool have = has_in && storage_file_read(in, &hash, 4) == 4;
+    int i = 0;
+    uint32_t prev = 0;
+    bool first = true;
+    while(ok && (have || i < count)) {
+        uint32_t next;
+        if(have && (i == count || hash <= dropped[i])) {
+            next = hash;
+            have = storage_file_read(in, &hash, 4) == 4;
+        } else {
+            next = dropped[i++];
+        }
+        if(!first && next == prev) continue;
+        ok = storage_file_write(out, &next, 4) == 4;
+        prev = next;
+        first = false;
+    }
+    storage_file_close(in);
+    storage_file_close(out);
+    storage_file_free(in);
+    storage_file_free(out);
+
+    if(ok) {
+        storage_common_remove(storage, TOMBSTONES_PATH);
+        ok = storage_common_rename(storage, TOMBSTONES_TMP_PATH, TOMBSTONES_PATH) == FSE_OK;
+    }
+    if(!ok) storage_common_remove(storage, TOMBSTONES_TMP_PATH);
+    return ok;
+}
+
+// Copy deleted.jsonl without the lines of dropped records
+static bool compact_journal(Storage* storage, const uint32_t* dropped, int count) {
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    if(!log_reader_open(&reader, DELETED_PATH)) return false;
+
+    Stream* out = buffered_file_stream_alloc(storage);
+    bool ok = buffered_file_stream_open(out, DELETED_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    const char* line;
+    char id[LOG_ID_LEN + 1];
+    while(ok && (line = log_reader_next(&reader)) != NULL) {
+        if(log_line_check(line) && log_parse_id(line, id)) {
+            uint32_t hash = log_hash_id(id);
+            if(bsearch(&hash, dropped, count, sizeof(uint32_t), hash_compare)) continue;
+        }
+        size_t len = strlen(line);
+        ok = stream_write(out, (const uint8_t*)line, len) == len &&
+             stream_write(out, (const uint8_t*)"\n", 1) == 1;
+    }
+    log_reader_close(&reader);
+    buffered_file_stream_close(out);
+    stream_free(out);
+
+    if(ok) {
+        storage_common_remove(storage, DELETED_PATH);
+        ok = storage_common_rename(storage, DELETED_TMP_PATH, DELETED_PATH) == FSE_OK;
+    }
+    if(!ok) storage_common_remove(storage, DELETED_TMP_PATH);
+    return ok;
 }
 
-// Add ID to deleted list
-static void mark_deleted(const char* id) {
-    if(!id || id[0] == '\0' || strlen(id) > 32) return;
+// After log_swap_in() of a rotation that went through log_tombstone_drop()
+void log_tombstones_compact(void) {
+    uint32_t dropped[LOG_TOMBSTONE_MAX];
+    int count = 0;
+    for(int i = 0; i < g_tombstone_count; i++) {
+        if(tombstone_is_dropped(i)) dropped[count++] = g_tombstones[i];
+    }
+    if(count == 0) return;
+    debug_log("log_tombstones_compact: start");
+    qsort(dropped, count, sizeof(uint32_t), hash_compare);
+
+    // Archive first: a cut here leaves the hash in both, which is harmless
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool ok = compact_archive(storage, dropped, count) && compact_journal(storage, dropped, count);
+    furi_record_close(RECORD_STORAGE);
+
+    log_tombstones_load();
+    debug_log(ok ? "log_tombstones_compact: done" : "log_tombstones_compact: failed");
+}
+
+static struct {
+    File* file;
+    uint32_t count;
+} g_archived;
+
+bool log_tombstones_archive_open(void) {
+    log_tombstones_archive_close();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    g_archived.file = storage_file_alloc(storage);
+    bool ok = storage_file_open(g_archived.file, TOMBSTONES_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    furi_record_close(RECORD_STORAGE);
+    if(!ok) {
+        log_tombstones_archive_close();
+        return false;
+    }
+    g_archived.count = (uint32_t)(storage_file_size(g_archived.file) / 4);
+    return true;
+}
+
+// Binary search of tombstones.bin, a handful of 4-byte reads
+bool log_tombstone_archived(const char* id) {
+    if(!g_archived.file || !id || id[0] == '\0') return false;
+    uint32_t hash = log_hash_id(id);
+    uint32_t low = 0;
+    uint32_t high = g_archived.count;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t value;
+        if(!storage_file_seek(g_archived.file, mid * 4, true) ||
+           storage_file_read(g_archived.file, &value, 4) != 4) {
+            return false;
+        }
+        if(value == hash) return true;
+        if(value < hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+void log_tombstones_archive_close(void) {
+    if(g_archived.file) {
+        storage_file_close(g_archived.file);
+        storage_file_free(g_archived.file);
+    }
+    g_archived.file = NULL;
+    g_archived.count = 0;
+}
+
+// Append one operation to the deleted.jsonl journal
+static bool journal_write(JournalOp op, const LogRecord* rec) {
+    if(rec->id[0] == '\0') return false;
+    if(op == JournalOpDelete && log_tombstones_full() && !log_is_deleted(rec->id)) {
+        debug_log("journal_write: tombstones full");
+        return false;
+    }
     
-    debug_log("mark_deleted: start");
+    debug_log("journal_write: start");
     
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    if(!storage) return;
+    if(!storage) return false;
     
-    storage_common_mkdir(storage, EXT_PATH("apps/baby_log"));
+    storage_common_mkdir(storage, LOG_DIR);
     
     Stream* stream = buffered_file_stream_alloc(storage);
     if(!stream) {
         furi_record_close(RECORD_STORAGE);
-        return;
+        return false;
     }
     
+    bool ok = false;
     if(buffered_file_stream_open(stream, DELETED_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        char buffer[64]; // Small buffer
-        int written = snprintf(buffer, sizeof(buffer), "{\"id\":\"%s\"}\n", id);
-        if(written > 0 && written < (int)sizeof(buffer)) {
-            stream_write(stream, (uint8_t*)buffer, written);
-        }
+        ScratchMark mark = scratch_mark();
+        char* buffer = scratch_alloc(LOG_LINE_MAX + 16);
+        int written = log_format_journal(op, rec, buffer, LOG_LINE_MAX + 16);
+        ok = written > 0 && stream_write(stream, (uint8_t*)buffer, written) == (size_t)written;
+        scratch_release(mark);
         buffered_file_stream_close(stream);
     }
     
     stream_free(stream);
     furi_record_close(RECORD_STORAGE);
-    debug_log("mark_deleted: done");
+    
+    if(ok) {
+        if(op == JournalOpDelete) {
+            tombstone_add(rec->id);
+        } else {
+            tombstone_remove(rec->id);
+        }
+    }
+    debug_log("journal_write: done");
+    return ok;
 }
 
-// Get current timestamp (Unix epoch seconds)
-uint32_t log_get_timestamp(void) {
-    DateTime datetime;
-    furi_hal_rtc_get_datetime(&datetime);
-    
-    uint32_t days = 0;
-    uint32_t year = datetime.year;
-    uint32_t month = datetime.month;
-    uint32_t day = datetime.day;
-    
-    days = (year - 1970) * 365 + (year - 1969) / 4;
-    days += (month - 1) * 30;
-    days += day - 1;
-    
-    return days * 86400 + datetime.hour * 3600 + datetime.minute * 60 + datetime.second;
+// ==== RECENT RING ====
+// The newest MAX_LOG_ENTRIES live events are kept in AppData. It is seeded
+// from the log tail once, then kept current by add/delete so the Recent Log
+// screen and Delete last never touch the SD card.
+
+static void recent_clear(AppData* app) {
+    app->log_generation++;
+    app->log_head = 0;
+    app->log_count = 0;
+    for(int i = 0; i < MAX_LOG_ENTRIES; i++) {
+        app->log_entries[i].id = 0;
+        app->log_entries[i].foreign = 0;
+        app->log_entries[i].type = LogEventDiaper;
+        app->log_entries[i].timestamp = 0;
+        app->log_entries[i].duration = 0;
+    }
+}
+
+// ==== PACKED ENTRIES ====
+// A LogEntry keeps the ID as its seed (see log_format_id). Foreign IDs -
+// hand-edited or from another tool, nothing this app writes - only keep
+// their hash, and are looked up again on the card when a delete or edit
+// needs the string.
+
+static void entry_id_set(LogEntry* entry, const char* id) {
+    uint32_t seed;
+    if(log_id_seed(id, &seed)) {
+        entry->id = seed;
+        entry->foreign = 0;
+    } else {
+        entry->id = log_hash_id(id);
+        entry->foreign = 1;
+    }
 }
 
-// Format timestamp to string
-static void format_timestamp(uint32_t ts, char* out, size_t out_size) {
-    UNUSED(ts);
-    DateTime datetime;
-    furi_hal_rtc_get_datetime(&datetime);
-    snprintf(out, out_size, "%04u-%02u-%02uT%02u:%02u:%02u",
-        datetime.year, datetime.month, datetime.day,
-        datetime.hour, datetime.minute, datetime.second);
+static bool entry_has_id(const LogEntry* entry, const char* id) {
+    LogEntry probe;
+    entry_id_set(&probe, id);
+    return entry->id == probe.id && entry->foreign == probe.foreign;
+}
+
+static void entry_from_record(const LogRecord* rec, LogEntry* entry) {
+    entry->timestamp = rec->ts;
+    entry->type = rec->type;
+    entry->duration = (rec->duration > LOG_ENTRY_DURATION_MAX) ? LOG_ENTRY_DURATION_MAX : rec->duration;
+    entry_id_set(entry, rec->id);
+}
+
+// Find the ID string behind a foreign hash: patch overlay, journal, log
+static bool foreign_id_find(uint32_t hash, char* id_out) {
+    const LogRecord* injected;
+    for(uint8_t i = 0; (injected = log_patch_injected(i)) != NULL; i++) {
+        if(log_hash_id(injected->id) == hash) {
+            strcpy(id_out, injected->id);
+            return true;
+        }
+    }
+
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    log_append_flush();
+    const char* paths[] = {DELETED_PATH, LOG_PATH};
+    for(size_t p = 0; p < COUNT_OF(paths); p++) {
+        if(!log_reader_open(&reader, paths[p])) continue;
+        const char* line;
+        bool found = false;
+        while(!found && (line = log_reader_next(&reader)) != NULL) {
+            found = log_parse_id(line, id_out) && log_hash_id(id_out) == hash;
+        }
+        log_reader_close(&reader);
+        if(found) return true;
+    }
+    debug_log("foreign_id_find: not found");
+    return false;
+}
+
+// False if the entry has no ID or a foreign ID that is no longer on the card
+static bool entry_to_record(const LogEntry* entry, LogRecord* rec) {
+    rec->ts = entry->timestamp;
+    rec->type = entry->type;
+    rec->duration = entry->duration;
+    rec->id[0] = '\0';
+    if(entry->id == 0) return false;
+    if(entry->foreign) return foreign_id_find(entry->id, rec->id);
+    log_format_id(entry->id, rec->id);
+    return true;
+}
+
+// Append as newest, overwriting the oldest when full
+static void recent_push(AppData* app, const LogRecord* rec) {
+    app->log_generation++;
+    int slot = (app->log_head + app->log_count) % MAX_LOG_ENTRIES;
+    if(app->log_count == MAX_LOG_ENTRIES) {
+        app->log_head = (app->log_head + 1) % MAX_LOG_ENTRIES;
+    } else {
+        app->log_count++;
+    }
+
+    entry_from_record(rec, &app->log_entries[slot]);
+}
+
+LogEntry* log_recent_get(AppData* app, int index) {
+    if(index < 0 || index >= app->log_count) return NULL;
+    return &app->log_entries[(app->log_head + index) % MAX_LOG_ENTRIES];
+}
+
+// Put a restored entry back in time order; dropped if older than a full ring
+static void recent_insert(AppData* app, const LogRecord* rec) {
+    if(app->log_count == MAX_LOG_ENTRIES && rec->ts < log_recent_get(app, 0)->timestamp) return;
+    
+    recent_push(app, rec);
+    for(int i = app->log_count - 1; i > 0; i--) {
+        LogEntry* prev = log_recent_get(app, i - 1);
+        LogEntry* cur = log_recent_get(app, i);
+        if(prev->timestamp <= cur->timestamp) break;
+        LogEntry tmp = *prev;
+        *prev = *cur;
+        *cur = tmp;
+    }
+}
+
+static void recent_remove(AppData* app, const char* id) {
+    for(int i = 0; i < app->log_count; i++) {
+        if(!entry_has_id(log_recent_get(app, i), id)) continue;
+        for(int j = i; j < app->log_count - 1; j++) {
+            *log_recent_get(app, j) = *log_recent_get(app, j + 1);
+        }
+        app->log_count--;
+        app->log_generation++;
+        return;
+    }
 }
 
 // Log an event
 void log_add_event(AppData* app, LogEventType type, uint32_t duration) {
-    UNUSED(app);
-    
+    diag_begin(DiagOpAdd);
     debug_log("log_add_event: start");
     
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    storage_common_mkdir(storage, EXT_PATH("apps/baby_log"));
-    
-    Stream* stream = buffered_file_stream_alloc(storage);
-    
-    if(buffered_file_stream_open(stream, LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        uint32_t ts = log_get_timestamp();
-        char id[33];
-        generate_id(ts, id);
-        
-        char time_str[32];
-        format_timestamp(ts, time_str, sizeof(time_str));
-        
-        const char* type_str = "unknown";
-        switch(type) {
-            case LogEventDiaper: type_str = "diaper"; break;
-            case LogEventFeedingStart: type_str = "feeding_start"; break;
-            case LogEventFeedingStop: type_str = "feeding_stop"; break;
-            case LogEventSleepStart: type_str = "sleep_start"; break;
-            case LogEventSleepStop: type_str = "sleep_stop"; break;
-        }
-        
-        char buffer[128]; // Reduced from 256
-        if(duration > 0) {
-            snprintf(buffer, sizeof(buffer),
-                "{\"ts\":\"%s\",\"type\":\"%s\",\"id\":\"%s\",\"dur\":%lu}\n",
-                time_str, type_str, id, (unsigned long)duration);
-        } else {
-            snprintf(buffer, sizeof(buffer),
-                "{\"ts\":\"%s\",\"type\":\"%s\",\"id\":\"%s\"}\n",
-                time_str, type_str, id);
-        }
-        stream_write(stream, (uint8_t*)buffer, strlen(buffer));
-        buffered_file_stream_close(stream);
+    LogRecord rec;
+    rec.ts = clock_now();
+    rec.type = type;
+    rec.duration = duration;
+    generate_id(rec.ts, rec.id);
+    
+    // Buffered - reaches the card a sector at a time (see log_append.h)
+    ScratchMark mark = scratch_mark();
+    char* buffer = scratch_alloc(LOG_LINE_MAX);
+    int len = log_format_record(&rec, buffer, LOG_LINE_MAX);
+    bool ok = len > 0 && log_append(buffer, len);
+    scratch_release(mark);
+    if(ok && app) {
+        recent_push(app, &rec);
+        log_stats_add(app, type, rec.ts, duration);
+        log_sessions_append(app, &rec);
+        log_last_add(app, &rec);
     }
     
-    stream_free(stream);
-    furi_record_close(RECORD_STORAGE);
     debug_log("log_add_event: done");
+    diag_end(DiagOpAdd);
 }
 
-// Parse event type from line
-static LogEventType parse_event_type(const char* line) {
-    if(strstr(line, "\"type\":\"diaper\"")) return LogEventDiaper;
-    if(strstr(line, "\"type\":\"feeding_start\"")) return LogEventFeedingStart;
-    if(strstr(line, "\"type\":\"feeding_stop\"")) return LogEventFeedingStop;
-    if(strstr(line, "\"type\":\"sleep_start\"")) return LogEventSleepStart;
-    if(strstr(line, "\"type\":\"sleep_stop\"")) return LogEventSleepStop;
-    return LogEventDiaper; // Default
-}
+// ==== RETROACTIVE EDITS ====
+// Past events and corrections are appended to patches.jsonl (see
+// log_patch.h); log.jsonl itself is never rewritten for them.
+
+bool log_add_past_event(AppData* app, LogEventType type, uint32_t ts, uint32_t duration) {
+    debug_log("log_add_past_event: start");
+    uint32_t now = clock_now();
+
+    LogRecord rec;
+    rec.ts = (ts > now) ? now : ts;
+    rec.type = type;
+    rec.duration = duration;
+    generate_id(now, rec.id); // Seeded from now - a past ts may already be taken
 
-// Extract ID from line into buffer (max 32 chars)
-static bool extract_id(const char* line, char* id_out) {
-    const char* id_pos = strstr(line, "\"id\":\"");
-    if(!id_pos) {
-        id_out[0] = '\0';
+    if(!log_patch_write(&rec, PATCH_ADDED)) {
+        debug_log("log_add_past_event: failed");
         return false;
     }
-    id_pos += 6;
-    int i = 0;
-    while(*id_pos != '"' && *id_pos != '\0' && i < 32) {
-        id_out[i++] = *id_pos++;
+    if(app) {
+        recent_insert(app, &rec);
+        log_sessions_add(app, &rec);
+        log_last_add(app, &rec);
+        log_stats_changed(app, rec.type);
     }
-    id_out[i] = '\0';
-    return (i > 0);
+    return true;
 }
 
-// Extract duration from line
-static uint32_t extract_duration(const char* line) {
-    const char* dur_pos = strstr(line, "\"dur\":");
-    if(!dur_pos) {
-        dur_pos = strstr(line, "\"duration\":");
-        if(!dur_pos) return 0;
-        dur_pos += 11;
-    } else {
-        dur_pos += 6;
+bool log_edit_event(AppData* app, const LogEntry* edited) {
+    debug_log("log_edit_event: start");
+    LogEntry* current = NULL;
+    for(int i = 0; i < app->log_count; i++) {
+        LogEntry* entry = log_recent_get(app, i);
+        if(entry->id == edited->id && entry->foreign == edited->foreign) {
+            current = entry;
+            break;
+        }
     }
-    uint32_t dur = 0;
-    while(*dur_pos >= '0' && *dur_pos <= '9') {
-        dur = dur * 10 + (*dur_pos - '0');
-        dur_pos++;
+    if(!current) return false;
+
+    LogRecord rec;
+    if(!entry_to_record(edited, &rec)) return false;
+    uint32_t now = clock_now();
+    if(rec.ts > now) rec.ts = now;
+    if(rec.ts == current->timestamp && rec.duration == current->duration) return true;
+
+    uint8_t flags = (rec.ts != current->timestamp) ? PATCH_MOVED : PATCH_DUR;
+    if(!log_patch_write(&rec, flags)) {
+        debug_log("log_edit_event: failed");
+        return false;
     }
-    return dur;
+    LogRecord old = rec;
+    old.ts = current->timestamp;
+    old.duration = current->duration;
+    recent_remove(app, rec.id);
+    recent_insert(app, &rec);
+    log_sessions_remove(app, &old);
+    log_sessions_add(app, &rec);
+    log_last_remove(app, &old);
+    log_last_add(app, &rec);
+    log_stats_changed(app, rec.type);
+    return true;
 }
 
-// ==== ULTRA-SIMPLE LOG LOADING ====
-// Uses STATIC buffer to avoid stack overflow
-// Only loads last 5 entries to minimize memory usage
-static char g_log_buffer[512]; // Global buffer - not on stack!
-static char g_deleted_buffer[256]; // Global buffer for deleted IDs
+// ==== RING SEEDING ====
+// Reads only the log tail - enough lines to fill the ring - into scratch
+#define RECENT_TAIL_LINES (MAX_LOG_ENTRIES + 16) // Spare lines for deleted and patched events
+#define RECENT_TAIL_MIN 3072 // About a full ring of typical lines
+#define RECENT_TAIL_MAX (RECENT_TAIL_LINES * LOG_LINE_MAX)
 
-void log_load_recent(AppData* app) {
+// Added and moved events live in the patch overlay, not the tail
+static void recent_add_patched(AppData* app) {
+    const LogRecord* rec;
+    for(uint8_t i = 0; (rec = log_patch_injected(i)) != NULL; i++) {
+        if(!log_is_deleted(rec->id)) recent_insert(app, rec);
+    }
+}
+
+static void recent_load(AppData* app) {
     debug_log("log_load_recent: start");
     
     if(!app) {
@@ -202,39 +609,13 @@ void log_load_recent(AppData* app) {
         return;
     }
     
-    // Clear entries first
-    app->log_count = 0;
-    for(int i = 0; i < MAX_LOG_ENTRIES; i++) {
-        app->log_entries[i].id[0] = '\0';
-        app->log_entries[i].type = LogEventDiaper;
-        app->log_entries[i].timestamp = 0;
-        app->log_entries[i].duration = 0;
-    }
+    log_append_flush(); // The tail read must see buffered events
+    recent_clear(app);
     
     debug_log("log_load_recent: loading deleted");
     
-    // Load deleted IDs into global buffer
-    g_deleted_buffer[0] = '\0';
-    {
-        Storage* storage = furi_record_open(RECORD_STORAGE);
-        if(storage) {
-            Stream* stream = buffered_file_stream_alloc(storage);
-            if(stream) {
-                if(buffered_file_stream_open(stream, DELETED_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-                    size_t size = stream_size(stream);
-                    if(size > 0 && size < sizeof(g_deleted_buffer)) {
-                        size_t read = stream_read(stream, (uint8_t*)g_deleted_buffer, size);
-                        if(read < sizeof(g_deleted_buffer)) {
-                            g_deleted_buffer[read] = '\0';
-                        }
-                    }
-                    buffered_file_stream_close(stream);
-                }
-                stream_free(stream);
-            }
-            furi_record_close(RECORD_STORAGE);
-        }
-    }
+    // Load deleted IDs into the tombstone set
+    log_tombstones_load();
     
     debug_log("log_load_recent: opening log file");
     
@@ -256,6 +637,7 @@ void log_load_recent(AppData* app) {
         debug_log("log_load_recent: file open failed (no logs yet)");
         stream_free(stream);
         furi_record_close(RECORD_STORAGE);
+        recent_add_patched(app);
         return;
     }
     
@@ -267,29 +649,26 @@ void log_load_recent(AppData* app) {
         buffered_file_stream_close(stream);
         stream_free(stream);
         furi_record_close(RECORD_STORAGE);
+        recent_add_patched(app);
         return;
     }
     
-    // Read only last 512 bytes (about 4-5 log entries)
-    size_t read_size = (file_size > sizeof(g_log_buffer) - 1) ? sizeof(g_log_buffer) - 1 : file_size;
-    size_t skip_size = (file_size > read_size) ? file_size - read_size : 0;
+    // Read only the tail of the file, as much as scratch has room for
+    ScratchMark mark = scratch_mark();
+    size_t capacity = scratch_free();
+    if(capacity > RECENT_TAIL_MAX) capacity = RECENT_TAIL_MAX;
+    if(capacity < RECENT_TAIL_MIN) capacity = RECENT_TAIL_MIN;
+    char* tail = scratch_alloc(capacity);
     
-    // Skip to near end of file by reading and discarding
-    if(skip_size > 0) {
-        debug_log("log_load_recent: skipping bytes");
-        char skip_byte;
-        for(size_t i = 0; i < skip_size; i++) {
-            if(stream_read(stream, (uint8_t*)&skip_byte, 1) != 1) break;
-        }
-    }
+    size_t read_size = (file_size > capacity - 1) ? capacity - 1 : file_size;
+    size_t skip_size = file_size - read_size;
     
-    debug_log("log_load_recent: reading data");
-    size_t read = stream_read(stream, (uint8_t*)g_log_buffer, read_size);
-    if(read < sizeof(g_log_buffer)) {
-        g_log_buffer[read] = '\0';
-    } else {
-        g_log_buffer[sizeof(g_log_buffer) - 1] = '\0';
+    size_t read = 0;
+    if(skip_size == 0 || stream_seek(stream, skip_size, StreamOffsetFromStart)) {
+        debug_log("log_load_recent: reading data");
+        read = stream_read(stream, (uint8_t*)tail, read_size);
     }
+    tail[read] = '\0';
     
     buffered_file_stream_close(stream);
     stream_free(stream);
@@ -299,15 +678,25 @@ void log_load_recent(AppData* app) {
     
     // Parse lines - simple approach
     // Find lines and store pointers
-    char* lines[10];
+    char* lines[RECENT_TAIL_LINES];
     int line_count = 0;
     
-    char* pos = g_log_buffer;
-    while(*pos && line_count < 10) {
+    char* pos = tail;
+    if(skip_size > 0) {
+        // First line is cut off by the seek
+        while(*pos && *pos != '\n') pos++;
+    }
+    while(*pos) {
         // Skip whitespace
         while(*pos == '\n' || *pos == '\r') pos++;
         if(*pos == '\0') break;
         
+        // Keep only the newest lines
+        if(line_count == RECENT_TAIL_LINES) {
+            memmove(lines, lines + 1, sizeof(lines[0]) * (RECENT_TAIL_LINES - 1));
+            line_count--;
+        }
+        
         // Mark line start
         lines[line_count] = pos;
         
@@ -325,75 +714,180 @@ void log_load_recent(AppData* app) {
     
     debug_log("log_load_recent: processing entries");
     
-    // Process lines (most recent last in file)
-    int entry_count = 0;
-    for(int i = 0; i < line_count && entry_count < MAX_LOG_ENTRIES; i++) {
-        char* line = lines[i];
-        if(!line || strlen(line) < 10) continue;
-        
-        // Check if starts with '{'
-        if(line[0] != '{') continue;
-        
-        // Extract ID
-        char id[33];
-        if(!extract_id(line, id)) continue;
-        
-        // Check if deleted
-        if(g_deleted_buffer[0] != '\0') {
-            char search[48];
-            snprintf(search, sizeof(search), "\"id\":\"%s\"", id);
-            if(strstr(g_deleted_buffer, search)) continue; // Skip deleted
-        }
-        
-        // Add entry
-        LogEntry* entry = &app->log_entries[entry_count];
-        strncpy(entry->id, id, 32);
-        entry->id[32] = '\0';
-        entry->type = parse_event_type(line);
-        entry->duration = extract_duration(line);
-        entry->timestamp = log_get_timestamp(); // Use current time as approx
-        
-        entry_count++;
+    // Oldest first - the ring keeps the newest MAX_LOG_ENTRIES
+    LogRecord rec;
+    LogRecord scratch;
+    for(int i = 0; i < line_count; i++) {
+        if(!log_parse_record(lines[i], &rec)) continue;
+        if(log_is_deleted(rec.id)) continue; // Skip deleted
+        const LogRecord* patched = log_patch_apply(&rec, &scratch);
+        if(patched) recent_push(app, patched);
     }
-    
-    app->log_count = entry_count;
+    scratch_release(mark);
+    recent_add_patched(app);
     
     debug_log("log_load_recent: done");
 }
 
+void log_load_recent(AppData* app) {
+    diag_begin(DiagOpLoad);
+    recent_load(app);
+    diag_end(DiagOpLoad);
+}
+
+// ==== UNDO JOURNAL ====
+// Every delete and undo is appended to deleted.jsonl, so the tombstone set is
+// a replay of the journal. The newest JOURNAL_DEPTH operations are mirrored
+// in AppData: undo and redo work from that cache and the recent ring, without
+// reading the log.
+
+// Move the cache cursor for an operation that was just journaled
+static void journal_track(UndoJournal* journal, JournalOp op, const LogRecord* rec) {
+    if(op == JournalOpRestore) {
+        // Undo of the newest undoable delete
+        if(journal->cursor > 0 && entry_has_id(&journal->ops[journal->cursor - 1].entry, rec->id)) {
+            journal->cursor--;
+        }
+        return;
+    }
+
+    if(journal->cursor < journal->count && entry_has_id(&journal->ops[journal->cursor].entry, rec->id)) {
+        journal->cursor++; // Redo
+        return;
+    }
+
+    // New delete - drops the redo tail, and the oldest op when full
+    journal->count = journal->cursor;
+    if(journal->count == JOURNAL_DEPTH) {
+        memmove(journal->ops, journal->ops + 1, sizeof(JournalEntry) * (JOURNAL_DEPTH - 1));
+        journal->count--;
+    }
+    JournalEntry* op_entry = &journal->ops[journal->count++];
+    op_entry->op = JournalOpDelete;
+    entry_from_record(rec, &op_entry->entry);
+    journal->cursor = journal->count;
+}
+
+void log_journal_clear(AppData* app) {
+    memset(&app->journal, 0, sizeof(UndoJournal));
+}
+
+// Rebuild the undo cache by replaying deleted.jsonl (once per child)
+void log_journal_load(AppData* app) {
+    static LogReader reader; // Static - keeps chunk buffers off the stack
+    log_journal_clear(app);
+    if(!log_reader_open(&reader, DELETED_PATH)) return;
+
+    const char* line;
+    LogRecord rec;
+    while((line = log_reader_next(&reader)) != NULL) {
+        if(!log_parse_record(line, &rec)) continue;
+        JournalOp op = log_parse_op(line);
+        if(op == JournalOpDelete && rec.ts == 0) continue; // Old bare-id line, not undoable
+        journal_track(&app->journal, op, &rec);
+    }
+    log_reader_close(&reader);
+}
+
+bool log_undo(AppData* app) {
+    UndoJournal* journal = &app->journal;
+    if(journal->cursor == 0) return false;
+
+    LogRecord rec;
+    if(!entry_to_record(&journal->ops[journal->cursor - 1].entry, &rec)) return false;
+    // An edit made between an undo and a redo is in the overlay, not the journal
+    const PatchEntry* patch = log_patch_find(rec.id);
+    if(patch) {
+        rec.ts = patch->rec.ts;
+        rec.duration = patch->rec.duration;
+    }
+    if(!journal_write(JournalOpRestore, &rec)) return false;
+    journal_track(journal, JournalOpRestore, &rec);
+    recent_insert(app, &rec);
+    log_sessions_add(app, &rec);
+    log_last_add(app, &rec);
+    log_stats_changed(app, rec.type);
+    return true;
+}
+
+bool log_redo(AppData* app) {
+    UndoJournal* journal = &app->journal;
+    if(journal->cursor >= journal->count) return false;
+    if(log_tombstones_full()) {
+        app->delete_refused = true;
+        return false;
+    }
+
+    LogRecord rec;
+    if(!entry_to_record(&journal->ops[journal->cursor].entry, &rec) ||
+       !journal_write(JournalOpDelete, &rec)) return false;
+    journal_track(journal, JournalOpDelete, &rec);
+    recent_remove(app, rec.id);
+    log_sessions_remove(app, &rec);
+    log_last_remove(app, &rec);
+    log_stats_changed(app, rec.type);
+    return true;
+}
+
+// A full tombstone set gets one chance to fold deleted records out of
+// log.jsonl before the delete is refused
+static bool tombstones_make_room(AppData* app) {
+    if(!log_tombstones_full()) return true;
+    debug_log("log_delete_last: tombstones full, rotating");
+    if(log_archive_rotate()) {
+        log_load_recent(app);
+        log_journal_load(app);
+    }
+    return !log_tombstones_full();
+}
+
 // Delete last event - ultra simple
-void log_delete_last(AppData* app) {
+bool log_delete_last(AppData* app) {
     debug_log("log_delete_last: start");
     
     if(!app) {
         debug_log("log_delete_last: app is NULL");
-        return;
+        return false;
     }
     
     if(app->log_count <= 0 || app->log_count > MAX_LOG_ENTRIES) {
         debug_log("log_delete_last: invalid count");
-        return;
+        return false;
     }
     
-    int idx = app->log_count - 1;
-    if(idx < 0 || idx >= MAX_LOG_ENTRIES) {
-        debug_log("log_delete_last: invalid index");
-        return;
+    if(!tombstones_make_room(app)) {
+        debug_log("log_delete_last: refused");
+        app->delete_refused = true;
+        return false;
     }
     
-    LogEntry* entry = &app->log_entries[idx];
-    if(entry->id[0] == '\0') {
-        debug_log("log_delete_last: empty ID");
-        return;
+    LogEntry* entry = log_recent_get(app, app->log_count - 1);
+    LogRecord rec;
+    if(!entry || !entry_to_record(entry, &rec)) {
+        debug_log("log_delete_last: no ID");
+        return false;
     }
     
     debug_log("log_delete_last: marking deleted");
-    mark_deleted(entry->id);
-    
-    debug_log("log_delete_last: reloading");
-    log_load_recent(app);
+    if(!journal_write(JournalOpDelete, &rec)) {
+        debug_log("log_delete_last: journal write failed");
+        return false;
+    }
+    journal_track(&app->journal, JournalOpDelete, &rec);
+    log_sessions_remove(app, &rec);
+    app->log_count--;
+    app->log_generation++;
+    log_last_remove(app, &rec);
+    
+    if(app->log_count == 0) {
+        // Ring drained - older events may still be on the card
+        debug_log("log_delete_last: reseeding");
+        log_load_recent(app);
+    }
+    log_stats_changed(app, rec.type);
     
     debug_log("log_delete_last: done");
+    return true;
 }
 
 // Clear all logs - delete both log and deleted files
@@ -409,26 +903,95 @@ void log_clear_all(AppData* app) {
     }
     
     // Delete the log file
+    log_append_discard();
     storage_common_remove(storage, LOG_PATH);
     debug_log("log_clear_all: removed log.jsonl");
     
+    // Delete archived history
+    log_archive_clear(storage);
+    debug_log("log_clear_all: removed archive segments");
+    
     // Delete the deleted IDs file
     storage_common_remove(storage, DELETED_PATH);
+    storage_common_remove(storage, TOMBSTONES_PATH);
+    g_tombstone_count = 0;
+    g_tombstone_overflow = false;
     debug_log("log_clear_all: removed deleted.jsonl");
     
+    // Delete retroactive edits and any unfinished check
+    log_patches_clear();
+    storage_common_remove(storage, CHECK_STATE_PATH);
+    app->check_resumable = false;
+    
     // Delete the debug log too
     storage_common_remove(storage, DEBUG_PATH);
     
     furi_record_close(RECORD_STORAGE);
     
     // Clear in-memory entries
-    app->log_count = 0;
-    for(int i = 0; i < MAX_LOG_ENTRIES; i++) {
-        app->log_entries[i].id[0] = '\0';
-        app->log_entries[i].type = LogEventDiaper;
-        app->log_entries[i].timestamp = 0;
-        app->log_entries[i].duration = 0;
-    }
+    recent_clear(app);
+    log_journal_clear(app);
+    log_stats_clear(app);
+    log_sessions_clear(app);
+    log_last_clear(app);
     
     debug_log("log_clear_all: done");
 }
+
+// ==== LOG SWAP ====
+// Rewrites (import, archive rotation) build log.tmp and swap it in through
+// log.bak, so power loss at any point leaves either the old or the new log.
+
+bool log_swap_in(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, LOG_BAK_PATH);
+
+    bool ok = true;
+    if(storage_common_exists(storage, LOG_PATH)) {
+        ok = (storage_common_rename(storage, LOG_PATH, LOG_BAK_PATH) == FSE_OK);
+    }
+    if(ok) {
+        ok = (storage_common_rename(storage, LOG_TMP_PATH, LOG_PATH) == FSE_OK);
+        if(!ok) {
+            storage_common_rename(storage, LOG_BAK_PATH, LOG_PATH);
+        }
+    }
+
+    if(ok) {
+        log_archive_commit(storage);
+        storage_common_remove(storage, CHECK_STATE_PATH); // Scan position is stale
+    } else {
+        log_archive_abort(storage);
+        debug_log("log_swap_in: rename failed");
+    }
+    storage_common_remove(storage, LOG_TMP_PATH);
+    storage_common_remove(storage, LOG_BAK_PATH);
+
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+// Finish or roll back a swap interrupted by power loss
+void log_swap_recover(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool has_log = storage_common_exists(storage, LOG_PATH);
+    bool has_bak = storage_common_exists(storage, LOG_BAK_PATH);
+    bool has_tmp = storage_common_exists(storage, LOG_TMP_PATH);
+
+    if(has_bak && !has_log) {
+        // Lost between the two renames - old log is still complete
+        storage_common_rename(storage, LOG_BAK_PATH, LOG_PATH);
+        log_archive_abort(storage);
+        debug_log("log_swap_recover: restored log.bak");
+    } else if(has_tmp) {
+        // New log never made it in place
+        log_archive_abort(storage);
+    } else {
+        // New log is in place (or nothing was running) - finish the swap
+        log_archive_commit(storage);
+    }
+    storage_common_remove(storage, LOG_TMP_PATH);
+    storage_common_remove(storage, LOG_BAK_PATH);
+
+    furi_record_close(RECORD_STORAGE);
+}
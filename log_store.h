@@ -1,9 +1,49 @@
 #pragma once
 #include "app_state.h"
+#include "child.h"
+
+#define LOG_DIR (child_paths()->dir)
+#define LOG_PATH (child_paths()->log)
+#define DELETED_PATH (child_paths()->deleted)
+#define PATCHES_PATH (child_paths()->patches)
+#define PATCHES_TMP_PATH (child_paths()->patches_tmp) // Unfolded patches before swap-in
+#define DEBUG_PATH EXT_PATH("apps/baby_log/debug.log")
+#define LOG_TMP_PATH (child_paths()->log_tmp) // Rewritten log before swap-in
+#define LOG_BAK_PATH (child_paths()->log_bak) // Previous log during swap-in
+#define DELETED_TMP_PATH (child_paths()->deleted_tmp) // Compacted journal before swap-in
+#define TOMBSTONES_PATH (child_paths()->tombstones) // Sorted hashes of compacted deletes
+#define TOMBSTONES_TMP_PATH (child_paths()->tombstones_tmp)
+
+#define LOG_TOMBSTONE_MAX 128 // Deletes whose records are still in log.jsonl
+#define TOMBSTONE_FOLD_AT 96 // Rotate at next startup once the set is this full
+
+void debug_log(const char* msg);
+void debug_log_flush(void); // Write out the lines release builds hold back
 
-uint32_t log_get_timestamp(void);
 void log_add_event(AppData* app, LogEventType type, uint32_t duration);
+bool log_add_past_event(AppData* app, LogEventType type, uint32_t ts, uint32_t duration);
+bool log_edit_event(AppData* app, const LogEntry* edited); // New ts/duration for a ring entry
 void log_load_recent(AppData* app);
-void log_delete_last(AppData* app);
+LogEntry* log_recent_get(AppData* app, int index); // 0 = oldest in the ring
+bool log_delete_last(AppData* app); // False if refused (see app->delete_refused)
+bool log_undo(AppData* app); // Restore the last deleted event
+bool log_redo(AppData* app); // Delete it again
+void log_journal_load(AppData* app);
+void log_journal_clear(AppData* app);
 void log_clear_all(AppData* app);
 
+bool log_swap_in(void); // Replace log.jsonl with log.tmp
+void log_swap_recover(void);
+
+void log_tombstones_load(void);
+void log_tombstones_add_file(const char* path);
+bool log_is_deleted(const char* id);
+int log_tombstone_count(void);
+bool log_tombstones_full(void); // No room for another delete, or a loaded file overflowed
+bool log_tombstone_drop(const char* id); // Rotation left the record out; false if not deleted
+void log_tombstones_compact(void); // After the rotation swap-in: retire dropped deletes
+
+// Compacted deletes, for records the other device may still have (import)
+bool log_tombstones_archive_open(void);
+bool log_tombstone_archived(const char* id);
+void log_tombstones_archive_close(void);
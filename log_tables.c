@@ -0,0 +1,76 @@
+#include "log_tables.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "log_stats.h"
+#include <storage/storage.h>
+
+// Running timers from the ring: the newest start or stop of each kind
+// decides; with neither in the ring state.json stands
+static void timers_recover(AppData* app) {
+    bool feed_seen = false, sleep_seen = false;
+    for(int i = app->log_count - 1; i >= 0 && !(feed_seen && sleep_seen); i--) {
+        const LogEntry* entry = log_recent_get(app, i);
+        switch(entry->type) {
+            case LogEventFeedingStart:
+            case LogEventFeedingStop:
+                if(feed_seen) break;
+                feed_seen = true;
+                app->state.feeding_active = entry->type == LogEventFeedingStart;
+                if(app->state.feeding_active) app->state.feeding_start_ts = entry->timestamp;
+                break;
+            case LogEventSleepStart:
+            case LogEventSleepStop:
+                if(sleep_seen) break;
+                sleep_seen = true;
+                app->state.sleep_active = entry->type == LogEventSleepStart;
+                if(app->state.sleep_active) app->state.sleep_start_ts = entry->timestamp;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+bool log_tables_open(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool clean = storage_common_remove(storage, TABLES_OK_PATH) == FSE_OK;
+    furi_record_close(RECORD_STORAGE);
+    return clean;
+}
+
+void log_tables_rebuild(AppData* app) {
+    debug_log("log_tables_rebuild: not closed cleanly");
+    log_sessions_rebuild(app);
+    log_last_seed(app); // Again once the index is rebuilt
+    log_stats_rebuild(app);
+    timers_recover(app);
+    save_state_deferred(app);
+}
+
+bool log_tables_save(void) {
+    bool ok = log_append_flush();
+    debug_log_flush();
+    log_sessions_checkpoint(); // Left dirty on failure, see log_sessions.h
+    ok = log_last_checkpoint() && ok;
+    ok = log_stats_checkpoint() && ok;
+    ok = state_checkpoint() && ok;
+    return ok;
+}
+
+void log_tables_close(void) {
+    if(log_tables_save()) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        File* file = storage_file_alloc(storage);
+        if(!storage_file_open(file, TABLES_OK_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            debug_log("log_tables_close: mark failed");
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+    } else {
+        debug_log("log_tables_close: save failed, rebuilt on the next start");
+    }
+    debug_log_flush();
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "app_state.h"
+#include "child.h"
+
+// ==== DERIVED TABLES ====
+// state.json, last.bin, stats.bin and the session index hold nothing the
+// log does not; they only save a scan. While a child is active they are
+// kept in RAM and written out on exit, child switch and archive rotation,
+// not with every flush of the append buffer (each one is a file rewrite of
+// its own). tables.ok is created after a full set is written on exit or
+// child switch and removed as soon as the child is active again, so a
+// start without it (power loss, crash) rebuilds the tables from the log
+// instead of trusting a set that may be behind it.
+
+#define TABLES_OK_PATH (child_paths()->tables_ok)
+
+bool log_tables_open(void); // True if the active child's set was closed cleanly
+void log_tables_rebuild(AppData* app); // After log_load_recent(), when open was not clean
+bool log_tables_save(void); // Log buffer and every table changed since the last save
+void log_tables_close(void); // Save, then mark the set clean
@@ -0,0 +1,180 @@
+#include "reminder.h"
+#include "log_store.h"
+#include <furi.h>
+#include <notification/notification.h>
+#include <notification/notification_messages.h>
+#include <string.h>
+
+#define REMIND_SLOTS (CHILD_MAX * ReminderCount)
+
+typedef struct {
+    uint32_t deadline;
+    ReminderKind kind;
+    uint8_t child;
+} ReminderDeadline;
+
+static struct {
+    FuriTimer* timer;
+    ReminderDeadline heap[REMIND_SLOTS]; // Min-heap on deadline, one entry per (child, kind)
+    uint8_t size;
+    uint32_t derived[CHILD_MAX][ReminderCount]; // Deadlines of the last sync, 0 = none
+    uint32_t fired[CHILD_MAX][ReminderCount]; // Deadline already alerted
+} g_remind;
+
+// Two buzzes with the LED on, colour tells the kind apart
+#define REMIND_SEQUENCE(led_on, led_off) \
+    {                                     \
+        &message_display_backlight_on,    \
+        &led_on,                          \
+        &message_vibro_on,                \
+        &message_delay_250,               \
+        &message_vibro_off,               \
+        &message_delay_100,               \
+        &message_vibro_on,                \
+        &message_delay_250,               \
+        &message_vibro_off,               \
+        &message_delay_500,               \
+        &led_off,                         \
+        NULL,                             \
+    }
+
+static const NotificationSequence sequence_remind_feed = REMIND_SEQUENCE(message_red_255, message_red_0);
+static const NotificationSequence sequence_remind_diaper = REMIND_SEQUENCE(message_green_255, message_green_0);
+static const NotificationSequence sequence_remind_sleep = REMIND_SEQUENCE(message_blue_255, message_blue_0);
+
+static const NotificationSequence* const remind_sequences[ReminderCount] = {
+    [ReminderFeed] = &sequence_remind_feed,
+    [ReminderDiaper] = &sequence_remind_diaper,
+    [ReminderSleep] = &sequence_remind_sleep,
+};
+
+// ==== HEAP ====
+
+static void heap_swap(uint8_t a, uint8_t b) {
+    ReminderDeadline tmp = g_remind.heap[a];
+    g_remind.heap[a] = g_remind.heap[b];
+    g_remind.heap[b] = tmp;
+}
+
+static void heap_push(uint32_t deadline, uint8_t child, ReminderKind kind) {
+    if(g_remind.size >= REMIND_SLOTS) return;
+    uint8_t i = g_remind.size++;
+    g_remind.heap[i].deadline = deadline;
+    g_remind.heap[i].kind = kind;
+    g_remind.heap[i].child = child;
+    while(i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if(g_remind.heap[parent].deadline <= g_remind.heap[i].deadline) break;
+        heap_swap(parent, i);
+        i = parent;
+    }
+}
+
+static ReminderDeadline heap_pop(void) {
+    ReminderDeadline top = g_remind.heap[0];
+    g_remind.heap[0] = g_remind.heap[--g_remind.size];
+    uint8_t i = 0;
+    for(;;) {
+        uint8_t smallest = i;
+        uint8_t left = 2 * i + 1;
+        uint8_t right = left + 1;
+        if(left < g_remind.size && g_remind.heap[left].deadline < g_remind.heap[smallest].deadline) {
+            smallest = left;
+        }
+        if(right < g_remind.size && g_remind.heap[right].deadline < g_remind.heap[smallest].deadline) {
+            smallest = right;
+        }
+        if(smallest == i) break;
+        heap_swap(i, smallest);
+        i = smallest;
+    }
+    return top;
+}
+
+// One timer for the earliest deadline. The RTC has whole seconds only, so
+// an early expiry just re-arms for the remaining seconds.
+static void timer_arm(uint32_t now) {
+    furi_timer_stop(g_remind.timer);
+    if(g_remind.size == 0) return;
+
+    uint32_t deadline = g_remind.heap[0].deadline;
+    uint32_t ticks = (deadline > now) ? furi_ms_to_ticks((deadline - now) * 1000) : 1;
+    furi_timer_start(g_remind.timer, ticks);
+}
+
+// ==== DEADLINES ====
+
+// The active child's timers and table are in AppData, the others' in their
+// slot (child.h) - cached on a visit or read at start
+static void deadlines_derive(AppData* app, uint8_t child, uint32_t* out) {
+    const AppState* state = &app->state;
+    const LastEvent* last = app->last;
+    if(child != app->active_child) {
+        const ChildSlot* slot = &app->children[child];
+        state = &slot->state;
+        last = slot->last;
+        if(!slot->loaded && !slot->peeked) {
+            memset(out, 0, ReminderCount * sizeof(uint32_t));
+            return;
+        }
+    }
+
+    uint32_t base[ReminderCount] = {0};
+    if(!state->feeding_active) base[ReminderFeed] = last[LogEventFeedingStart].ts;
+    base[ReminderDiaper] = last[LogEventDiaper].ts;
+    if(state->sleep_active) base[ReminderSleep] = state->sleep_start_ts;
+
+    for(int i = 0; i < ReminderCount; i++) {
+        uint16_t minutes = app->remind_minutes[i];
+        out[i] = (minutes > 0 && base[i] > 0) ? base[i] + minutes * 60 : 0;
+    }
+}
+
+void reminder_init(FuriTimerCallback callback, void* context) {
+    memset(&g_remind, 0, sizeof(g_remind));
+    g_remind.timer = furi_timer_alloc(callback, FuriTimerTypeOnce, context);
+}
+
+void reminder_free(void) {
+    if(!g_remind.timer) return;
+    furi_timer_stop(g_remind.timer);
+    furi_timer_free(g_remind.timer);
+    g_remind.timer = NULL;
+}
+
+void reminder_sync(AppData* app, uint32_t now) {
+    uint32_t derived[CHILD_MAX][ReminderCount] = {{0}};
+    for(uint8_t child = 0; child < app->child_count && child < CHILD_MAX; child++) {
+        deadlines_derive(app, child, derived[child]);
+    }
+    if(memcmp(derived, g_remind.derived, sizeof(derived)) == 0) return;
+    memcpy(g_remind.derived, derived, sizeof(derived));
+
+    g_remind.size = 0;
+    for(uint8_t child = 0; child < CHILD_MAX; child++) {
+        for(int i = 0; i < ReminderCount; i++) {
+            uint32_t deadline = derived[child][i];
+            if(deadline != 0 && deadline != g_remind.fired[child][i]) {
+                heap_push(deadline, child, (ReminderKind)i);
+            }
+        }
+    }
+    timer_arm(now);
+}
+
+bool reminder_fire(AppData* app, uint32_t now) {
+    NotificationApp* notifications = NULL;
+    while(g_remind.size > 0 && g_remind.heap[0].deadline <= now) {
+        ReminderDeadline due = heap_pop();
+        g_remind.fired[due.child][due.kind] = due.deadline;
+        app->remind_alert = true;
+        app->remind_alert_child = due.child;
+        app->remind_alert_kind = due.kind;
+        if(!notifications) notifications = furi_record_open(RECORD_NOTIFICATION);
+        notification_message(notifications, remind_sequences[due.kind]);
+        debug_log("reminder_fire: alert");
+    }
+    if(notifications) furi_record_close(RECORD_NOTIFICATION);
+    timer_arm(now);
+    return notifications != NULL;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "app_state.h"
+
+// ==== REMINDERS ====
+// Each enabled reminder has one deadline per child, derived from that
+// child's last event table (log_last.h) and timers - the active child's in
+// AppData, the others' cached in their slot (child.h):
+//   feed    last feeding start + remind_minutes (not while feeding)
+//   diaper  last diaper change + remind_minutes
+//   sleep   sleep start + remind_minutes (only while sleeping)
+// Deadlines sit in a small min-heap, one entry per (child, kind); one
+// one-shot FuriTimer is armed for the earliest, and its callback only wakes
+// the main loop. Each deadline alerts once (vibration plus an LED colour
+// per kind, and the child's name on the main screen) until logging an
+// event moves it.
+
+#define REMIND_STEP_MINUTES 30
+#define REMIND_MAX_MINUTES (12 * 60)
+
+void reminder_init(FuriTimerCallback callback, void* context); // Callback runs on the timer thread
+void reminder_free(void);
+
+void reminder_sync(AppData* app, uint32_t now); // Re-derive deadlines, cheap when nothing changed
+bool reminder_fire(AppData* app, uint32_t now); // Alert for every deadline that has passed; true if any
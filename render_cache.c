@@ -0,0 +1,192 @@
+#include "render_cache.h"
+#include "screen_draw.h"
+#include "translations.h"
+#include "log_store.h"
+#include "log_stats.h"
+#include <datetime/datetime.h>
+
+// Format duration string (minutes)
+static void format_duration(uint32_t seconds, char* out, size_t out_size) {
+    uint32_t minutes = seconds / 60;
+    if(minutes < 60) {
+        snprintf(out, out_size, "%lum", (unsigned long)minutes);
+    } else {
+        uint32_t hours = minutes / 60;
+        minutes = minutes % 60;
+        snprintf(out, out_size, "%luh%lum", (unsigned long)hours, (unsigned long)minutes);
+    }
+}
+
+// ==== MAIN SCREEN ====
+
+static struct {
+    bool valid;
+    uint8_t language;
+    bool feeding;
+    bool sleeping;
+    uint32_t start; // Timer start, or last feed end while awake
+    uint32_t minutes; // Elapsed minutes shown
+    char status[32];
+} g_main;
+
+// "Fed 45m ago": label, duration, then the suffix unless a language has none
+static void format_since(AppData* app, TranslationKey label, uint32_t minutes, char* out, size_t out_size) {
+    char dur_str[16];
+    format_duration(minutes * 60, dur_str, sizeof(dur_str));
+    const char* ago = tr_get(app, TR_MAIN_AGO);
+    snprintf(out, out_size, "%s %s%s%s", tr_get(app, label), dur_str, ago[0] ? " " : "", ago);
+}
+
+static struct {
+    uint8_t active; // 0 = not built
+    uint8_t count;
+    char text[8];
+} g_child;
+
+const char* render_main_status(AppData* app, uint32_t now) {
+    bool feeding = app->state.feeding_active;
+    bool sleeping = app->state.sleep_active && !feeding;
+    uint32_t start = feeding ? app->state.feeding_start_ts :
+                     sleeping ? app->state.sleep_start_ts :
+                                app->last[LogEventFeedingStop].ts;
+    uint32_t minutes = (start > 0 && now > start) ? (now - start) / 60 : 0;
+
+    if(g_main.valid && g_main.language == app->cfg.language && g_main.feeding == feeding &&
+       g_main.sleeping == sleeping && g_main.start == start && g_main.minutes == minutes) {
+        return g_main.status;
+    }
+
+    if(feeding || sleeping) {
+        char dur_str[16];
+        format_duration(minutes * 60, dur_str, sizeof(dur_str));
+        snprintf(g_main.status, sizeof(g_main.status), "%s %s",
+            tr_get(app, feeding ? TR_MAIN_FEEDING : TR_MAIN_SLEEPING), dur_str);
+    } else if(start > 0) {
+        format_since(app, TR_MAIN_FED, minutes, g_main.status, sizeof(g_main.status));
+    } else {
+        snprintf(g_main.status, sizeof(g_main.status), "%s", tr_get(app, TR_MAIN_AWAKE));
+    }
+    g_main.language = app->cfg.language;
+    g_main.feeding = feeding;
+    g_main.sleeping = sleeping;
+    g_main.start = start;
+    g_main.minutes = minutes;
+    g_main.valid = true;
+    return g_main.status;
+}
+
+const char* render_main_child(AppData* app) {
+    if(g_child.active != app->active_child + 1 || g_child.count != app->child_count) {
+        g_child.active = app->active_child + 1;
+        g_child.count = app->child_count;
+        snprintf(g_child.text, sizeof(g_child.text), "%u/%u", g_child.active, g_child.count);
+    }
+    return g_child.text;
+}
+
+static struct {
+    bool valid;
+    uint8_t language;
+    bool sleeping;
+    uint32_t ts; // Forecast shown
+    char text[32];
+} g_forecast;
+
+const char* render_main_forecast(AppData* app) {
+    bool sleeping = app->state.sleep_active;
+    uint32_t ts = sleeping ? log_stats_wake_at(app) : log_stats_next_feed(app);
+
+    if(g_forecast.valid && g_forecast.language == app->cfg.language &&
+       g_forecast.sleeping == sleeping && g_forecast.ts == ts) {
+        return g_forecast.text;
+    }
+
+    if(ts == 0) {
+        g_forecast.text[0] = '\0';
+    } else {
+        DateTime datetime;
+        datetime_timestamp_to_datetime(ts, &datetime);
+        snprintf(g_forecast.text, sizeof(g_forecast.text), "%s ~%02u:%02u",
+            tr_get(app, sleeping ? TR_MAIN_WAKE_AT : TR_MAIN_NEXT_FEED), datetime.hour, datetime.minute);
+    }
+    g_forecast.language = app->cfg.language;
+    g_forecast.sleeping = sleeping;
+    g_forecast.ts = ts;
+    g_forecast.valid = true;
+    return g_forecast.text;
+}
+
+static struct {
+    bool valid;
+    uint8_t language;
+    uint32_t ts; // Last diaper change
+    uint32_t minutes;
+    char text[32];
+} g_diaper;
+
+const char* render_main_diaper(AppData* app, uint32_t now) {
+    uint32_t ts = app->last[LogEventDiaper].ts;
+    uint32_t minutes = (ts > 0 && now > ts) ? (now - ts) / 60 : 0;
+
+    if(g_diaper.valid && g_diaper.language == app->cfg.language && g_diaper.ts == ts &&
+       g_diaper.minutes == minutes) {
+        return g_diaper.text;
+    }
+
+    if(ts == 0) {
+        g_diaper.text[0] = '\0';
+    } else {
+        format_since(app, TR_MAIN_DIAPER_SINCE, minutes, g_diaper.text, sizeof(g_diaper.text));
+    }
+    g_diaper.language = app->cfg.language;
+    g_diaper.ts = ts;
+    g_diaper.minutes = minutes;
+    g_diaper.valid = true;
+    return g_diaper.text;
+}
+
+// ==== RECENT LOG ====
+
+// Only the rows on screen are kept - the ring is too long to format whole
+#define RENDER_LOG_ROWS 4
+
+static struct {
+    bool valid;
+    uint8_t language;
+    uint32_t generation;
+    int first; // Ring index of rows[0]
+    char rows[RENDER_LOG_ROWS][40];
+} g_log;
+
+static void build_row(AppData* app, const LogEntry* entry, char* out, size_t out_size) {
+    DateTime datetime;
+    datetime_timestamp_to_datetime(entry->timestamp, &datetime);
+
+    const char* type_str = get_event_type_str(app, entry->type);
+    if(!type_str) type_str = "?";
+
+    if(entry->duration > 0 &&
+       (entry->type == LogEventFeedingStop || entry->type == LogEventSleepStop)) {
+        char dur_str[16];
+        format_duration(entry->duration, dur_str, sizeof(dur_str));
+        snprintf(out, out_size, "%02u:%02u %s %s", datetime.hour, datetime.minute, type_str, dur_str);
+    } else {
+        snprintf(out, out_size, "%02u:%02u %s", datetime.hour, datetime.minute, type_str);
+    }
+}
+
+const char* render_log_row(AppData* app, int index) {
+    if(index < 0 || index >= app->log_count) return "";
+    if(!g_log.valid || g_log.language != app->cfg.language ||
+       g_log.generation != app->log_generation || index < g_log.first ||
+       index >= g_log.first + RENDER_LOG_ROWS) {
+        g_log.first = index;
+        for(int i = 0; i < RENDER_LOG_ROWS && index + i < app->log_count; i++) {
+            build_row(app, log_recent_get(app, index + i), g_log.rows[i], sizeof(g_log.rows[i]));
+        }
+        g_log.language = app->cfg.language;
+        g_log.generation = app->log_generation;
+        g_log.valid = true;
+    }
+    return g_log.rows[index - g_log.first];
+}
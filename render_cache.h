@@ -0,0 +1,13 @@
+#pragma once
+#include "app_state.h"
+
+// ==== RENDER CACHE ====
+// Formatted strings for the main and Recent Log screens, rebuilt only when
+// what they show changes: timer state, the displayed minute, the recent ring
+// (log_generation), the forecast time, the last event table or the language. Draw callbacks just draw the pointers.
+
+const char* render_main_status(AppData* app, uint32_t now); // "Feeding 1h5m", "Fed 45m ago" while awake
+const char* render_main_child(AppData* app); // "2/3"
+const char* render_main_forecast(AppData* app); // "Next feed ~14:20", "" if unknown
+const char* render_main_diaper(AppData* app, uint32_t now); // "Diaper 2h10m ago", "" if none
+const char* render_log_row(AppData* app, int index); // Same index as log_recent_get(), valid until the next call
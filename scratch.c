@@ -0,0 +1,43 @@
+#include "scratch.h"
+
+#define SCRATCH_ALIGN 4
+
+static uint8_t g_arena[SCRATCH_ARENA_SIZE] __attribute__((aligned(SCRATCH_ALIGN)));
+static size_t g_used = 0;
+static size_t g_peak = 0;
+static FuriThreadId g_owner = NULL;
+
+void scratch_init(void) {
+    g_used = 0;
+    g_owner = furi_thread_get_current_id();
+}
+
+ScratchMark scratch_mark(void) {
+    furi_assert(!g_owner || furi_thread_get_current_id() == g_owner);
+    return g_used;
+}
+
+void* scratch_alloc(size_t size) {
+    furi_assert(!g_owner || furi_thread_get_current_id() == g_owner);
+    size_t start = (g_used + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    if(start > SCRATCH_ARENA_SIZE || size > SCRATCH_ARENA_SIZE - start) {
+        furi_crash("Scratch arena full");
+    }
+    g_used = start + size;
+    if(g_used > g_peak) g_peak = g_used;
+    return &g_arena[start];
+}
+
+void scratch_release(ScratchMark mark) {
+    furi_assert(mark <= g_used);
+    g_used = mark;
+}
+
+size_t scratch_free(void) {
+    size_t start = (g_used + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    return (start < SCRATCH_ARENA_SIZE) ? SCRATCH_ARENA_SIZE - start : 0;
+}
+
+size_t scratch_peak(void) {
+    return g_peak;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <furi.h>
+
+// ==== SCRATCH ARENA ====
+// One fixed arena that storage and parsing code borrows its buffers from,
+// instead of each keeping its own static or stack buffer. Use is strictly
+// nested:
+//   ScratchMark mark = scratch_mark();
+//   char* line = scratch_alloc(LOG_LINE_MAX);
+//   ...
+//   scratch_release(mark); // Frees everything allocated since the mark
+// Only the app thread may use it: all storage work runs there, see
+// input_queue.h. Running out is a bug and crashes with a message; code
+// that can make do with less sizes its request by scratch_free().
+// Buffers that outlive one call (job state, the language pack) stay static.
+
+// Sized per build profile; override with cdefines in application.fam.
+#ifndef SCRATCH_ARENA_SIZE
+#ifdef FURI_DEBUG
+#define SCRATCH_ARENA_SIZE 6144 // Debug builds: room for larger tail reads
+#else
+#define SCRATCH_ARENA_SIZE 4096
+#endif
+#endif
+
+typedef size_t ScratchMark;
+
+void scratch_init(void); // On the app thread, before any storage access
+ScratchMark scratch_mark(void);
+void* scratch_alloc(size_t size);
+void scratch_release(ScratchMark mark);
+size_t scratch_free(void); // Bytes left
+size_t scratch_peak(void); // Most ever in use
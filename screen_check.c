@@ -0,0 +1,43 @@
+#include "screen_draw.h"
+#include "translations.h"
+
+void draw_check(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, tr_get(app, TR_CHECK_TITLE));
+
+    canvas_set_font(canvas, FontSecondary);
+    char line[40];
+
+    if(app->check_status == JobIdle) {
+        if(app->check_repaired > 0) {
+            snprintf(line, sizeof(line), "%lu %s", (unsigned long)app->check_repaired, tr_get(app, TR_CHECK_REPAIRED));
+            canvas_draw_str(canvas, 2, 24, line);
+        }
+        canvas_draw_str(canvas, 2, 36, "baby_log/log.jsonl");
+        canvas_draw_str(
+            canvas, 2, 56, tr_get(app, app->check_resumable ? TR_CHECK_RESUME : TR_EXPORT_START));
+        return;
+    }
+
+    if(app->check_status == JobRunning) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_CHECK_RUNNING));
+        draw_progress_bar(canvas, 30, app->check_percent);
+        canvas_draw_str(canvas, 2, 56, tr_get(app, TR_EXPORT_CANCEL));
+        return;
+    }
+
+    // Finished or stopped - counts so far
+    if(app->check_status == JobDone) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_CHECK_DONE));
+    } else if(app->check_status == JobCancelled) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_CANCELLED));
+    } else {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_FAILED));
+    }
+    snprintf(line, sizeof(line), "%lu %s", (unsigned long)app->check_good, tr_get(app, TR_CHECK_GOOD));
+    canvas_draw_str(canvas, 2, 36, line);
+    snprintf(line, sizeof(line), "%lu %s", (unsigned long)app->check_bad, tr_get(app, TR_CHECK_BAD));
+    canvas_draw_str(canvas, 2, 48, line);
+}
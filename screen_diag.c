@@ -0,0 +1,36 @@
+#include "screen_draw.h"
+#include "diag.h"
+#include "input_queue.h"
+#include "scratch.h"
+
+// Hidden developer screen, English only (like debug.log)
+void draw_diag(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontSecondary);
+    char line[40];
+    snprintf(line, sizeof(line), "Diag  scratch %u/%u",
+        (unsigned)scratch_peak(), (unsigned)SCRATCH_ARENA_SIZE);
+    canvas_draw_str(canvas, 2, 7, line);
+
+    snprintf(line, sizeof(line), "Stack %lu  Lost keys %lu",
+        (unsigned long)diag_app_stack_free(), (unsigned long)input_queue_dropped());
+    canvas_draw_str(canvas, 2, 16, line);
+
+    snprintf(line, sizeof(line), "Heap %lu  min %lu",
+        (unsigned long)memmgr_get_free_heap(), (unsigned long)memmgr_get_minimum_free_heap());
+    canvas_draw_str(canvas, 2, 25, line);
+
+    // Per operation: stack low it set, heap-min drop, slowest run;
+    // Up/Down scroll the rows that don't fit
+    for(int row = 0; row < DIAG_ROWS && app->diag_index + row < DiagOpCount; row++) {
+        DiagOp op = (DiagOp)(app->diag_index + row);
+        const DiagOpStats* stats = diag_op(op);
+        snprintf(line, sizeof(line), "%-6s s%lu h%lu %lums",
+            diag_op_name(op),
+            (unsigned long)stats->stack_free,
+            (unsigned long)stats->heap_drop,
+            (unsigned long)stats->max_ms);
+        canvas_draw_str(canvas, 2, 34 + row * 9, line);
+    }
+}
@@ -9,3 +9,11 @@ void draw_edit_name(AppData* app, Canvas* canvas);
 void draw_edit_birthdate(AppData* app, Canvas* canvas);
 void draw_recent_log(AppData* app, Canvas* canvas);
 void draw_language(AppData* app, Canvas* canvas);
+void draw_export(AppData* app, Canvas* canvas);
+void draw_import(AppData* app, Canvas* canvas);
+void draw_edit_event(AppData* app, Canvas* canvas);
+void draw_check(AppData* app, Canvas* canvas);
+void draw_reminders(AppData* app, Canvas* canvas);
+void draw_diag(AppData* app, Canvas* canvas);
+void draw_progress_bar(Canvas* canvas, int y, uint8_t percent);
+const char* get_event_type_str(AppData* app, LogEventType type);
@@ -1,27 +1,6 @@
 #include "screen_draw.h"
 #include "translations.h"
-#include <furi_hal_rtc.h>
-#include <datetime/datetime.h>
-
-// Check if date is valid
-static bool is_valid_date(uint16_t year, uint8_t month, uint8_t day) {
-    if(year < 2000 || year > 2100) return false;
-    if(month < 1 || month > 12) return false;
-    if(day < 1 || day > 31) return false;
-    
-    // Check month-specific day limits
-    if(month == 2 && day > 29) return false;
-    if((month == 4 || month == 6 || month == 9 || month == 11) && day > 30) return false;
-    
-    // Check not in future
-    DateTime now;
-    furi_hal_rtc_get_datetime(&now);
-    if(year > now.year) return false;
-    if(year == now.year && month > now.month) return false;
-    if(year == now.year && month == now.month && day > now.day) return false;
-    
-    return true;
-}
+#include "date_util.h"
 
 void draw_edit_birthdate(AppData* app, Canvas* canvas) {
     canvas_clear(canvas);
@@ -59,7 +38,7 @@ void draw_edit_birthdate(AppData* app, Canvas* canvas) {
     canvas_draw_str(canvas, 8, y_pos, day_str);
     
     // Validation status (inline)
-    if(!is_valid_date(app->edit_year, app->edit_month, app->edit_day)) {
+    if(!date_is_valid_birth(app->edit_year, app->edit_month, app->edit_day)) {
         canvas_set_color(canvas, ColorBlack);
         canvas_draw_box(canvas, 70, y_pos - 1, 58, 10);
         canvas_set_color(canvas, ColorWhite);
@@ -0,0 +1,70 @@
+#include "screen_draw.h"
+#include "screens.h"
+#include "translations.h"
+#include <datetime/datetime.h>
+
+static bool has_duration(LogEventType type) {
+    return type == LogEventFeedingStop || type == LogEventSleepStop;
+}
+
+void draw_edit_event(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    bool is_new = (app->edit_event.id == 0);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(
+        canvas, 2, 10, tr_get(app, is_new ? TR_EVENT_ADD_TITLE : TR_EVENT_EDIT_TITLE));
+
+    canvas_set_font(canvas, FontSecondary);
+    int field = app->edit_event_field;
+    char line[40];
+
+    // Type (fixed once logged)
+    int y_pos = 24;
+    if(field == EditEventType) canvas_draw_str(canvas, 0, y_pos, ">");
+    snprintf(
+        line,
+        sizeof(line),
+        "%s %s",
+        tr_get(app, TR_EVENT_TYPE),
+        get_event_type_str(app, app->edit_event.type));
+    canvas_draw_str(canvas, 8, y_pos, line);
+
+    // Date and time, the part being changed underlined
+    y_pos = 36;
+    bool on_time = (field == EditEventDay || field == EditEventHour || field == EditEventMinute);
+    if(on_time) canvas_draw_str(canvas, 0, y_pos, ">");
+    DateTime dt;
+    datetime_timestamp_to_datetime(app->edit_event.timestamp, &dt);
+    snprintf(line, sizeof(line), "%02u-%02u %02u:%02u", dt.month, dt.day, dt.hour, dt.minute);
+    canvas_draw_str(canvas, 8, y_pos, line);
+    if(on_time) {
+        // "MM-DD" | "HH" | "MM"
+        size_t start = (field == EditEventDay) ? 0 : (field == EditEventHour) ? 6 : 9;
+        size_t len = (field == EditEventDay) ? 5 : 2;
+        char prefix[12];
+        snprintf(prefix, sizeof(prefix), "%.*s", (int)start, line);
+        int x = 8 + canvas_string_width(canvas, prefix);
+        snprintf(prefix, sizeof(prefix), "%.*s", (int)len, line + start);
+        canvas_draw_line(canvas, x, y_pos + 2, x + canvas_string_width(canvas, prefix) - 1, y_pos + 2);
+    }
+
+    // Duration
+    if(has_duration(app->edit_event.type)) {
+        y_pos = 48;
+        if(field == EditEventDuration) canvas_draw_str(canvas, 0, y_pos, ">");
+        snprintf(
+            line,
+            sizeof(line),
+            "%s %lu min",
+            tr_get(app, TR_EVENT_DUR),
+            (unsigned long)(app->edit_event.duration / 60));
+        canvas_draw_str(canvas, 8, y_pos, line);
+    }
+
+    if(app->edit_event_error) {
+        canvas_draw_str(canvas, 2, 62, tr_get(app, TR_EVENT_FULL));
+    } else {
+        canvas_draw_str(canvas, 2, 62, tr_get(app, TR_EVENT_HINT));
+    }
+}
@@ -0,0 +1,63 @@
+#include "screen_draw.h"
+#include "translations.h"
+
+// Progress bar spanning the screen width (shared with import)
+void draw_progress_bar(Canvas* canvas, int y, uint8_t percent) {
+    if(percent > 100) percent = 100;
+    canvas_draw_frame(canvas, 2, y, 124, 10);
+    canvas_draw_box(canvas, 4, y + 2, (120 * percent) / 100, 6);
+}
+
+void draw_export(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, tr_get(app, TR_EXPORT_TITLE));
+
+    canvas_set_font(canvas, FontSecondary);
+
+    if(app->export_status == JobIdle) {
+        // Format selection
+        const char* formats[2] = {"CSV", "JSON"};
+        for(int i = 0; i < 2; i++) {
+            int y = 24 + i * 12;
+            if(i == app->export_format) {
+                canvas_draw_str(canvas, 0, y, ">");
+            }
+            canvas_draw_str(canvas, 8, y, formats[i]);
+        }
+        char range[32];
+        if(app->export_days == 0) {
+            snprintf(range, sizeof(range), "< %s >", tr_get(app, TR_EXPORT_ALL));
+        } else {
+            snprintf(range, sizeof(range), "< %s %u %s >", tr_get(app, TR_EXPORT_LAST),
+                app->export_days, tr_get(app, TR_EXPORT_DAYS));
+        }
+        canvas_draw_str(canvas, 8, 48, range);
+        canvas_draw_str(canvas, 2, 56, tr_get(app, TR_EXPORT_START));
+        return;
+    }
+
+    if(app->export_status == JobRunning) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_RUNNING));
+
+        draw_progress_bar(canvas, 30, app->export_percent);
+
+        canvas_draw_str(canvas, 2, 56, tr_get(app, TR_EXPORT_CANCEL));
+        return;
+    }
+
+    // Finished
+    if(app->export_status == JobDone) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_DONE));
+        canvas_draw_str(canvas, 2, 36,
+            (app->export_format == ExportFormatJson) ? "baby_log/export.json" : "baby_log/export.csv");
+        char rows[32];
+        snprintf(rows, sizeof(rows), "%lu %s", (unsigned long)app->export_rows, tr_get(app, TR_EXPORT_ROWS));
+        canvas_draw_str(canvas, 2, 48, rows);
+    } else if(app->export_status == JobCancelled) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_CANCELLED));
+    } else {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_FAILED));
+    }
+}
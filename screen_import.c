@@ -0,0 +1,41 @@
+#include "screen_draw.h"
+#include "translations.h"
+
+void draw_import(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, tr_get(app, TR_IMPORT_TITLE));
+
+    canvas_set_font(canvas, FontSecondary);
+
+    if(app->import_status == JobIdle) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_IMPORT_SOURCE));
+        canvas_draw_str(canvas, 2, 36, "baby_log/import/log.jsonl");
+        canvas_draw_str(canvas, 2, 56, tr_get(app, TR_IMPORT_START));
+        return;
+    }
+
+    if(app->import_status == JobRunning) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_IMPORT_RUNNING));
+        draw_progress_bar(canvas, 30, app->import_percent);
+        canvas_draw_str(canvas, 2, 56, tr_get(app, TR_EXPORT_CANCEL));
+        return;
+    }
+
+    // Finished
+    if(app->import_status == JobDone) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_IMPORT_DONE));
+        char line[32];
+        snprintf(line, sizeof(line), "%lu %s", (unsigned long)app->import_added, tr_get(app, TR_IMPORT_ADDED));
+        canvas_draw_str(canvas, 2, 36, line);
+        snprintf(line, sizeof(line), "%lu %s", (unsigned long)app->import_dups, tr_get(app, TR_IMPORT_DUPS));
+        canvas_draw_str(canvas, 2, 48, line);
+    } else if(app->import_status == JobCancelled) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_EXPORT_CANCELLED));
+    } else if(app->import_deletes_full) {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_IMPORT_DELETES_FULL));
+    } else {
+        canvas_draw_str(canvas, 2, 24, tr_get(app, TR_IMPORT_FAILED));
+    }
+}
@@ -9,30 +9,30 @@ void draw_language(AppData* app, Canvas* canvas) {
     
     canvas_set_font(canvas, FontSecondary);
     
-    const char* languages[3] = {
-        tr_get(app, TR_LANG_ENGLISH),
-        tr_get(app, TR_LANG_RUSSIAN),
-        tr_get(app, TR_LANG_SPANISH)
-    };
+    // Endonyms from the pack headers, 4 rows visible
+    int count = tr_language_count();
+    int visible = (count < 4) ? count : 4;
+    int start = app->lang_index - visible + 1;
+    if(start < 0) start = 0;
     
     int start_y = 24;
     int line_height = 12;
     
-    for(int i = 0; i < 3; i++) {
+    for(int i = 0; i < visible; i++) {
+        int lang = start + i;
         int y = start_y + i * line_height;
         
         // Draw cursor
-        if(i == app->lang_index) {
+        if(lang == app->lang_index) {
             canvas_draw_str(canvas, 0, y, ">");
         }
         
         // Draw language name
-        canvas_draw_str(canvas, 8, y, languages[i]);
+        canvas_draw_str(canvas, 8, y, tr_language_name(lang));
         
         // Show checkmark for current language
-        if(i == app->cfg.language) {
+        if(lang == app->cfg.language) {
             canvas_draw_str(canvas, 110, y, "*");
         }
     }
 }
-
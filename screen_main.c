@@ -1,50 +1,9 @@
 #include "screen_draw.h"
 #include "log_store.h"
 #include "translations.h"
-#include <furi_hal_rtc.h>
-#include <datetime/datetime.h>
-
-// Animation frame counter (global to persist between draws)
-static uint8_t g_anim_frame = 0;
-
-// Calculate age in days
-static uint32_t calculate_age_days(AppData* app) {
-    DateTime now;
-    furi_hal_rtc_get_datetime(&now);
-    
-    uint32_t now_days = now.year * 365 + now.month * 30 + now.day;
-    uint32_t birth_days = app->cfg.birth_y * 365 + app->cfg.birth_m * 30 + app->cfg.birth_d;
-    
-    if(now_days >= birth_days) {
-        return now_days - birth_days;
-    }
-    return 0;
-}
-
-// Format age string as "Xm Yd" (months and days)
-static void format_age(AppData* app, char* out, size_t out_size) {
-    uint32_t total_days = calculate_age_days(app);
-    uint32_t months = total_days / 30;
-    uint32_t days = total_days % 30;
-    
-    if(months == 0) {
-        snprintf(out, out_size, "%lud", (unsigned long)days);
-    } else {
-        snprintf(out, out_size, "%lum %lud", (unsigned long)months, (unsigned long)days);
-    }
-}
-
-// Format duration string (minutes)
-static void format_duration(uint32_t seconds, char* out, size_t out_size) {
-    uint32_t minutes = seconds / 60;
-    if(minutes < 60) {
-        snprintf(out, out_size, "%lum", (unsigned long)minutes);
-    } else {
-        uint32_t hours = minutes / 60;
-        minutes = minutes % 60;
-        snprintf(out, out_size, "%luh%lum", (unsigned long)hours, (unsigned long)minutes);
-    }
-}
+#include "tick.h"
+#include "age.h"
+#include "render_cache.h"
 
 // ==== BIRD ANIMATIONS ====
 // All birds drawn at position (x, y) which is top-left of ~16x14 area
@@ -209,60 +168,46 @@ static void draw_bird_diaper(Canvas* canvas, int x, int y, uint8_t frame) {
 void draw_main(AppData* app, Canvas* canvas) {
     canvas_clear(canvas);
     
-    // Increment animation frame
-    g_anim_frame++;
+    // Animation frame from the clock, so extra redraws don't speed it up
+    uint8_t anim_frame = tick_anim_frame();
     
     // Child name (top left)
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str(canvas, 2, 10, app->cfg.name);
     
     // Age (top right area)
-    char age_str[16];
-    format_age(app, age_str, sizeof(age_str));
-    canvas_draw_str(canvas, 80, 10, age_str);
+    canvas_draw_str(canvas, 80, 10, age_short(app));
     
     // Draw animated bird based on state (right side of screen)
     int bird_x = 100;
     int bird_y = 16;
     
-    uint32_t now = log_get_timestamp();
+    uint32_t now = app->now; // From the loop tick, see AppData
     bool show_diaper_feedback = (app->state.last_diaper_ts > 0 && 
         now >= app->state.last_diaper_ts && 
-        (now - app->state.last_diaper_ts) < 3);
+        (now - app->state.last_diaper_ts) < DIAPER_FEEDBACK_SECONDS);
     
     if(show_diaper_feedback) {
-        draw_bird_diaper(canvas, bird_x, bird_y, g_anim_frame);
+        draw_bird_diaper(canvas, bird_x, bird_y, anim_frame);
     } else if(app->state.feeding_active) {
-        draw_bird_feeding(canvas, bird_x, bird_y, g_anim_frame);
+        draw_bird_feeding(canvas, bird_x, bird_y, anim_frame);
     } else if(app->state.sleep_active) {
-        draw_bird_sleeping(canvas, bird_x, bird_y, g_anim_frame);
+        draw_bird_sleeping(canvas, bird_x, bird_y, anim_frame);
     } else {
-        draw_bird_awake(canvas, bird_x, bird_y, g_anim_frame);
+        draw_bird_awake(canvas, bird_x, bird_y, anim_frame);
     }
     
     // Status text (below name)
     canvas_set_font(canvas, FontSecondary);
     int y_pos = 24;
     
-    if(app->state.feeding_active) {
-        uint32_t duration = (now > app->state.feeding_start_ts) ? 
-            (now - app->state.feeding_start_ts) : 0;
-        char dur_str[16];
-        format_duration(duration, dur_str, sizeof(dur_str));
-        char status[32];
-        snprintf(status, sizeof(status), "%s %s", tr_get(app, TR_MAIN_FEEDING), dur_str);
-        canvas_draw_str(canvas, 2, y_pos, status);
-    } else if(app->state.sleep_active) {
-        uint32_t duration = (now > app->state.sleep_start_ts) ? 
-            (now - app->state.sleep_start_ts) : 0;
-        char dur_str[16];
-        format_duration(duration, dur_str, sizeof(dur_str));
-        char status[32];
-        snprintf(status, sizeof(status), "%s %s", tr_get(app, TR_MAIN_SLEEPING), dur_str);
-        canvas_draw_str(canvas, 2, y_pos, status);
-    } else {
-        canvas_draw_str(canvas, 2, y_pos, tr_get(app, TR_MAIN_AWAKE));
-    }
+    canvas_draw_str(canvas, 2, y_pos, render_main_status(app, now));
+    
+    // Forecast from the feed rhythm, none while feeding; time since the
+    // last diaper when there is no forecast
+    const char* second = app->state.feeding_active ? "" : render_main_forecast(app);
+    if(second[0] == '\0') second = render_main_diaper(app, now);
+    canvas_draw_str(canvas, 2, y_pos + 10, second);
     
     // Quick actions at bottom
     canvas_set_font(canvas, FontSecondary);
@@ -284,6 +229,13 @@ void draw_main(AppData* app, Canvas* canvas) {
     canvas_draw_str(canvas, 54, 56, "B:");
     canvas_draw_str(canvas, 66, 56, tr_get(app, TR_MAIN_MENU_LABEL));
     
+    // RIGHT arrow + child number when there are several
+    if(app->child_count > 1) {
+        canvas_draw_line(canvas, 104, 50, 110, 53);
+        canvas_draw_line(canvas, 104, 56, 110, 53);
+        canvas_draw_str(canvas, 113, 56, render_main_child(app));
+    }
+    
     // Diaper feedback text overlay
     if(show_diaper_feedback) {
         canvas_set_color(canvas, ColorBlack);
@@ -292,4 +244,23 @@ void draw_main(AppData* app, Canvas* canvas) {
         canvas_draw_str(canvas, 4, 39, tr_get(app, TR_MAIN_DIAPER_LOGGED));
         canvas_set_color(canvas, ColorBlack);
     }
+    
+    // Reminder banner: which child it is for, until the next key
+    if(app->remind_alert) {
+        static const TranslationKey alert_keys[ReminderCount] = {
+            [ReminderFeed] = TR_ALERT_FEED,
+            [ReminderDiaper] = TR_ALERT_DIAPER,
+            [ReminderSleep] = TR_ALERT_SLEEP,
+        };
+        const char* name = (app->remind_alert_child == app->active_child) ?
+                               app->cfg.name :
+                               app->children[app->remind_alert_child].cfg.name;
+        char line[48];
+        snprintf(line, sizeof(line), "%s: %s", name, tr_get(app, alert_keys[app->remind_alert_kind]));
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_box(canvas, 0, 27, 128, 14);
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_str(canvas, 3, 37, line);
+        canvas_set_color(canvas, ColorBlack);
+    }
 }
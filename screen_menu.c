@@ -1,24 +1,36 @@
 #include "screen_draw.h"
+#include "screens.h"
 #include "translations.h"
 
-#define MENU_ITEMS 6
+#define MENU_ITEMS MenuItemCount
 
 void draw_menu(AppData* app, Canvas* canvas) {
     canvas_clear(canvas);
     
     canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 2, 10, "Menu");
+    if(app->delete_refused) {
+        canvas_draw_str(canvas, 2, 10, tr_get(app, TR_MENU_DELETE_FULL));
+    } else {
+        canvas_draw_str(canvas, 2, 10, "Menu");
+    }
     
     canvas_set_font(canvas, FontSecondary);
     
-    // Menu items: Profile, Recent log, Delete last, Clear all, Language, Exit
     const char* menu_items[MENU_ITEMS] = {
-        tr_get(app, TR_MENU_PROFILE),
-        tr_get(app, TR_MENU_RECENT_LOG),
-        tr_get(app, TR_MENU_DELETE_LAST),
-        tr_get(app, TR_MENU_CLEAR_ALL),
-        tr_get(app, TR_MENU_LANGUAGE),
-        tr_get(app, TR_MENU_EXIT)
+        [MenuItemProfile] = tr_get(app, TR_MENU_PROFILE),
+        [MenuItemAddChild] = tr_get(app, TR_MENU_ADD_CHILD),
+        [MenuItemRecentLog] = tr_get(app, TR_MENU_RECENT_LOG),
+        [MenuItemAddPast] = tr_get(app, TR_MENU_ADD_PAST),
+        [MenuItemExport] = tr_get(app, TR_MENU_EXPORT),
+        [MenuItemImport] = tr_get(app, TR_MENU_IMPORT),
+        [MenuItemDeleteLast] = tr_get(app, TR_MENU_DELETE_LAST),
+        [MenuItemUndo] = tr_get(app, TR_MENU_UNDO),
+        [MenuItemRedo] = tr_get(app, TR_MENU_REDO),
+        [MenuItemClearAll] = tr_get(app, TR_MENU_CLEAR_ALL),
+        [MenuItemCheck] = tr_get(app, TR_MENU_CHECK),
+        [MenuItemReminders] = tr_get(app, TR_MENU_REMINDERS),
+        [MenuItemLanguage] = tr_get(app, TR_MENU_LANGUAGE),
+        [MenuItemExit] = tr_get(app, TR_MENU_EXIT),
     };
     
     int start_y = 24;
@@ -45,8 +57,8 @@ void draw_menu(AppData* app, Canvas* canvas) {
         canvas_draw_str(canvas, 8, y, menu_items[idx]);
     }
     
-    // Scroll indicator
-    if(MENU_ITEMS > visible_count) {
+    // Scroll indicator, the refusal notice takes its place
+    if(MENU_ITEMS > visible_count && !app->delete_refused) {
         char scroll[16];
         snprintf(scroll, sizeof(scroll), "%d/%d", app->menu_index + 1, MENU_ITEMS);
         canvas_draw_str(canvas, 100, 10, scroll);
@@ -1,19 +1,10 @@
 #include "screen_draw.h"
 #include "translations.h"
-#include <furi_hal_rtc.h>
-#include <datetime/datetime.h>
-
-// Format time from timestamp (simplified - show relative or HH:MM)
-static void format_time(uint32_t ts, char* out, size_t out_size) {
-    UNUSED(ts);
-    // Use current time approximation
-    DateTime now;
-    furi_hal_rtc_get_datetime(&now);
-    snprintf(out, out_size, "%02u:%02u", now.hour, now.minute);
-}
+#include "log_store.h"
+#include "render_cache.h"
 
 // Get event type string (translated)
-static const char* get_event_type_str(AppData* app, LogEventType type) {
+const char* get_event_type_str(AppData* app, LogEventType type) {
     switch(type) {
         case LogEventDiaper: return tr_get(app, TR_LOG_DIAPER);
         case LogEventFeedingStart: return tr_get(app, TR_LOG_FEED_START);
@@ -24,18 +15,6 @@ static const char* get_event_type_str(AppData* app, LogEventType type) {
     }
 }
 
-// Format duration for stop events
-static void format_duration(uint32_t seconds, char* out, size_t out_size) {
-    uint32_t minutes = seconds / 60;
-    if(minutes < 60) {
-        snprintf(out, out_size, "%lum", (unsigned long)minutes);
-    } else {
-        uint32_t hours = minutes / 60;
-        minutes = minutes % 60;
-        snprintf(out, out_size, "%luh%lum", (unsigned long)hours, (unsigned long)minutes);
-    }
-}
-
 void draw_recent_log(AppData* app, Canvas* canvas) {
     if(!app || !canvas) return;
     
@@ -75,37 +54,19 @@ void draw_recent_log(AppData* app, Canvas* canvas) {
     for(int i = 0; i < visible_count; i++) {
         int idx = start_idx + i;
         
-        // Extra bounds checking
-        if(idx < 0 || idx >= app->log_count || idx >= MAX_LOG_ENTRIES) {
-            break;
-        }
-        
-        LogEntry* entry = &app->log_entries[idx];
-        if(!entry) break;
-        
-        char time_str[16];
-        format_time(entry->timestamp, time_str, sizeof(time_str));
+        if(!log_recent_get(app, idx)) break;
+        const char* line = render_log_row(app, idx);
         
-        const char* type_str = get_event_type_str(app, entry->type);
-        if(!type_str) type_str = "?";
-        
-        char line[64];
-        if(entry->duration > 0 && 
-           (entry->type == LogEventFeedingStop || entry->type == LogEventSleepStop)) {
-            char dur_str[16];
-            format_duration(entry->duration, dur_str, sizeof(dur_str));
-            snprintf(line, sizeof(line), "%s %s %s", time_str, type_str, dur_str);
-        } else {
-            snprintf(line, sizeof(line), "%s %s", time_str, type_str);
+        if(idx == app->log_index) {
+            canvas_draw_str(canvas, 0, y_pos + i * line_height, ">"); // OK edits this one
         }
-        
-        canvas_draw_str(canvas, 2, y_pos + i * line_height, line);
+        canvas_draw_str(canvas, 8, y_pos + i * line_height, line);
     }
     
-    // Scroll indicator (only if more than visible)
+    // Position indicator (only if more than visible)
     if(app->log_count > visible_count) {
         char scroll_str[24];
-        snprintf(scroll_str, sizeof(scroll_str), "%d/%d", start_idx + 1, app->log_count);
+        snprintf(scroll_str, sizeof(scroll_str), "%d/%d", app->log_index + 1, app->log_count);
         canvas_draw_str(canvas, 100, 10, scroll_str);
     }
 }
@@ -0,0 +1,44 @@
+#include "screen_draw.h"
+#include "translations.h"
+
+void draw_reminders(AppData* app, Canvas* canvas) {
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, tr_get(app, TR_REMIND_TITLE));
+
+    canvas_set_font(canvas, FontSecondary);
+
+    const char* labels[ReminderCount] = {
+        [ReminderFeed] = tr_get(app, TR_REMIND_FEED),
+        [ReminderDiaper] = tr_get(app, TR_REMIND_DIAPER),
+        [ReminderSleep] = tr_get(app, TR_REMIND_SLEEP),
+    };
+
+    int start_y = 24;
+    int line_height = 11;
+
+    for(int i = 0; i < ReminderCount; i++) {
+        int y = start_y + i * line_height;
+
+        // Draw cursor
+        if(i == app->remind_index) {
+            canvas_draw_str(canvas, 0, y, ">");
+        }
+
+        canvas_draw_str(canvas, 8, y, labels[i]);
+
+        uint16_t minutes = app->remind_minutes[i];
+        char value[12];
+        if(minutes == 0) {
+            snprintf(value, sizeof(value), "%s", tr_get(app, TR_REMIND_OFF));
+        } else if(minutes % 60 == 0) {
+            snprintf(value, sizeof(value), "%uh", minutes / 60);
+        } else {
+            snprintf(value, sizeof(value), "%uh%02u", minutes / 60, minutes % 60);
+        }
+        canvas_draw_str(canvas, 100, y, value);
+    }
+
+    canvas_draw_str(canvas, 2, 62, tr_get(app, TR_REMIND_HINT));
+}
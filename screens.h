@@ -8,4 +8,39 @@ typedef enum {
     ScreenEditBirthDate,
     ScreenRecentLog,
     ScreenLanguage,
+    ScreenExport,
+    ScreenImport,
+    ScreenEditEvent,
+    ScreenCheck,
+    ScreenReminders,
+    ScreenDiag, // Hidden: Right on the menu
 } Screen;
+
+// Main menu entries, in display order
+typedef enum {
+    MenuItemProfile = 0,
+    MenuItemAddChild,
+    MenuItemRecentLog,
+    MenuItemAddPast,
+    MenuItemExport,
+    MenuItemImport,
+    MenuItemDeleteLast,
+    MenuItemUndo,
+    MenuItemRedo,
+    MenuItemClearAll,
+    MenuItemCheck,
+    MenuItemReminders,
+    MenuItemLanguage,
+    MenuItemExit,
+    MenuItemCount,
+} MenuItem;
+
+// Fields of ScreenEditEvent, left to right
+typedef enum {
+    EditEventType = 0, // New events only
+    EditEventDay,
+    EditEventHour,
+    EditEventMinute,
+    EditEventDuration, // Stop events only
+    EditEventFieldCount,
+} EditEventField;
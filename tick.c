@@ -0,0 +1,58 @@
+#include "tick.h"
+#include "log_stats.h"
+#include "clock.h"
+#include <furi.h>
+
+#define SECONDS_PER_DAY 86400
+
+uint8_t tick_anim_frame(void) {
+    return (uint8_t)(clock_now_ms() / TICK_ANIM_FRAME_MS);
+}
+
+// Seconds until a running duration rolls over to the next minute. Waiting
+// the full remainder means the wake-up is never early - at most 1 s late,
+// as the RTC has no sub-second phase.
+static uint32_t minute_rollover(uint32_t now, uint32_t start_ts) {
+    uint32_t elapsed = (now > start_ts) ? now - start_ts : 0;
+    return 60 - elapsed % 60;
+}
+
+uint32_t tick_next_delay(
+    const AppData* app,
+    bool main_screen,
+    uint32_t now,
+    uint32_t now_ms,
+    uint32_t last_input_ms) {
+    if(!main_screen) return FuriWaitForever;
+
+    // Age changes at midnight (timestamps are local time)
+    uint32_t next_s = SECONDS_PER_DAY - now % SECONDS_PER_DAY;
+
+    if(app->state.feeding_active) {
+        next_s = MIN(next_s, minute_rollover(now, app->state.feeding_start_ts));
+    }
+    if(app->state.sleep_active) {
+        next_s = MIN(next_s, minute_rollover(now, app->state.sleep_start_ts));
+    }
+    // "Fed 45m ago" while awake, "Diaper 2h ago" in place of a missing forecast
+    if(!app->state.feeding_active && !app->state.sleep_active &&
+       app->last[LogEventFeedingStop].ts > 0) {
+        next_s = MIN(next_s, minute_rollover(now, app->last[LogEventFeedingStop].ts));
+    }
+    uint32_t forecast = app->state.feeding_active ? 0 :
+                        app->state.sleep_active   ? log_stats_wake_at(app) :
+                                                    log_stats_next_feed(app);
+    if(forecast == 0 && app->last[LogEventDiaper].ts > 0) {
+        next_s = MIN(next_s, minute_rollover(now, app->last[LogEventDiaper].ts));
+    }
+    if(app->state.last_diaper_ts > 0 && now >= app->state.last_diaper_ts) {
+        uint32_t expiry = app->state.last_diaper_ts + DIAPER_FEEDBACK_SECONDS;
+        next_s = MIN(next_s, (expiry > now) ? expiry - now : 1);
+    }
+
+    uint32_t delay = next_s * 1000;
+    if(now_ms - last_input_ms < TICK_ANIM_ACTIVE_MS) {
+        delay = MIN(delay, TICK_ANIM_FRAME_MS - now_ms % TICK_ANIM_FRAME_MS);
+    }
+    return delay;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "app_state.h"
+
+// ==== TICK SCHEDULING ====
+// The main loop sleeps until the next instant the screen can actually change
+// instead of redrawing every second. Durations and age only show minutes and
+// days, so while timers run or a "time since" is shown that is one wake-up
+// per minute; the bird is only animated while the backlight is likely on
+// after a key press.
+
+#define TICK_ANIM_FRAME_MS 1000
+#define TICK_ANIM_ACTIVE_MS 30000 // Default backlight timeout
+#define DIAPER_FEEDBACK_SECONDS 3
+
+uint8_t tick_anim_frame(void);
+
+// Milliseconds until the main screen next changes, FuriWaitForever if it
+// never does on its own. now is clock_now(), now_ms/last_input_ms
+// come from clock_now_ms().
+uint32_t tick_next_delay(
+    const AppData* app,
+    bool main_screen,
+    uint32_t now,
+    uint32_t now_ms,
+    uint32_t last_input_ms);
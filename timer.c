@@ -0,0 +1,50 @@
+#include "timer.h"
+
+// Seconds since start, 0 if the clock was set back since
+static uint32_t elapsed(uint32_t start_ts, uint32_t now) {
+    return (now > start_ts) ? (now - start_ts) : 0;
+}
+
+static void step_add(TimerStep* step, LogEventType type, uint32_t duration) {
+    step->events[step->count].type = type;
+    step->events[step->count].duration = duration;
+    step->count++;
+}
+
+static void feeding_stop(AppState* state, TimerStep* step, uint32_t now) {
+    step_add(step, LogEventFeedingStop, elapsed(state->feeding_start_ts, now));
+    state->feeding_active = false;
+}
+
+static void sleep_stop(AppState* state, TimerStep* step, uint32_t now) {
+    step_add(step, LogEventSleepStop, elapsed(state->sleep_start_ts, now));
+    state->sleep_active = false;
+}
+
+TimerStep timer_step(AppState* state, TimerKey key, uint32_t now) {
+    TimerStep step = {0};
+    if(key == TimerKeyFeed) {
+        if(state->feeding_active) {
+            // Stop feeding - go to awake
+            feeding_stop(state, &step, now);
+        } else {
+            // Start feeding - stop sleep first if active
+            if(state->sleep_active) sleep_stop(state, &step, now);
+            state->feeding_start_ts = now;
+            state->feeding_active = true;
+            step_add(&step, LogEventFeedingStart, 0);
+        }
+    } else {
+        if(state->sleep_active) {
+            // Stop sleep - go to awake
+            sleep_stop(state, &step, now);
+        } else {
+            // Start sleep - stop feeding first if active
+            if(state->feeding_active) feeding_stop(state, &step, now);
+            state->sleep_start_ts = now;
+            state->sleep_active = true;
+            step_add(&step, LogEventSleepStart, 0);
+        }
+    }
+    return step;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "app_state.h"
+
+// ==== FEED/SLEEP TIMERS ====
+// The main screen's timer keys as a pure transition on AppState. Feeding
+// and sleeping are mutually exclusive: starting one stops the other. The
+// events to log come back in the order they happened; the caller logs them
+// and saves the state.
+
+typedef enum {
+    TimerKeyFeed, // Up
+    TimerKeySleep, // Down
+} TimerKey;
+
+typedef struct {
+    LogEventType type;
+    uint32_t duration; // For stop events
+} TimerEvent;
+
+typedef struct {
+    uint8_t count;
+    TimerEvent events[2]; // At most a stop and a start
+} TimerStep;
+
+TimerStep timer_step(AppState* state, TimerKey key, uint32_t now);
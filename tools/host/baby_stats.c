@@ -0,0 +1,670 @@
+// baby_stats - summaries of a Baby Log directory copied off the SD card.
+//
+// Reads archive/seg_*.bin, log.jsonl, deleted.jsonl and patches.jsonl the
+// same way the app does: segments oldest first, then the log, tombstones
+// and patches applied. Records are decoded by the firmware's own
+// log_codec.c, so the tool cannot drift from the on-card formats.
+// Files are memory-mapped; segments and slices of log.jsonl are decoded
+// on parallel threads and merged by time.
+//
+// Build: make -C tools/host
+// Usage: baby_stats [-d|-w|-s|-c] [-j threads] [-t] <dir>
+
+#include "log_codec.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SECONDS_PER_DAY 86400
+#define JSONL_SLICE_MIN (256 * 1024) // Smaller logs are not worth splitting
+#define MAX_THREADS 64
+
+// Same values as log_patch.h - that header needs the firmware storage API
+#define PATCH_ADDED 0x01
+#define PATCH_MOVED 0x02
+#define PATCH_DUR 0x04
+
+typedef enum {
+    ReportDaily = 0,
+    ReportWeekly,
+    ReportSleep,
+    ReportCsv,
+} Report;
+
+// ==== MAPPED FILES ====
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} Mapped;
+
+// False if the file does not exist; an empty file maps to size 0
+static bool map_file(const char* path, Mapped* map) {
+    map->data = NULL;
+    map->size = 0;
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        if(errno != ENOENT) fprintf(stderr, "baby_stats: %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if(ok && st.st_size > 0) {
+        void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ok = data != MAP_FAILED;
+        if(ok) {
+            madvise(data, st.st_size, MADV_SEQUENTIAL);
+            map->data = data;
+            map->size = st.st_size;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+static void unmap_file(Mapped* map) {
+    if(map->data) munmap((void*)map->data, map->size);
+    map->data = NULL;
+    map->size = 0;
+}
+
+// Calls fn for every line, copied and NUL-terminated. Lines longer than
+// anything the app writes are counted as damaged.
+static void for_each_line(
+    const uint8_t* data,
+    size_t size,
+    void (*fn)(const char* line, void* context),
+    void* context,
+    size_t* damaged) {
+    char line[LOG_LINE_MAX + 32];
+    size_t pos = 0;
+    while(pos < size) {
+        const uint8_t* end = memchr(data + pos, '\n', size - pos);
+        size_t len = end ? (size_t)(end - (data + pos)) : size - pos;
+        size_t next = pos + len + 1;
+        if(len > 0 && data[pos + len - 1] == '\r') len--;
+        if(len >= sizeof(line)) {
+            (*damaged)++;
+        } else if(len > 0) {
+            memcpy(line, data + pos, len);
+            line[len] = '\0';
+            fn(line, context);
+        }
+        pos = next;
+    }
+}
+
+// ==== RECORDS ====
+
+typedef struct {
+    LogRecord* items;
+    size_t count;
+    size_t capacity;
+} RecordVec;
+
+static void vec_push(RecordVec* vec, const LogRecord* rec) {
+    if(vec->count == vec->capacity) {
+        vec->capacity = vec->capacity ? vec->capacity * 2 : 256;
+        vec->items = realloc(vec->items, vec->capacity * sizeof(LogRecord));
+        if(!vec->items) {
+            fprintf(stderr, "baby_stats: out of memory\n");
+            exit(1);
+        }
+    }
+    vec->items[vec->count++] = *rec;
+}
+
+// ==== SCAN TASKS ====
+// One task per segment and per slice of log.jsonl. Tasks only touch their
+// own output, so workers need no locking beyond taking the next task.
+
+typedef enum {
+    TaskSegment = 0,
+    TaskJsonl,
+} TaskKind;
+
+typedef struct {
+    TaskKind kind;
+    const char* name;
+    const uint8_t* data;
+    size_t size;
+    RecordVec out;
+    size_t damaged;
+} ScanTask;
+
+// Mirrors the segment reader in log_archive.c
+static void scan_segment(ScanTask* task) {
+    const uint8_t* data = task->data;
+    size_t size = task->size;
+    if(size < LOG_ARCHIVE_HEADER_SIZE + LOG_ARCHIVE_FOOTER_SIZE ||
+       memcmp(data, LOG_ARCHIVE_MAGIC, 4) != 0 ||
+       memcmp(data + size - 4, LOG_ARCHIVE_FOOTER_MAGIC, 4) != 0) {
+        fprintf(stderr, "baby_stats: %s: not a segment, skipped\n", task->name);
+        task->damaged++;
+        return;
+    }
+
+    size_t data_end = log_get_u32(data + size - LOG_ARCHIVE_FOOTER_SIZE);
+    if(data_end > size) data_end = size;
+
+    size_t offset = LOG_ARCHIVE_HEADER_SIZE;
+    while(offset + LOG_BLOCK_HEADER_SIZE <= data_end) {
+        const uint8_t* block = data + offset;
+        size_t payload_len = log_get_u16(block);
+        uint8_t block_records = block[2];
+        size_t rest = payload_len + 2 * (size_t)block[3];
+        uint32_t base_ts = log_get_u32(block + 4);
+        if(LOG_BLOCK_HEADER_SIZE + rest > LOG_BLOCK_MAX_SIZE ||
+           offset + LOG_BLOCK_HEADER_SIZE + rest > data_end) {
+            task->damaged++;
+            break;
+        }
+
+        const uint8_t* payload = block + LOG_BLOCK_HEADER_SIZE;
+        size_t pos = 0;
+        uint32_t prev_ts = base_ts;
+        LogRecord rec;
+        for(uint8_t i = 0; i < block_records; i++) {
+            if(i % LOG_BLOCK_RESTART_INTERVAL == 0) prev_ts = base_ts;
+            size_t len = log_record_decode(payload + pos, payload_len - pos, prev_ts, &rec);
+            if(len == 0) {
+                task->damaged++;
+                break;
+            }
+            pos += len;
+            prev_ts = rec.ts;
+            vec_push(&task->out, &rec);
+        }
+        offset += LOG_BLOCK_HEADER_SIZE + rest;
+    }
+}
+
+static void jsonl_line(const char* line, void* context) {
+    ScanTask* task = context;
+    LogRecord rec;
+    if(log_parse_record(line, &rec)) {
+        vec_push(&task->out, &rec);
+    } else {
+        task->damaged++;
+    }
+}
+
+static void scan_jsonl(ScanTask* task) {
+    for_each_line(task->data, task->size, jsonl_line, task, &task->damaged);
+}
+
+typedef struct {
+    ScanTask* tasks;
+    size_t count;
+    atomic_size_t next;
+} TaskQueue;
+
+static void* scan_worker(void* context) {
+    TaskQueue* queue = context;
+    size_t index;
+    while((index = atomic_fetch_add(&queue->next, 1)) < queue->count) {
+        ScanTask* task = &queue->tasks[index];
+        if(task->kind == TaskSegment) {
+            scan_segment(task);
+        } else {
+            scan_jsonl(task);
+        }
+    }
+    return NULL;
+}
+
+static void scan_all(ScanTask* tasks, size_t count, int threads) {
+    TaskQueue queue = {.tasks = tasks, .count = count};
+    atomic_init(&queue.next, 0);
+    if(threads > (int)count) threads = (int)count;
+    if(threads <= 1) {
+        scan_worker(&queue);
+        return;
+    }
+
+    pthread_t ids[MAX_THREADS];
+    int started = 0;
+    for(int i = 0; i < threads; i++) {
+        if(pthread_create(&ids[i], NULL, scan_worker, &queue) != 0) break;
+        started++;
+    }
+    if(started == 0) scan_worker(&queue);
+    for(int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+}
+
+// ==== TOMBSTONES AND PATCHES ====
+// Keyed by log_hash_id(), like the app's own sets
+
+typedef enum {
+    SlotEmpty = 0,
+    SlotUsed,
+    SlotRemoved, // Keeps probe chains intact
+} SlotState;
+
+typedef struct {
+    uint32_t hash;
+    uint8_t state; // SlotState
+    uint8_t flags; // Patches: PATCH_*
+    uint8_t seen; // Patches: replaced a scanned record
+    LogRecord rec; // Patches only
+} IdSlot;
+
+typedef struct {
+    IdSlot* slots;
+    size_t capacity; // Power of two
+    size_t occupied; // Used and removed slots
+    size_t count; // Used slots
+} IdSet;
+
+static IdSlot* set_find(IdSet* set, uint32_t hash, bool insert) {
+    if(insert && (set->occupied + 1) * 2 > set->capacity) {
+        IdSet grown = {.capacity = set->capacity ? set->capacity * 2 : 256};
+        grown.slots = calloc(grown.capacity, sizeof(IdSlot));
+        if(!grown.slots) {
+            fprintf(stderr, "baby_stats: out of memory\n");
+            exit(1);
+        }
+        for(size_t i = 0; i < set->capacity; i++) {
+            if(set->slots[i].state == SlotUsed) *set_find(&grown, set->slots[i].hash, true) = set->slots[i];
+        }
+        free(set->slots);
+        *set = grown;
+    }
+    if(set->capacity == 0) return NULL;
+
+    size_t mask = set->capacity - 1;
+    for(size_t i = hash & mask;; i = (i + 1) & mask) {
+        IdSlot* slot = &set->slots[i];
+        if(slot->state == SlotUsed && slot->hash == hash) return slot;
+        if(slot->state == SlotEmpty) {
+            if(!insert) return NULL;
+            memset(slot, 0, sizeof(IdSlot));
+            slot->state = SlotUsed;
+            slot->hash = hash;
+            set->occupied++;
+            set->count++;
+            return slot;
+        }
+    }
+}
+
+static void set_remove(IdSet* set, uint32_t hash) {
+    IdSlot* slot = set_find(set, hash, false);
+    if(!slot) return;
+    slot->state = SlotRemoved;
+    set->count--;
+}
+
+static void tombstone_line(const char* line, void* context) {
+    IdSet* tombstones = context;
+    char id[LOG_ID_LEN + 1];
+    if(!log_line_check(line) || !log_parse_id(line, id)) return;
+    uint32_t hash = log_hash_id(id);
+    if(log_parse_op(line) == JournalOpRestore) {
+        set_remove(tombstones, hash);
+    } else {
+        set_find(tombstones, hash, true);
+    }
+}
+
+// Newest line per ID wins, as in log_patch.c
+static void patch_line(const char* line, void* context) {
+    IdSet* patches = context;
+    LogRecord rec;
+    if(!log_parse_record(line, &rec) || rec.ts == 0) return;
+    uint8_t flags = PATCH_DUR;
+    if(strstr(line, "\"op\":\"add\"")) {
+        flags = PATCH_ADDED;
+    } else if(strstr(line, "\"field\":\"ts\"")) {
+        flags = PATCH_MOVED;
+    }
+    IdSlot* slot = set_find(patches, log_hash_id(rec.id), true);
+    slot->flags |= flags;
+    slot->rec = rec;
+}
+
+static bool is_deleted(IdSet* tombstones, const char* id) {
+    return set_find(tombstones, log_hash_id(id), false) != NULL;
+}
+
+// ==== MERGE ====
+
+typedef struct {
+    LogRecord rec;
+    size_t order; // Keeps equal timestamps in file order
+} Event;
+
+static int event_compare(const void* a, const void* b) {
+    const Event* x = a;
+    const Event* y = b;
+    if(x->rec.ts != y->rec.ts) return (x->rec.ts < y->rec.ts) ? -1 : 1;
+    return (x->order < y->order) ? -1 : (x->order > y->order);
+}
+
+static Event* merge_events(ScanTask* tasks, size_t task_count, IdSet* tombstones, IdSet* patches, size_t* out_count) {
+    size_t total = patches->count;
+    for(size_t i = 0; i < task_count; i++) {
+        total += tasks[i].out.count;
+    }
+    Event* events = malloc((total ? total : 1) * sizeof(Event));
+    if(!events) {
+        fprintf(stderr, "baby_stats: out of memory\n");
+        exit(1);
+    }
+
+    size_t count = 0;
+    for(size_t i = 0; i < task_count; i++) {
+        for(size_t j = 0; j < tasks[i].out.count; j++) {
+            const LogRecord* rec = &tasks[i].out.items[j];
+            if(rec->ts == 0 || is_deleted(tombstones, rec->id)) continue;
+            IdSlot* patch = set_find(patches, log_hash_id(rec->id), false);
+            if(patch) {
+                patch->seen = 1;
+                rec = &patch->rec;
+            }
+            events[count].rec = *rec;
+            events[count].order = count;
+            count++;
+        }
+    }
+    // Added events, and moved ones whose original is gone
+    for(size_t i = 0; i < patches->capacity; i++) {
+        IdSlot* patch = &patches->slots[i];
+        if(patch->state != SlotUsed || patch->seen || !(patch->flags & (PATCH_ADDED | PATCH_MOVED))) continue;
+        if(is_deleted(tombstones, patch->rec.id)) continue;
+        events[count].rec = patch->rec;
+        events[count].order = count;
+        count++;
+    }
+
+    qsort(events, count, sizeof(Event), event_compare);
+    *out_count = count;
+    return events;
+}
+
+// ==== REPORTS ====
+
+typedef struct {
+    uint32_t feeds;
+    uint32_t feed_seconds;
+    uint32_t sleeps;
+    uint32_t sleep_seconds;
+    uint32_t diapers;
+} Totals;
+
+static void totals_add(Totals* totals, const LogRecord* rec) {
+    switch(rec->type) {
+    case LogEventFeedingStart: totals->feeds++; break;
+    case LogEventFeedingStop: totals->feed_seconds += rec->duration; break;
+    case LogEventSleepStop:
+        totals->sleeps++;
+        totals->sleep_seconds += rec->duration;
+        break;
+    case LogEventDiaper: totals->diapers++; break;
+    default: break;
+    }
+}
+
+static void format_date(uint32_t day, char* out, size_t out_size) {
+    char ts[LOG_TS_STR_LEN];
+    log_format_ts(day * SECONDS_PER_DAY, ts, sizeof(ts));
+    snprintf(out, out_size, "%.10s", ts);
+}
+
+// Durations are counted on the day (or week) their stop event falls in
+static void report_daily(const Event* events, size_t count) {
+    printf("date        feeds  feed_min  sleeps  sleep_min  diapers\n");
+    size_t i = 0;
+    while(i < count) {
+        uint32_t day = events[i].rec.ts / SECONDS_PER_DAY;
+        Totals totals = {0};
+        for(; i < count && events[i].rec.ts / SECONDS_PER_DAY == day; i++) {
+            totals_add(&totals, &events[i].rec);
+        }
+        char date[16];
+        format_date(day, date, sizeof(date));
+        printf("%s  %5u  %8u  %6u  %9u  %7u\n",
+            date, totals.feeds, totals.feed_seconds / 60, totals.sleeps,
+            totals.sleep_seconds / 60, totals.diapers);
+    }
+}
+
+// Weeks start on Monday; averages are over the days that have events
+static void report_weekly(const Event* events, size_t count) {
+    printf("week_of     days  feeds/d  feed_min/d  sleep_h/d  diapers/d\n");
+    size_t i = 0;
+    while(i < count) {
+        uint32_t week = (events[i].rec.ts / SECONDS_PER_DAY + 3) / 7; // Day 0 was a Thursday
+        Totals totals = {0};
+        uint32_t days = 0;
+        uint32_t last_day = UINT32_MAX;
+        for(; i < count && (events[i].rec.ts / SECONDS_PER_DAY + 3) / 7 == week; i++) {
+            uint32_t day = events[i].rec.ts / SECONDS_PER_DAY;
+            if(day != last_day) days++;
+            last_day = day;
+            totals_add(&totals, &events[i].rec);
+        }
+        char date[16];
+        format_date(week * 7 - 3, date, sizeof(date));
+        printf("%s  %4u  %7.1f  %10.1f  %9.1f  %9.1f\n",
+            date, days, (double)totals.feeds / days, totals.feed_seconds / 60.0 / days,
+            totals.sleep_seconds / 3600.0 / days, (double)totals.diapers / days);
+    }
+}
+
+// A sleep stop with a duration defines its session; a stop without one
+// closes the last start. A start that is never stopped is shown open.
+static void report_sleep(const Event* events, size_t count) {
+    printf("start                end                  minutes\n");
+    uint32_t open_ts = 0;
+    char start[LOG_TS_STR_LEN];
+    char end[LOG_TS_STR_LEN];
+    for(size_t i = 0; i < count; i++) {
+        const LogRecord* rec = &events[i].rec;
+        if(rec->type == LogEventSleepStart) {
+            if(open_ts) {
+                log_format_ts(open_ts, start, sizeof(start));
+                printf("%s  %-19s  %7s\n", start, "-", "-");
+            }
+            open_ts = rec->ts;
+            continue;
+        }
+        if(rec->type != LogEventSleepStop) continue;
+
+        uint32_t from = rec->duration ? rec->ts - rec->duration : open_ts;
+        open_ts = 0;
+        if(from == 0) continue; // Stop without a length or a start
+        log_format_ts(from, start, sizeof(start));
+        log_format_ts(rec->ts, end, sizeof(end));
+        printf("%s  %s  %7u\n", start, end, (rec->ts - from) / 60);
+    }
+    if(open_ts) {
+        log_format_ts(open_ts, start, sizeof(start));
+        printf("%s  %-19s  %7s\n", start, "-", "-");
+    }
+}
+
+static void report_csv(const Event* events, size_t count) {
+    printf("ts,type,duration,id\n");
+    char ts[LOG_TS_STR_LEN];
+    for(size_t i = 0; i < count; i++) {
+        const LogRecord* rec = &events[i].rec;
+        log_format_ts(rec->ts, ts, sizeof(ts));
+        printf("%s,%s,%u,%s\n", ts, log_type_name(rec->type), rec->duration, rec->id);
+    }
+}
+
+// ==== MAIN ====
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: baby_stats [-d|-w|-s|-c] [-j threads] [-t] <dir>\n"
+        "  <dir>  copy of /ext/apps/baby_log (or one of its child_N folders)\n"
+        "  -d     daily summary (default)\n"
+        "  -w     weekly summary\n"
+        "  -s     sleep sessions\n"
+        "  -c     all events as CSV\n"
+        "  -j     scan threads (default: online CPUs)\n"
+        "  -t     print scan statistics and timing to stderr\n");
+}
+
+static const char* path_in(const char* dir, const char* name) {
+    static char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return path;
+}
+
+static double elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+int main(int argc, char** argv) {
+    Report report = ReportDaily;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    bool timing = false;
+    int opt;
+    while((opt = getopt(argc, argv, "dwscj:th")) != -1) {
+        switch(opt) {
+        case 'd': report = ReportDaily; break;
+        case 'w': report = ReportWeekly; break;
+        case 's': report = ReportSleep; break;
+        case 'c': report = ReportCsv; break;
+        case 'j': threads = atoi(optarg); break;
+        case 't': timing = true; break;
+        default: usage(); return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if(optind != argc - 1) {
+        usage();
+        return 2;
+    }
+    if(threads < 1) threads = 1;
+    if(threads > MAX_THREADS) threads = MAX_THREADS;
+    const char* dir = argv[optind];
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Segments, numbered from 1 with no gaps like on the card
+    size_t segment_count = 0;
+    char path[PATH_MAX];
+    for(;;) {
+        snprintf(path, sizeof(path), "%s/archive/seg_%04zu.bin", dir, segment_count + 1);
+        if(access(path, R_OK) != 0) break;
+        segment_count++;
+    }
+
+    Mapped log_map;
+    bool has_log = map_file(path_in(dir, "log.jsonl"), &log_map);
+    if(!has_log && segment_count == 0) {
+        fprintf(stderr, "baby_stats: no log.jsonl or archive segments in %s\n", dir);
+        return 1;
+    }
+
+    // log.jsonl is cut into slices at line ends, one task each
+    size_t slices = 1;
+    if(log_map.size >= 2 * JSONL_SLICE_MIN) {
+        slices = log_map.size / JSONL_SLICE_MIN;
+        if(slices > (size_t)threads) slices = threads;
+    }
+
+    size_t task_count = segment_count + (has_log ? slices : 0);
+    ScanTask* tasks = calloc(task_count, sizeof(ScanTask));
+    Mapped* segments = calloc(segment_count ? segment_count : 1, sizeof(Mapped));
+    char (*names)[32] = calloc(segment_count ? segment_count : 1, sizeof(*names));
+    if(!tasks || !segments || !names) {
+        fprintf(stderr, "baby_stats: out of memory\n");
+        return 1;
+    }
+
+    size_t total_bytes = log_map.size;
+    for(size_t i = 0; i < segment_count; i++) {
+        snprintf(path, sizeof(path), "%s/archive/seg_%04zu.bin", dir, i + 1);
+        snprintf(names[i], sizeof(names[i]), "seg_%04zu.bin", i + 1);
+        map_file(path, &segments[i]);
+        tasks[i] = (ScanTask){.kind = TaskSegment, .name = names[i], .data = segments[i].data, .size = segments[i].size};
+        total_bytes += segments[i].size;
+    }
+    size_t slice_start = 0;
+    for(size_t i = 0; has_log && i < slices; i++) {
+        size_t slice_end = (i == slices - 1) ? log_map.size : log_map.size / slices * (i + 1);
+        while(slice_end < log_map.size && log_map.data[slice_end - 1] != '\n') slice_end++;
+        tasks[segment_count + i] = (ScanTask){
+            .kind = TaskJsonl,
+            .name = "log.jsonl",
+            .data = log_map.data + slice_start,
+            .size = slice_end - slice_start,
+        };
+        slice_start = slice_end;
+    }
+
+    scan_all(tasks, task_count, threads);
+
+    // Tombstones and patches are small - read on this thread
+    IdSet tombstones = {0};
+    IdSet patches = {0};
+    size_t damaged = 0;
+    Mapped side;
+    if(map_file(path_in(dir, "deleted.jsonl"), &side)) {
+        for_each_line(side.data, side.size, tombstone_line, &tombstones, &damaged);
+        unmap_file(&side);
+    }
+    if(map_file(path_in(dir, "patches.jsonl"), &side)) {
+        for_each_line(side.data, side.size, patch_line, &patches, &damaged);
+        unmap_file(&side);
+    }
+
+    size_t scanned = 0;
+    for(size_t i = 0; i < task_count; i++) {
+        scanned += tasks[i].out.count;
+        damaged += tasks[i].damaged;
+    }
+    size_t count;
+    Event* events = merge_events(tasks, task_count, &tombstones, &patches, &count);
+    double scan_ms = elapsed_ms(&start);
+
+    static char out_buffer[1 << 16];
+    setvbuf(stdout, out_buffer, _IOFBF, sizeof(out_buffer));
+    switch(report) {
+    case ReportDaily: report_daily(events, count); break;
+    case ReportWeekly: report_weekly(events, count); break;
+    case ReportSleep: report_sleep(events, count); break;
+    case ReportCsv: report_csv(events, count); break;
+    }
+    fflush(stdout);
+
+    if(timing) {
+        fprintf(stderr,
+            "baby_stats: %zu segments + log.jsonl in %zu slices, %zu bytes, %d threads\n"
+            "baby_stats: %zu records scanned, %zu events after deletes and patches, %zu damaged\n"
+            "baby_stats: scan+merge %.1f ms, total %.1f ms\n",
+            segment_count, has_log ? slices : 0, total_bytes, threads,
+            scanned, count, damaged, scan_ms, elapsed_ms(&start));
+    }
+
+    free(events);
+    for(size_t i = 0; i < task_count; i++) {
+        free(tasks[i].out.items);
+    }
+    for(size_t i = 0; i < segment_count; i++) {
+        unmap_file(&segments[i]);
+    }
+    unmap_file(&log_map);
+    free(tombstones.slots);
+    free(patches.slots);
+    free(names);
+    free(segments);
+    free(tasks);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "datetime/datetime.h"
+
+// Same arithmetic as the firmware: timestamps are local time without zone
+#define SECONDS_PER_DAY 86400
+
+static const uint8_t days_per_month[2][12] = {
+    {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+    {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+};
+
+bool datetime_is_leap_year(uint16_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+uint16_t datetime_get_days_per_year(uint16_t year) {
+    return datetime_is_leap_year(year) ? 366 : 365;
+}
+
+uint8_t datetime_get_days_per_month(bool leap_year, uint8_t month) {
+    return days_per_month[leap_year ? 1 : 0][month - 1];
+}
+
+uint32_t datetime_datetime_to_timestamp(DateTime* datetime) {
+    uint32_t days = 0;
+    for(uint16_t year = 1970; year < datetime->year; year++) {
+        days += datetime_get_days_per_year(year);
+    }
+    bool leap = datetime_is_leap_year(datetime->year);
+    for(uint8_t month = 1; month < datetime->month; month++) {
+        days += datetime_get_days_per_month(leap, month);
+    }
+    days += datetime->day - 1;
+    return days * SECONDS_PER_DAY + datetime->hour * 3600 + datetime->minute * 60 + datetime->second;
+}
+
+void datetime_timestamp_to_datetime(uint32_t timestamp, DateTime* datetime) {
+    uint32_t days = timestamp / SECONDS_PER_DAY;
+    uint32_t seconds = timestamp % SECONDS_PER_DAY;
+    datetime->hour = seconds / 3600;
+    datetime->minute = (seconds / 60) % 60;
+    datetime->second = seconds % 60;
+    datetime->weekday = ((days + 3) % 7) + 1; // 1970-01-01 was a Thursday
+
+    uint16_t year = 1970;
+    while(days >= datetime_get_days_per_year(year)) {
+        days -= datetime_get_days_per_year(year);
+        year++;
+    }
+    datetime->year = year;
+
+    bool leap = datetime_is_leap_year(year);
+    uint8_t month = 1;
+    while(days >= datetime_get_days_per_month(leap, month)) {
+        days -= datetime_get_days_per_month(leap, month);
+        month++;
+    }
+    datetime->month = month;
+    datetime->day = days + 1;
+}
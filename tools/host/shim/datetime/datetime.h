@@ -0,0 +1,20 @@
+#pragma once
+// Host stand-in for the firmware's datetime library (same API)
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    uint8_t weekday; // 1 = Monday
+} DateTime;
+
+uint32_t datetime_datetime_to_timestamp(DateTime* datetime);
+void datetime_timestamp_to_datetime(uint32_t timestamp, DateTime* datetime);
+bool datetime_is_leap_year(uint16_t year);
+uint16_t datetime_get_days_per_year(uint16_t year);
+uint8_t datetime_get_days_per_month(bool leap_year, uint8_t month);
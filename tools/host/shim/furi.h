@@ -0,0 +1,69 @@
+#pragma once
+// Host stand-in for the firmware's furi.h: what the app sources need to
+// build on Linux. baby_stats only uses the codec part; the host tests link
+// most of the app against sdk.c.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define FURI_PACKED __attribute__((packed))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define furi_assert(x) ((void)(x))
+#define furi_check(x) ((void)(x))
+#define furi_crash(msg) abort()
+
+#define EXT_PATH(path) "/ext/" path
+#define APP_DATA_PATH(path) "/ext/apps_data/baby_log/" path
+#define APP_ASSETS_PATH(path) "/ext/apps_assets/baby_log/" path
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+typedef enum {
+    FuriFlagWaitAny = 0,
+    FuriFlagWaitAll = 1,
+    FuriFlagNoClear = 2,
+    FuriFlagError = 0x80000000U,
+    FuriFlagErrorTimeout = 0xFFFFFFFEU,
+} FuriFlag;
+
+typedef void* FuriThreadId;
+typedef struct FuriTimer FuriTimer;
+
+typedef enum {
+    FuriTimerTypeOnce,
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+
+typedef void (*FuriTimerCallback)(void* context);
+
+void furi_delay_ms(uint32_t ms);
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+uint32_t furi_get_tick(void);
+uint32_t furi_kernel_get_tick_frequency(void);
+uint32_t furi_ms_to_ticks(uint32_t ms);
+
+FuriThreadId furi_thread_get_current_id(void);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id);
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_minimum_free_heap(void);
@@ -0,0 +1,6 @@
+#pragma once
+#include <furi.h>
+#include <datetime/datetime.h>
+
+// The host RTC reads sdk_rtc_now (sdk.h)
+void furi_hal_rtc_get_datetime(DateTime* datetime);
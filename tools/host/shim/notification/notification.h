@@ -0,0 +1,15 @@
+#pragma once
+#include <furi.h>
+
+#define RECORD_NOTIFICATION "notification"
+
+typedef struct NotificationApp NotificationApp;
+
+// On the host a message only carries which LED or effect it stands for
+typedef struct NotificationMessage {
+    int type;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+void notification_message(NotificationApp* app, const NotificationSequence* message);
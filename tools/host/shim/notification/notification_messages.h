@@ -0,0 +1,8 @@
+#pragma once
+#include "notification.h"
+
+extern const NotificationMessage message_vibro_on, message_vibro_off;
+extern const NotificationMessage message_red_255, message_green_255, message_blue_255;
+extern const NotificationMessage message_red_0, message_green_0, message_blue_0;
+extern const NotificationMessage message_delay_50, message_delay_100, message_delay_250, message_delay_500;
+extern const NotificationMessage message_display_backlight_on;
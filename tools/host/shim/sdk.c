@@ -0,0 +1,534 @@
+// Host SDK for the tests: storage on a directory, a settable RTC and tick,
+// a timer that only records when it was armed, and no-op drawing.
+#include "sdk.h"
+#include <furi_hal_rtc.h>
+#include <storage/storage.h>
+#include <stream/buffered_file_stream.h>
+#include <gui/canvas.h>
+#include <notification/notification_messages.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SDK_PATH_MAX 512
+#define SDK_DIRTY_MAX 64 // Sectors tracked per open before they are counted
+#define SDK_IO_FILES 32 // Distinct file names counted apart
+
+uint32_t sdk_rtc_now = 1792411200U; // 2026-10-19 00:00
+uint32_t sdk_tick_ms = 0;
+uint32_t sdk_timer_ticks = 0;
+uint32_t sdk_alert_count = 0;
+int sdk_alert_led = 0;
+
+static char g_root[SDK_PATH_MAX] = ".";
+static SdkIoStats g_io;
+static struct {
+    char name[64];
+    SdkIoStats io;
+} g_io_files[SDK_IO_FILES];
+
+void sdk_sd_root(const char* dir) {
+    snprintf(g_root, sizeof(g_root), "%s", dir);
+}
+
+static void sd_path(const char* path, char* out) {
+    if(strncmp(path, "/ext", 4) == 0) path += 4;
+    snprintf(out, SDK_PATH_MAX, "%s%s", g_root, path);
+}
+
+// ==== OPEN FILES ====
+// File and Stream are the same thing here: a stdio file plus the sectors
+// written since it was opened or last synced.
+
+typedef struct {
+    FILE* f;
+    char name[64]; // Last path component, for sdk_io_file()
+    uint32_t dirty[SDK_DIRTY_MAX];
+    uint32_t dirty_count;
+    bool wrote;
+} Handle;
+
+struct File {
+    Handle h;
+};
+
+struct Stream {
+    Handle h;
+};
+
+static SdkIoStats* io_file(const char* name) {
+    for(int i = 0; i < SDK_IO_FILES; i++) {
+        if(g_io_files[i].name[0] == '\0') {
+            snprintf(g_io_files[i].name, sizeof(g_io_files[i].name), "%s", name);
+        }
+        if(strcmp(g_io_files[i].name, name) == 0) return &g_io_files[i].io;
+    }
+    return NULL;
+}
+
+static void io_add(Handle* h, uint32_t opens, uint32_t sectors) {
+    g_io.opens += opens;
+    g_io.sectors += sectors;
+    SdkIoStats* file = io_file(h->name);
+    if(file) {
+        file->opens += opens;
+        file->sectors += sectors;
+    }
+}
+
+static void io_count(Handle* h) {
+    if(!h->wrote) return;
+    io_add(h, 1, h->dirty_count + 1); // Data sectors plus the directory entry
+    h->dirty_count = 0;
+    h->wrote = false;
+}
+
+// A remove or rename: only the directory entry is written
+static void io_entry(const char* path) {
+    Handle h = {0};
+    const char* slash = strrchr(path, '/');
+    snprintf(h.name, sizeof(h.name), "%s", slash ? slash + 1 : path);
+    io_add(&h, 1, 1);
+}
+
+static void io_mark(Handle* h, long offset, size_t size) {
+    if(size == 0) return;
+    h->wrote = true;
+    uint32_t first = (uint32_t)offset / SDK_SECTOR_SIZE;
+    uint32_t last = (uint32_t)(offset + size - 1) / SDK_SECTOR_SIZE;
+    for(uint32_t sector = first; sector <= last; sector++) {
+        bool seen = false;
+        for(uint32_t i = 0; i < h->dirty_count && !seen; i++) seen = h->dirty[i] == sector;
+        if(seen) continue;
+        if(h->dirty_count == SDK_DIRTY_MAX) {
+            io_add(h, 0, h->dirty_count);
+            h->dirty_count = 0;
+        }
+        h->dirty[h->dirty_count++] = sector;
+    }
+}
+
+static bool access_ok(const char* host) {
+    return access(host, F_OK) == 0;
+}
+
+static bool handle_open(Handle* h, const char* path, FS_AccessMode access, FS_OpenMode mode) {
+    char host[SDK_PATH_MAX];
+    sd_path(path, host);
+    memset(h, 0, sizeof(Handle));
+    const char* slash = strrchr(path, '/');
+    snprintf(h->name, sizeof(h->name), "%s", slash ? slash + 1 : path);
+    bool exists = access_ok(host);
+    const char* how = NULL;
+    switch(mode) {
+        case FSOM_OPEN_EXISTING: how = (access == FSAM_READ) ? "rb" : "r+b"; break;
+        case FSOM_OPEN_APPEND: how = (access == FSAM_READ) ? "rb" : "ab"; break;
+        case FSOM_CREATE_ALWAYS: how = (access == FSAM_READ) ? "rb" : "w+b"; break;
+        case FSOM_OPEN_ALWAYS: how = exists ? "r+b" : "w+b"; break;
+        case FSOM_CREATE_NEW: how = exists ? NULL : "w+b"; break;
+    }
+    h->f = how ? fopen(host, how) : NULL;
+    // Creating or truncating a file updates its directory entry
+    h->wrote = h->f && access != FSAM_READ && (!exists || mode == FSOM_CREATE_ALWAYS);
+    return h->f != NULL;
+}
+
+static bool handle_close(Handle* h) {
+    if(!h->f) return false;
+    io_count(h);
+    fclose(h->f);
+    h->f = NULL;
+    return true;
+}
+
+static size_t handle_write(Handle* h, const void* data, size_t size) {
+    if(!h->f) return 0;
+    fseek(h->f, 0, SEEK_CUR); // Switch stdio from reading to writing
+    size_t written = fwrite(data, 1, size, h->f);
+    io_mark(h, ftell(h->f) - (long)written, written); // Append mode writes at the end
+    return written;
+}
+
+static size_t handle_read(Handle* h, void* data, size_t size) {
+    if(!h->f) return 0;
+    fseek(h->f, 0, SEEK_CUR); // Switch stdio from writing to reading
+    return fread(data, 1, size, h->f);
+}
+
+static uint64_t handle_size(Handle* h) {
+    long pos = ftell(h->f);
+    fseek(h->f, 0, SEEK_END);
+    long end = ftell(h->f);
+    fseek(h->f, pos, SEEK_SET);
+    return (uint64_t)end;
+}
+
+// ==== STORAGE ====
+
+void* furi_record_open(const char* name) {
+    static int record;
+    UNUSED(name);
+    return &record;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+FS_Error storage_common_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SDK_PATH_MAX];
+    sd_path(path, host);
+    if(mkdir(host, 0777) == 0) return FSE_OK;
+    return (errno == EEXIST) ? FSE_EXIST : FSE_INTERNAL;
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SDK_PATH_MAX];
+    sd_path(path, host);
+    if(remove(host) != 0) return FSE_NOT_EXIST;
+    io_entry(path);
+    return FSE_OK;
+}
+
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
+    UNUSED(storage);
+    char from[SDK_PATH_MAX];
+    char to[SDK_PATH_MAX];
+    sd_path(old_path, from);
+    sd_path(new_path, to);
+    if(access_ok(to)) return FSE_EXIST; // Like FatFs, no overwrite
+    if(rename(from, to) != 0) return FSE_NOT_EXIST;
+    io_entry(new_path);
+    return FSE_OK;
+}
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    UNUSED(storage);
+    char host[SDK_PATH_MAX];
+    sd_path(path, host);
+    struct stat st;
+    if(stat(host, &st) != 0) return FSE_NOT_EXIST;
+    if(fileinfo) {
+        fileinfo->size = (uint64_t)st.st_size;
+        fileinfo->flags = S_ISDIR(st.st_mode) ? FSF_DIRECTORY : 0;
+    }
+    return FSE_OK;
+}
+
+bool storage_common_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host[SDK_PATH_MAX];
+    sd_path(path, host);
+    return access_ok(host);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    handle_close(&file->h);
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    return handle_open(&file->h, path, access_mode, open_mode);
+}
+
+bool storage_file_close(File* file) {
+    return handle_close(&file->h);
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    return handle_read(&file->h, buff, bytes_to_read);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    return handle_write(&file->h, buff, bytes_to_write);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return fseek(file->h.f, (long)offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File* file) {
+    return (uint64_t)ftell(file->h.f);
+}
+
+bool storage_file_truncate(File* file) {
+    fflush(file->h.f);
+    return ftruncate(fileno(file->h.f), ftell(file->h.f)) == 0;
+}
+
+uint64_t storage_file_size(File* file) {
+    return handle_size(&file->h);
+}
+
+bool storage_file_sync(File* file) {
+    fflush(file->h.f);
+    io_count(&file->h);
+    return true;
+}
+
+bool storage_file_eof(File* file) {
+    return storage_file_tell(file) >= storage_file_size(file);
+}
+
+// Only from the start of an empty file, like the firmware's f_expand()
+bool storage_file_expand(File* file, uint64_t size) {
+    if(ftell(file->h.f) != 0) return false;
+    fflush(file->h.f);
+    return ftruncate(fileno(file->h.f), (off_t)size) == 0;
+}
+
+// ==== STREAMS ====
+
+Stream* buffered_file_stream_alloc(Storage* storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(Stream));
+}
+
+bool buffered_file_stream_open(Stream* stream, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    return handle_open(&stream->h, path, access_mode, open_mode);
+}
+
+bool buffered_file_stream_close(Stream* stream) {
+    return handle_close(&stream->h);
+}
+
+bool buffered_file_stream_sync(Stream* stream) {
+    fflush(stream->h.f);
+    io_count(&stream->h);
+    return true;
+}
+
+void stream_free(Stream* stream) {
+    handle_close(&stream->h);
+    free(stream);
+}
+
+size_t stream_size(Stream* stream) {
+    return (size_t)handle_size(&stream->h);
+}
+
+size_t stream_tell(Stream* stream) {
+    return (size_t)ftell(stream->h.f);
+}
+
+bool stream_eof(Stream* stream) {
+    return stream_tell(stream) >= stream_size(stream);
+}
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type) {
+    int whence = (offset_type == StreamOffsetFromStart) ? SEEK_SET :
+                 (offset_type == StreamOffsetFromEnd)   ? SEEK_END :
+                                                          SEEK_CUR;
+    return fseek(stream->h.f, offset, whence) == 0;
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    return handle_read(&stream->h, data, size);
+}
+
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    return handle_write(&stream->h, data, size);
+}
+
+bool stream_rewind(Stream* stream) {
+    rewind(stream->h.f);
+    return true;
+}
+
+void sdk_io_reset(void) {
+    memset(&g_io, 0, sizeof(g_io));
+    memset(g_io_files, 0, sizeof(g_io_files));
+}
+
+SdkIoStats sdk_io_stats(void) {
+    return g_io;
+}
+
+SdkIoStats sdk_io_file(const char* name) {
+    for(int i = 0; i < SDK_IO_FILES && g_io_files[i].name[0]; i++) {
+        if(strcmp(g_io_files[i].name, name) == 0) return g_io_files[i].io;
+    }
+    SdkIoStats none = {0};
+    return none;
+}
+
+// ==== KERNEL ====
+
+void furi_hal_rtc_get_datetime(DateTime* datetime) {
+    datetime_timestamp_to_datetime(sdk_rtc_now, datetime);
+}
+
+void furi_delay_ms(uint32_t ms) {
+    UNUSED(ms);
+}
+
+uint32_t furi_get_tick(void) {
+    return sdk_tick_ms;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
+
+FuriThreadId furi_thread_get_current_id(void) {
+    return (FuriThreadId)1;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    UNUSED(thread_id);
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    UNUSED(flags);
+    UNUSED(options);
+    UNUSED(timeout);
+    return FuriFlagErrorTimeout;
+}
+
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id) {
+    UNUSED(thread_id);
+    return 2048;
+}
+
+size_t memmgr_get_free_heap(void) {
+    return 65536;
+}
+
+size_t memmgr_get_minimum_free_heap(void) {
+    return 65536;
+}
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    void* context;
+};
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    UNUSED(type);
+    FuriTimer* timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = func;
+    timer->context = context;
+    return timer;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    UNUSED(instance);
+    sdk_timer_ticks = ticks;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    UNUSED(instance);
+    sdk_timer_ticks = 0;
+    return FuriStatusOk;
+}
+
+// ==== NOTIFICATIONS ====
+
+const NotificationMessage message_vibro_on = {1};
+const NotificationMessage message_vibro_off = {2};
+const NotificationMessage message_red_255 = {3};
+const NotificationMessage message_green_255 = {4};
+const NotificationMessage message_blue_255 = {5};
+const NotificationMessage message_red_0 = {6};
+const NotificationMessage message_green_0 = {7};
+const NotificationMessage message_blue_0 = {8};
+const NotificationMessage message_delay_50 = {9};
+const NotificationMessage message_delay_100 = {10};
+const NotificationMessage message_delay_250 = {11};
+const NotificationMessage message_delay_500 = {12};
+const NotificationMessage message_display_backlight_on = {13};
+
+void notification_message(NotificationApp* app, const NotificationSequence* message) {
+    UNUSED(app);
+    sdk_alert_count++;
+    sdk_alert_led = (*message)[1]->type;
+}
+
+// ==== CANVAS ====
+
+void canvas_clear(Canvas* canvas) {
+    UNUSED(canvas);
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(canvas);
+    UNUSED(color);
+}
+
+void canvas_invert_color(Canvas* canvas) {
+    UNUSED(canvas);
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(str);
+}
+
+void canvas_draw_str_aligned(Canvas* canvas, int32_t x, int32_t y, Align horizontal, Align vertical, const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    UNUSED(str);
+}
+
+uint16_t canvas_string_width(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    return (uint16_t)(strlen(str) * 5);
+}
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    UNUSED(canvas);
+    UNUSED(x1);
+    UNUSED(y1);
+    UNUSED(x2);
+    UNUSED(y2);
+}
@@ -0,0 +1,29 @@
+#pragma once
+// Controls and counters of the host SDK (sdk.c), for the tests in test/
+#include <furi.h>
+
+#define SDK_SECTOR_SIZE 512
+
+// Directory that stands in for the SD card's /ext
+void sdk_sd_root(const char* dir);
+
+extern uint32_t sdk_rtc_now; // What furi_hal_rtc_get_datetime() returns
+extern uint32_t sdk_tick_ms; // What furi_get_tick() returns, 1 tick = 1 ms
+
+// Reminder timer and alerts
+extern uint32_t sdk_timer_ticks; // Ticks of the last furi_timer_start(), 0 = stopped
+extern uint32_t sdk_alert_count;
+extern int sdk_alert_led; // Type of the second message of the last sequence
+
+// Card writes, counted when a file is closed or synced: every distinct
+// 512-byte sector written through one open, plus one directory entry
+// update per open that wrote, created or truncated the file, and per
+// remove or rename
+typedef struct {
+    uint32_t opens; // Opens that wrote
+    uint32_t sectors;
+} SdkIoStats;
+
+void sdk_io_reset(void);
+SdkIoStats sdk_io_stats(void);
+SdkIoStats sdk_io_file(const char* name); // Writes to files with this name, e.g. "last.bin"
@@ -0,0 +1,58 @@
+#pragma once
+#include <furi.h>
+
+// Host storage: /ext/... paths map into the directory set by sdk_sd_root()
+
+#define RECORD_STORAGE "storage"
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum {
+    FSAM_READ = 1,
+    FSAM_WRITE = 2,
+    FSAM_READ_WRITE = 3,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+typedef enum {
+    FSE_OK = 0,
+    FSE_NOT_READY,
+    FSE_EXIST,
+    FSE_NOT_EXIST,
+    FSE_INTERNAL,
+} FS_Error;
+
+#define FSF_DIRECTORY (1 << 0)
+
+typedef struct {
+    uint32_t flags;
+    uint64_t size;
+} FileInfo;
+
+FS_Error storage_common_mkdir(Storage* storage, const char* path);
+FS_Error storage_common_remove(Storage* storage, const char* path);
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path);
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo);
+bool storage_common_exists(Storage* storage, const char* path);
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read);
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+uint64_t storage_file_tell(File* file);
+bool storage_file_truncate(File* file);
+uint64_t storage_file_size(File* file);
+bool storage_file_sync(File* file);
+bool storage_file_eof(File* file);
+bool storage_file_expand(File* file, uint64_t size);
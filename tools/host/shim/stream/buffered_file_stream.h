@@ -0,0 +1,8 @@
+#pragma once
+#include <stream/stream.h>
+#include <storage/storage.h>
+
+Stream* buffered_file_stream_alloc(Storage* storage);
+bool buffered_file_stream_open(Stream* stream, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool buffered_file_stream_close(Stream* stream);
+bool buffered_file_stream_sync(Stream* stream);
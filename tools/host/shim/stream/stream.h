@@ -0,0 +1,19 @@
+#pragma once
+#include <furi.h>
+
+typedef struct Stream Stream;
+
+typedef enum {
+    StreamOffsetFromCurrent,
+    StreamOffsetFromStart,
+    StreamOffsetFromEnd,
+} StreamOffset;
+
+void stream_free(Stream* stream);
+size_t stream_size(Stream* stream);
+size_t stream_tell(Stream* stream);
+bool stream_eof(Stream* stream);
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type);
+size_t stream_read(Stream* stream, uint8_t* data, size_t size);
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size);
+bool stream_rewind(Stream* stream);
@@ -0,0 +1,56 @@
+#include "test.h"
+#include <furi.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int test_failures = 0;
+
+static uint64_t g_rand_state = 1;
+static char g_sd_dir[64];
+
+static void sd_remove(void) {
+    if(!g_sd_dir[0]) return;
+    char command[96];
+    snprintf(command, sizeof(command), "rm -rf %s", g_sd_dir);
+    if(system(command) != 0) fprintf(stderr, "test: cannot remove %s\n", g_sd_dir);
+    g_sd_dir[0] = '\0';
+}
+
+void test_sd_fresh(void) {
+    char* dir = g_sd_dir;
+    if(dir[0]) {
+        sd_remove();
+    } else {
+        atexit(sd_remove);
+    }
+    snprintf(dir, sizeof(g_sd_dir), "/tmp/baby_log_test_XXXXXX");
+    if(!mkdtemp(dir)) {
+        perror("mkdtemp");
+        exit(2);
+    }
+    sdk_sd_root(dir);
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/apps", dir);
+    mkdir(path, 0777);
+    snprintf(path, sizeof(path), "%s/apps/baby_log", dir);
+    mkdir(path, 0777);
+}
+
+void test_seed(uint32_t seed) {
+    g_rand_state = seed * 2654435761ULL + 1;
+}
+
+uint32_t test_rand(uint32_t bound) {
+    // xorshift64*
+    g_rand_state ^= g_rand_state >> 12;
+    g_rand_state ^= g_rand_state << 25;
+    g_rand_state ^= g_rand_state >> 27;
+    uint64_t value = (g_rand_state * 2685821657736338717ULL) >> 32;
+    return bound ? (uint32_t)(value % bound) : 0;
+}
+
+int test_done(const char* name) {
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+// Minimal helpers for the host tests: each test is one program that
+// returns non-zero on failure. Built and run by `make -C tools/host`.
+#include "sdk.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+extern int test_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if(!(cond)) {                                                        \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                 \
+        }                                                                    \
+    } while(0)
+
+#define CHECK_EQ(a, b)                                                                  \
+    do {                                                                                \
+        long long check_a = (long long)(a), check_b = (long long)(b);                   \
+        if(check_a != check_b) {                                                        \
+            fprintf(stderr, "%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__, \
+                #a, #b, check_a, check_b);                                              \
+            test_failures++;                                                            \
+        }                                                                               \
+    } while(0)
+
+// Fresh empty SD card in a temporary directory, with apps/baby_log in it
+void test_sd_fresh(void);
+
+// Deterministic random numbers, so a failing seed can be replayed
+void test_seed(uint32_t seed);
+uint32_t test_rand(uint32_t bound); // 0 .. bound-1
+
+int test_done(const char* name); // Prints the result, returns the exit code
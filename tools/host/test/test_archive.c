@@ -0,0 +1,183 @@
+// Archive segments: what rotation encodes decodes back unchanged, and
+// log_archive_seek() / log_history_seek() land on the first record at or
+// after any time, across block boundaries and runs of equal timestamps.
+#include "test.h"
+#include "log_store.h"
+#include "log_archive.h"
+#include "log_export.h"
+#include "log_codec.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define EVENTS 1500
+#define SPAN_DAYS 60
+
+static AppData app;
+static LogRecord g_events[EVENTS];
+static int g_archived; // g_events[0 .. g_archived-1] went to the segment
+
+static void random_record(LogRecord* rec, uint32_t ts) {
+    rec->ts = ts;
+    rec->type = (LogEventType)test_rand(5);
+    bool stop = rec->type == LogEventFeedingStop || rec->type == LogEventSleepStop;
+    rec->duration = stop ? test_rand(4 * 3600) : 0;
+    if(test_rand(8) == 0) {
+        // An ID from another app version - stored raw
+        uint32_t len = 8 + test_rand(LOG_ID_LEN - 7);
+        for(uint32_t i = 0; i < len; i++) rec->id[i] = "0123456789abcdef"[test_rand(16)];
+        rec->id[len] = '\0';
+    } else {
+        log_format_id(ts + test_rand(3), rec->id);
+    }
+}
+
+static void write_log(void) {
+    uint32_t ts = sdk_rtc_now - SPAN_DAYS * 86400;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, LOG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(int i = 0; i < EVENTS; i++) {
+        // Mostly hours apart, sometimes the same second
+        ts += (test_rand(6) == 0) ? 0 : test_rand(2 * SPAN_DAYS * 86400 / EVENTS);
+        random_record(&g_events[i], ts);
+        char line[LOG_LINE_MAX];
+        int len = log_format_record(&g_events[i], line, sizeof(line));
+        CHECK(len > 0 && storage_file_write(file, line, len) == (size_t)len);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool same_record(const LogRecord* a, const LogRecord* b) {
+    return a->ts == b->ts && a->type == b->type && a->duration == b->duration &&
+           strcmp(a->id, b->id) == 0;
+}
+
+static void test_round_trip(void) {
+    ArchiveReader reader;
+    char path[64];
+    log_archive_segment_path(1, path, sizeof(path));
+    CHECK(log_archive_open(&reader, path));
+    CHECK(reader.block_count > 4);
+
+    int count = 0;
+    const LogRecord* rec;
+    while((rec = log_archive_next(&reader)) != NULL) {
+        if(count < EVENTS && !same_record(rec, &g_events[count])) {
+            fprintf(stderr, "record %d differs\n", count);
+            test_failures++;
+        }
+        count++;
+    }
+    CHECK_EQ(count, g_archived);
+    log_archive_close(&reader);
+}
+
+// Index of the first archived event at or after ts
+static int first_at(uint32_t ts) {
+    int i = 0;
+    while(i < g_archived && g_events[i].ts < ts) i++;
+    return i;
+}
+
+static void test_seek(void) {
+    char path[64];
+    log_archive_segment_path(1, path, sizeof(path));
+    ArchiveReader reader;
+    int wrong = 0;
+    for(int round = 0; round < 400; round++) {
+        // Exact times (often a run of equal ones), and times in between
+        uint32_t ts = g_events[test_rand(g_archived)].ts;
+        if(round % 2) ts += 1 + test_rand(3600);
+        if(round == 0) ts = 0;
+        int expect = first_at(ts);
+
+        CHECK(log_archive_open(&reader, path));
+        bool found = log_archive_seek(&reader, ts);
+        if(found != (expect < g_archived)) wrong++;
+        // Read on past at least one block boundary
+        for(int i = expect; found && i < g_archived && i < expect + 2 * LOG_BLOCK_MAX_RECORDS; i++) {
+            const LogRecord* rec = log_archive_next(&reader);
+            if(!rec || !same_record(rec, &g_events[i])) {
+                wrong++;
+                break;
+            }
+        }
+        log_archive_close(&reader);
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+// History from a time: segment records and log.jsonl records alike
+static void test_history_seek(void) {
+    int wrong = 0;
+    for(int round = 0; round < 40; round++) {
+        uint32_t ts = g_events[test_rand(EVENTS)].ts + test_rand(2) * 1800;
+        int expect = 0;
+        while(expect < EVENTS && g_events[expect].ts < ts) expect++;
+
+        LogHistory history;
+        log_history_open(&history);
+        log_history_seek(&history, ts);
+        const LogRecord* rec;
+        int i = expect;
+        while((rec = log_history_next(&history)) != NULL) {
+            if(i >= EVENTS || !same_record(rec, &g_events[i])) wrong++;
+            i++;
+        }
+        if(i != EVENTS) wrong++;
+        log_history_close(&history);
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_export_since(void) {
+    uint32_t since = g_events[EVENTS / 3].ts + 1;
+    uint32_t expect = 0;
+    for(int i = 0; i < EVENTS; i++) {
+        if(g_events[i].ts < since) continue;
+        // One row per diaper and per session; a stop alone is a session too
+        LogEventType type = g_events[i].type;
+        if(type == LogEventDiaper || type == LogEventFeedingStart || type == LogEventSleepStart) {
+            expect++;
+        } else {
+            LogEventType start = (type == LogEventFeedingStop) ? LogEventFeedingStart : LogEventSleepStart;
+            int j = i - 1;
+            while(j >= 0 && g_events[j].ts >= since && g_events[j].type != start &&
+                  g_events[j].type != type) {
+                j--;
+            }
+            if(j < 0 || g_events[j].ts < since || g_events[j].type != start) expect++;
+        }
+    }
+
+    CHECK(log_export_start(&app, ExportFormatCsv, since));
+    while(log_export_step(&app)) {
+    }
+    CHECK_EQ(app.export_status, JobDone);
+    CHECK_EQ(app.export_rows, expect);
+}
+
+int main(void) {
+    scratch_init();
+    test_seed(28);
+    test_sd_fresh();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+
+    write_log();
+    sdk_rtc_now = g_events[EVENTS - 1].ts + 3600;
+    uint32_t cutoff = sdk_rtc_now - ARCHIVE_KEEP_SECONDS;
+    g_archived = 0;
+    while(g_archived < EVENTS && g_events[g_archived].ts < cutoff) g_archived++;
+    CHECK(log_archive_rotate());
+    CHECK_EQ(log_archive_segment_count(), 1);
+
+    test_round_trip();
+    test_seek();
+    test_history_seek();
+    test_export_since();
+    return test_done("archive");
+}
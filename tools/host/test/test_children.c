@@ -0,0 +1,60 @@
+// Switching children swaps everything that reads per-child files: after a
+// warm switch or an add, deletes of one child must not leak into the other.
+#include "test.h"
+#include "child.h"
+#include "log_store.h"
+#include "log_sessions.h"
+#include "scratch.h"
+#include <string.h>
+
+static AppData app;
+
+static void add_events(int count) {
+    for(int i = 0; i < count; i++) {
+        sdk_rtc_now += 600;
+        log_add_event(&app, LogEventDiaper, 0);
+    }
+}
+
+int main(void) {
+    scratch_init();
+    test_sd_fresh();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+
+    add_events(3);
+    CHECK(log_delete_last(&app));
+    CHECK_EQ(log_tombstone_count(), 1);
+    CHECK_EQ(app.log_count, 2);
+
+    CHECK(child_add(&app));
+    CHECK_EQ(app.active_child, 1);
+    CHECK_EQ(log_tombstone_count(), 0); // Child 0's delete is not this child's
+
+    add_events(2);
+    CHECK(log_delete_last(&app));
+    CHECK(log_delete_last(&app));
+    CHECK_EQ(log_tombstone_count(), 2);
+
+    child_switch(&app, 0); // Warm - the slot was loaded before
+    CHECK_EQ(log_tombstone_count(), 1);
+    CHECK_EQ(app.log_count, 2);
+    CHECK(log_undo(&app));
+    CHECK_EQ(app.log_count, 3);
+    CHECK_EQ(log_tombstone_count(), 0);
+
+    child_switch(&app, 1);
+    CHECK_EQ(log_tombstone_count(), 2);
+    CHECK_EQ(app.log_count, 0);
+
+    // What is on the card agrees with what was shown
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    app.active_child = 0;
+    child_init(&app);
+    CHECK_EQ(app.log_count, 3);
+    CHECK_EQ(log_tombstone_count(), 0);
+
+    return test_done("children");
+}
@@ -0,0 +1,206 @@
+// log_codec.c on its own: log.jsonl and deleted.jsonl lines parse back to
+// what was formatted, any single damaged byte in front of the checksum is
+// caught, and archive records survive encode/decode with truncation refused.
+#include "test.h"
+#include "log_codec.h"
+#include "scratch.h"
+#include <string.h>
+
+#define ROUNDS 2000
+
+static void random_record(LogRecord* rec) {
+    // 2000-01-01 .. 2099-12-31, durations up to what a LogEntry holds
+    rec->ts = 946684800 + test_rand(100u * 365 * 86400);
+    rec->type = (LogEventType)test_rand(LOG_EVENT_TYPE_COUNT);
+    rec->duration = test_rand(2) ? test_rand(LOG_ENTRY_DURATION_MAX + 1) : 0;
+    if(test_rand(4) == 0) {
+        // An ID from another app version - any length, stored raw
+        uint32_t len = 1 + test_rand(LOG_ID_LEN);
+        for(uint32_t i = 0; i < len; i++) {
+            rec->id[i] = "0123456789abcdefghijklmnopqrstuvwxyz-_"[test_rand(38)];
+        }
+        rec->id[len] = '\0';
+    } else {
+        log_format_id(rec->ts + test_rand(5) - 2, rec->id);
+    }
+}
+
+static bool same_record(const LogRecord* a, const LogRecord* b) {
+    return a->ts == b->ts && a->type == b->type && a->duration == b->duration &&
+           strcmp(a->id, b->id) == 0;
+}
+
+// Strip the newline so the line is what log_line_check() sees
+static int chomp(char* line, int len) {
+    CHECK(len > 0 && line[len - 1] == '\n');
+    line[--len] = '\0';
+    return len;
+}
+
+static void test_crc(void) {
+    CHECK_EQ(log_crc32(0, "123456789", 9), 0xCBF43926);
+    CHECK_EQ(log_crc32(0, "", 0), 0);
+    // Chunked the same as in one go
+    uint32_t crc = log_crc32(0, "1234", 4);
+    CHECK_EQ(log_crc32(crc, "56789", 5), 0xCBF43926);
+}
+
+static void test_ids(void) {
+    int wrong = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        uint32_t seed = test_rand(0xFFFFFFFF) + test_rand(2);
+        char id[LOG_ID_LEN + 1];
+        log_format_id(seed, id);
+        uint32_t back = 0;
+        if(strlen(id) != 16 || !log_id_seed(id, &back) || back != seed) wrong++;
+        // One nibble off is somebody else's ID, not a neighbouring seed
+        id[test_rand(16)] ^= 0x01;
+        if(log_id_seed(id, &back)) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+    uint32_t seed;
+    CHECK(!log_id_seed("0123456789abcdeg", &seed));
+    CHECK(!log_id_seed("0123456789abcdef0", &seed));
+}
+
+static void test_record_lines(void) {
+    int wrong = 0, missed = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        LogRecord rec, back;
+        random_record(&rec);
+        char line[LOG_LINE_MAX];
+        int len = chomp(line, log_format_record(&rec, line, sizeof(line)));
+        if(!log_line_check(line) || !log_parse_record(line, &back) || !same_record(&rec, &back)) {
+            wrong++;
+            continue;
+        }
+
+        // Damage one byte: in front of the tag and in the digits it is caught;
+        // in the tag itself the line reads as an old one, with the same record
+        const char* tag = strstr(line, ",\"crc\":\"");
+        CHECK(tag != NULL);
+        int tag_at = tag - line, tag_end = tag_at + 8;
+        for(int i = 0; i < len; i++) {
+            char saved = line[i];
+            for(int bit = 0; bit < 7; bit++) {
+                line[i] = saved ^ (1 << bit);
+                if(line[i] == '\0') continue;
+                if(i >= tag_at && i < tag_end) {
+                    if(log_parse_record(line, &back) && !same_record(&rec, &back)) missed++;
+                } else if(log_line_check(line)) {
+                    missed++;
+                }
+            }
+            line[i] = saved;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(missed, 0);
+
+    // Cut short, as after a power loss mid-write
+    LogRecord rec, back;
+    random_record(&rec);
+    char line[LOG_LINE_MAX];
+    int len = chomp(line, log_format_record(&rec, line, sizeof(line)));
+    for(int cut = 0; cut < len; cut++) {
+        char part[LOG_LINE_MAX];
+        memcpy(part, line, cut);
+        part[cut] = '\0';
+        CHECK(!log_parse_record(part, &back));
+    }
+}
+
+// Lines from before checksums are only checked for framing
+static void test_old_lines(void) {
+    LogRecord rec;
+    CHECK(log_parse_record("{\"ts\":\"2026-10-19T08:30:00\",\"type\":\"feeding_stop\","
+                           "\"id\":\"legacy-1\",\"dur\":1200}", &rec));
+    CHECK_EQ(rec.ts, 1792398600);
+    CHECK_EQ(rec.type, LogEventFeedingStop);
+    CHECK_EQ(rec.duration, 1200);
+    CHECK(strcmp(rec.id, "legacy-1") == 0);
+
+    CHECK(log_line_check("{\"id\":\"abc\"}"));
+    CHECK(!log_line_check("{\"id\":\"abc\""));
+    CHECK(!log_line_check("\"id\":\"abc\"}"));
+    CHECK(!log_line_check("{"));
+    CHECK(!log_line_check(""));
+}
+
+static void test_journal(void) {
+    int wrong = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        LogRecord rec, back;
+        random_record(&rec);
+        char line[LOG_LINE_MAX + 16];
+
+        chomp(line, log_format_journal(JournalOpDelete, &rec, line, sizeof(line)));
+        // A delete carries the whole record, for undo
+        if(log_parse_op(line) != JournalOpDelete || !log_parse_record(line, &back) ||
+           !same_record(&rec, &back)) {
+            wrong++;
+        }
+
+        chomp(line, log_format_journal(JournalOpRestore, &rec, line, sizeof(line)));
+        if(log_parse_op(line) != JournalOpRestore || !log_line_check(line) ||
+           !log_parse_id(line, back.id) || strcmp(back.id, rec.id) != 0) {
+            wrong++;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_varints(void) {
+    static const uint32_t edges[] = {0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000,
+                                     0xFFFFFFF, 0x10000000, 0xFFFFFFFF};
+    int wrong = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        uint32_t value = (round < 11) ? edges[round] : test_rand(0xFFFFFFFF) >> test_rand(32);
+        uint8_t buf[8];
+        size_t len = log_varint_put(buf, value);
+        uint32_t back = ~value;
+        if(len < 1 || len > 5 || log_varint_get(buf, len, &back) != len || back != value) wrong++;
+        if(log_varint_get(buf, len - 1, &back) != 0) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_archive_records(void) {
+    int wrong = 0;
+    uint32_t prev_ts = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        LogRecord rec, back;
+        random_record(&rec);
+        uint8_t buf[LOG_RECORD_MAX_ENCODED + 8];
+        size_t len = log_record_encode(&rec, prev_ts, buf);
+        if(len == 0 || len > LOG_RECORD_MAX_ENCODED) {
+            wrong++;
+            continue;
+        }
+        if(log_record_decode(buf, len, prev_ts, &back) != len || !same_record(&rec, &back)) wrong++;
+        for(size_t cut = 0; cut < len; cut++) {
+            if(log_record_decode(buf, cut, prev_ts, &back) != 0) wrong++;
+        }
+        // Mostly forwards, sometimes back (the clock was set back)
+        prev_ts = test_rand(8) ? rec.ts : rec.ts + test_rand(86400);
+    }
+    CHECK_EQ(wrong, 0);
+
+    uint8_t buf[4] = {0};
+    LogRecord back;
+    buf[1] = 0x07; // Type 7 is not an event
+    CHECK_EQ(log_record_decode(buf, 2, 0, &back), 0);
+}
+
+int main(void) {
+    scratch_init();
+    test_seed(47);
+    test_crc();
+    test_ids();
+    test_record_lines();
+    test_old_lines();
+    test_journal();
+    test_varints();
+    test_archive_records();
+    return test_done("codec");
+}
@@ -0,0 +1,329 @@
+// The packed 12-byte LogEntry: fields keep their full range, and the ring
+// keeps the right IDs through add, delete, undo, redo and edit - including
+// hand-written lines whose IDs are only kept as a hash (foreign) - and
+// agrees with the card after a restart.
+#include "test.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_codec.h"
+#include "log_patch.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define HAND_EVENTS 40
+#define OPS 400
+#define EVENTS_MAX (HAND_EVENTS + OPS)
+
+static AppData app;
+
+// Every event ever logged; the ring must show the newest live ones
+static LogRecord g_events[EVENTS_MAX];
+static bool g_live[EVENTS_MAX];
+static int g_count;
+
+// The undo journal as the user sees it (see journal_track)
+static int g_ops[JOURNAL_DEPTH];
+static int g_ops_count, g_cursor;
+
+static void app_start(void) {
+    log_append_flush();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app)) {
+    }
+}
+
+static void test_fields(void) {
+    LogEntry entry = {0};
+    entry.timestamp = 0xFFFFFFFF;
+    entry.id = 0xFFFFFFFF;
+    entry.duration = LOG_ENTRY_DURATION_MAX;
+    entry.type = LogEventSleepStop;
+    entry.foreign = 1;
+    CHECK_EQ(entry.timestamp, 0xFFFFFFFF);
+    CHECK_EQ(entry.id, 0xFFFFFFFF);
+    CHECK_EQ(entry.duration, LOG_ENTRY_DURATION_MAX);
+    CHECK_EQ(entry.type, LogEventSleepStop);
+    CHECK_EQ(entry.foreign, 1);
+
+    // Neighbouring fields don't bleed into each other
+    for(int type = 0; type < LOG_EVENT_TYPE_COUNT; type++) {
+        entry.type = type;
+        entry.foreign = !(type & 1);
+        CHECK_EQ(entry.duration, LOG_ENTRY_DURATION_MAX);
+        CHECK_EQ(entry.type, type);
+        CHECK_EQ(entry.foreign, !(type & 1));
+    }
+    entry.duration = 0;
+    CHECK_EQ(entry.type, LogEventSleepStop);
+    CHECK_EQ(entry.foreign, 1);
+}
+
+static bool is_stop(LogEventType type) {
+    return type == LogEventFeedingStop || type == LogEventSleepStop;
+}
+
+static bool ts_used(uint32_t ts) {
+    for(int i = 0; i < g_count; i++) {
+        if(g_events[i].ts == ts) return true;
+    }
+    return false;
+}
+
+// Older lines, some hand-edited: IDs in no form this app writes, and a
+// duration too long for the packed field
+static void write_hand_log(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, LOG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    uint32_t ts = sdk_rtc_now - 30 * 86400;
+    for(int i = 0; i < HAND_EVENTS; i++) {
+        ts += 3600 + test_rand(7200);
+        LogRecord* rec = &g_events[g_count];
+        rec->ts = ts;
+        rec->type = (LogEventType)test_rand(LOG_EVENT_TYPE_COUNT);
+        rec->duration = is_stop(rec->type) ? test_rand(4 * 3600) : 0;
+        if(i % 3 == 0) {
+            snprintf(rec->id, sizeof(rec->id), "hand-%02d-%lx", i, (unsigned long)test_rand(0xFFFFFF));
+        } else {
+            log_format_id(ts, rec->id);
+        }
+        if(i == HAND_EVENTS - 5) {
+            rec->type = LogEventSleepStop;
+            rec->duration = LOG_ENTRY_DURATION_MAX + 1000;
+        }
+        char line[LOG_LINE_MAX];
+        int len = log_format_record(rec, line, sizeof(line));
+        CHECK(len > 0 && storage_file_write(file, line, len) == (size_t)len);
+        if(rec->duration > LOG_ENTRY_DURATION_MAX) rec->duration = LOG_ENTRY_DURATION_MAX;
+        g_live[g_count++] = true;
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    sdk_rtc_now = ts + 3600;
+}
+
+static bool entry_has_id(const LogEntry* entry, const LogRecord* rec) {
+    uint32_t seed;
+    if(log_id_seed(rec->id, &seed)) return !entry->foreign && entry->id == seed;
+    return entry->foreign && entry->id == log_hash_id(rec->id);
+}
+
+static bool entry_is(const LogEntry* entry, const LogRecord* rec) {
+    return entry->timestamp == rec->ts && entry->type == rec->type &&
+           entry->duration == rec->duration && entry_has_id(entry, rec);
+}
+
+static int event_of(const LogEntry* entry) {
+    for(int i = 0; i < g_count; i++) {
+        if(entry_is(entry, &g_events[i])) return i;
+    }
+    return -1;
+}
+
+// Live events, newest first
+static int live_newest(int* out, int max) {
+    int count = 0;
+    bool taken[EVENTS_MAX] = {false};
+    while(count < max) {
+        int best = -1;
+        for(int i = 0; i < g_count; i++) {
+            if(g_live[i] && !taken[i] && (best < 0 || g_events[i].ts > g_events[best].ts)) best = i;
+        }
+        if(best < 0) break;
+        taken[best] = true;
+        out[count++] = best;
+    }
+    return count;
+}
+
+// In time order, each a live event, the newest one last
+static void check_ring(const char* when) {
+    int wrong = 0;
+    for(int i = 0; i < app.log_count; i++) {
+        int event = event_of(log_recent_get(&app, i));
+        if(event < 0 || !g_live[event]) wrong++;
+        if(i > 0 && log_recent_get(&app, i - 1)->timestamp >= log_recent_get(&app, i)->timestamp) wrong++;
+    }
+    int newest;
+    if(live_newest(&newest, 1) == 1) {
+        if(app.log_count == 0 || event_of(log_recent_get(&app, app.log_count - 1)) != newest) wrong++;
+    }
+    if(wrong) fprintf(stderr, "%s: %d ring entries wrong\n", when, wrong);
+    CHECK_EQ(wrong, 0);
+}
+
+// A restart reads the ring back from the card. Moved events come from the
+// patch overlay and the rest from the log tail, so older slots can skip
+// events - but every entry is still a live event with its own ID.
+static void check_reload(void) {
+    app_start();
+    int newest;
+    CHECK(app.log_count > 0 || live_newest(&newest, 1) == 0);
+    check_ring("after restart");
+}
+
+// The undo journal is replayed from deleted.jsonl, less whatever a startup
+// fold compacted away: go on from what the card kept
+static bool journal_sync(void) {
+    g_ops_count = app.journal.count;
+    g_cursor = app.journal.cursor;
+    for(int i = 0; i < g_ops_count; i++) {
+        int event = -1;
+        for(int j = 0; j < g_count && event < 0; j++) {
+            if(entry_has_id(&app.journal.ops[i].entry, &g_events[j])) event = j;
+        }
+        CHECK(event >= 0);
+        if(event < 0) return false;
+        CHECK_EQ(g_live[event], i >= g_cursor); // Undone ones are back
+        g_ops[i] = event;
+    }
+    return true;
+}
+
+static void journal_delete(int event) {
+    if(g_cursor < g_ops_count && g_ops[g_cursor] == event) {
+        g_cursor++; // Deleting the event redo would delete is a redo
+        return;
+    }
+    g_ops_count = g_cursor;
+    if(g_ops_count == JOURNAL_DEPTH) {
+        memmove(g_ops, g_ops + 1, sizeof(int) * (JOURNAL_DEPTH - 1));
+        g_ops_count--;
+    }
+    g_ops[g_ops_count++] = event;
+    g_cursor = g_ops_count;
+}
+
+static void op_add(void) {
+    sdk_rtc_now += 60 + test_rand(3 * 3600);
+    LogEventType type = (LogEventType)test_rand(LOG_EVENT_TYPE_COUNT);
+    uint32_t duration = is_stop(type) ? test_rand(4 * 3600) : 0;
+    log_add_event(&app, type, duration);
+    LogEntry* entry = log_recent_get(&app, app.log_count - 1);
+    LogRecord* rec = &g_events[g_count];
+    rec->ts = sdk_rtc_now;
+    rec->type = type;
+    rec->duration = duration;
+    log_format_id(entry->id, rec->id);
+    CHECK(!entry->foreign);
+    CHECK(entry_is(entry, rec));
+    g_live[g_count++] = true;
+}
+
+static void op_delete(void) {
+    int newest;
+    bool any = live_newest(&newest, 1) == 1;
+    CHECK_EQ(log_delete_last(&app), any);
+    if(!any) return;
+    g_live[newest] = false;
+    journal_delete(newest);
+}
+
+static void op_undo(void) {
+    CHECK_EQ(log_undo(&app), g_cursor > 0);
+    if(g_cursor > 0) g_live[g_ops[--g_cursor]] = true;
+}
+
+static void op_redo(void) {
+    CHECK_EQ(log_redo(&app), g_cursor < g_ops_count);
+    if(g_cursor < g_ops_count) g_live[g_ops[g_cursor++]] = false;
+}
+
+static void op_edit(void) {
+    if(app.log_count == 0) return;
+    LogEntry edited = *log_recent_get(&app, test_rand(app.log_count));
+    int event = event_of(&edited);
+    CHECK(event >= 0);
+    if(event < 0) return;
+
+    uint32_t ts;
+    do {
+        ts = sdk_rtc_now - test_rand(2 * 86400);
+    } while(ts_used(ts));
+    edited.timestamp = test_rand(2) ? ts : edited.timestamp;
+    if(is_stop(edited.type)) edited.duration = test_rand(LOG_ENTRY_DURATION_MAX + 1);
+    if(!log_edit_event(&app, &edited)) {
+        CHECK_EQ(log_patch_count(), PATCH_MAX); // Refused until the next startup folds
+        return;
+    }
+    g_events[event].ts = edited.timestamp;
+    g_events[event].duration = edited.duration;
+}
+
+// Undo, edit, redo, undo: the event comes back with the edit, as on the card
+static void test_edit_between_undo_redo(void) {
+    test_sd_fresh();
+    app_start();
+    for(int i = 0; i < 3; i++) {
+        sdk_rtc_now += 600;
+        log_add_event(&app, LogEventSleepStop, 1200);
+    }
+    CHECK(log_delete_last(&app));
+    CHECK(log_undo(&app));
+    LogEntry edited = *log_recent_get(&app, 2);
+    edited.timestamp -= 300;
+    edited.duration = 900;
+    CHECK(log_edit_event(&app, &edited));
+    CHECK(log_redo(&app));
+    CHECK_EQ(app.log_count, 2);
+    CHECK(log_undo(&app));
+    CHECK_EQ(app.log_count, 3);
+    LogEntry* entry = log_recent_get(&app, 2);
+    CHECK_EQ(entry->timestamp, edited.timestamp);
+    CHECK_EQ(entry->duration, 900);
+    app_start();
+    entry = log_recent_get(&app, 2);
+    CHECK_EQ(entry->timestamp, edited.timestamp);
+    CHECK_EQ(entry->duration, 900);
+}
+
+int main(void) {
+    scratch_init();
+    CHECK_EQ(sizeof(LogEntry), 12);
+    test_fields();
+    test_edit_between_undo_redo();
+
+    for(uint32_t seed = 1; seed <= 4; seed++) {
+        test_seed(43 * seed);
+        log_append_flush(); // The last run's buffered lines belong to its card
+        test_sd_fresh();
+        g_count = 0;
+        g_ops_count = g_cursor = 0;
+        write_hand_log();
+        app_start();
+        int foreign = 0;
+        for(int i = 0; i < app.log_count; i++) foreign += log_recent_get(&app, i)->foreign;
+        CHECK(foreign > 0);
+        check_ring("start");
+
+        // The newest hand-written line (i = 39) has a foreign ID
+        CHECK(log_recent_get(&app, app.log_count - 1)->foreign);
+        op_delete();
+        op_undo();
+        op_redo();
+        op_undo();
+        check_ring("foreign undo");
+
+        for(int op = 0; op < OPS; op++) {
+            switch(test_rand(8)) {
+                case 0:
+                case 1: op_add(); break;
+                case 2:
+                case 3: op_delete(); break;
+                case 4: op_undo(); break;
+                case 5: op_redo(); break;
+                default: op_edit(); break;
+            }
+            check_ring("after op");
+            if(op % 50 == 49) {
+                check_reload();
+                if(!journal_sync()) return test_done("entry");
+            }
+        }
+    }
+    return test_done("entry");
+}
@@ -0,0 +1,119 @@
+// Input queue under bursts from a second thread, as the GUI input callback
+// drives it: records come out in push order, nothing is lost while the
+// queue has room, and every press pushed into a full queue is counted as
+// dropped - exactly once.
+#include "test.h"
+#include "input_queue.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
+
+#define ROUNDS 20000
+#define OVERFLOW 5 // Extra presses per burst once the queue is full
+
+// The 16-bit sequence number rides in key (low byte) and type (high byte)
+static void push_seq(uint16_t seq, atomic_uint* failed) {
+    InputEvent event = {.sequence = seq, .key = (InputKey)(seq & 0xFF), .type = (InputType)(seq >> 8)};
+    if(!input_queue_push(&event)) atomic_fetch_add(failed, 1);
+}
+
+static uint16_t record_seq(const InputRecord* record) {
+    return (uint16_t)(record->key | (record->type << 8));
+}
+
+static struct {
+    bool overflow; // Bursts overrun the queue on purpose
+    atomic_uint pushed;
+    atomic_uint failed; // Pushes that returned false
+    atomic_uint popped;
+    atomic_bool draining; // Consumer may run; cleared to let a burst fill the queue
+    atomic_bool paused; // Consumer saw draining cleared and stopped popping
+    atomic_bool done;
+} g;
+
+static void* producer(void* arg) {
+    UNUSED(arg);
+    uint16_t seq = 0;
+    for(int round = 0; round < ROUNDS; round++) {
+        if(g.overflow) {
+            // Consumer stopped on an empty queue: SIZE presses fit, OVERFLOW
+            // more are dropped
+            while(atomic_load(&g.popped) + atomic_load(&g.failed) != atomic_load(&g.pushed)) sched_yield();
+            atomic_store(&g.draining, false);
+            while(!atomic_load(&g.paused)) sched_yield();
+            for(int i = 0; i < INPUT_QUEUE_SIZE + OVERFLOW; i++) {
+                push_seq(seq++, &g.failed);
+                atomic_fetch_add(&g.pushed, 1);
+            }
+            atomic_store(&g.draining, true);
+        } else {
+            // Never more in flight than the queue holds
+            int burst = 1 + round % INPUT_QUEUE_SIZE;
+            while(atomic_load(&g.pushed) - atomic_load(&g.popped) + burst > INPUT_QUEUE_SIZE) sched_yield();
+            for(int i = 0; i < burst; i++) {
+                push_seq(seq++, &g.failed);
+                atomic_fetch_add(&g.pushed, 1);
+            }
+        }
+    }
+    atomic_store(&g.done, true);
+    return NULL;
+}
+
+// Returns the number of records out of order
+static uint32_t consume(void) {
+    uint32_t wrong = 0;
+    int32_t last = -1;
+    InputRecord record;
+    for(;;) {
+        if(!atomic_load(&g.draining)) {
+            atomic_store(&g.paused, true);
+            while(!atomic_load(&g.draining)) sched_yield();
+            atomic_store(&g.paused, false);
+            continue;
+        }
+        bool done = atomic_load(&g.done);
+        if(!input_queue_pop(&record)) {
+            if(done) break;
+            sched_yield();
+            continue;
+        }
+        uint16_t seq = record_seq(&record);
+        // Increasing, modulo 16 bits; with drops it may skip ahead
+        uint16_t step = (uint16_t)(seq - (uint16_t)last);
+        if(last >= 0 && (step == 0 || (!g.overflow && step != 1) || step > INPUT_QUEUE_SIZE + OVERFLOW)) {
+            wrong++;
+        }
+        last = seq;
+        atomic_fetch_add(&g.popped, 1);
+    }
+    return wrong;
+}
+
+static void run(bool overflow) {
+    g.overflow = overflow;
+    atomic_store(&g.pushed, 0);
+    atomic_store(&g.failed, 0);
+    atomic_store(&g.popped, 0);
+    atomic_store(&g.draining, true);
+    atomic_store(&g.paused, false);
+    atomic_store(&g.done, false);
+    uint32_t dropped_before = input_queue_dropped();
+
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, producer, NULL) == 0);
+    uint32_t wrong = consume();
+    pthread_join(thread, NULL);
+
+    uint32_t dropped = input_queue_dropped() - dropped_before;
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(atomic_load(&g.popped) + dropped, atomic_load(&g.pushed));
+    CHECK_EQ(dropped, atomic_load(&g.failed));
+    CHECK_EQ(dropped, overflow ? ROUNDS * OVERFLOW : 0);
+}
+
+int main(void) {
+    run(false);
+    run(true);
+    return test_done("input_queue");
+}
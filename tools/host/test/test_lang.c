@@ -0,0 +1,99 @@
+// Language packs: a good pack is used, and a truncated, padded or corrupt
+// one - offsets past the blob or into the middle of a string, a blob
+// without its final NUL - falls back to English as a whole.
+#include "test.h"
+#include "translations.h"
+#include "log_codec.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define PACK_PATH APP_ASSETS_PATH("lang/1.lang")
+#define HEADER_SIZE (8 + LANG_NAME_LEN)
+
+static const char g_blob[] = "Uno\0Dos"; // Two strings, the NUL ends it
+static uint8_t g_pack[HEADER_SIZE + TR_COUNT * 2 + sizeof(g_blob)];
+
+static size_t pack_build(void) {
+    memset(g_pack, 0, sizeof(g_pack));
+    memcpy(g_pack, "BLT1", 4);
+    log_put_u16(g_pack + 4, TR_COUNT);
+    log_put_u16(g_pack + 6, sizeof(g_blob));
+    strcpy((char*)g_pack + 8, "Test");
+    for(int i = 0; i < TR_COUNT; i++) log_put_u16(g_pack + HEADER_SIZE + i * 2, 0xFFFF);
+    log_put_u16(g_pack + HEADER_SIZE + TR_MAIN_AWAKE * 2, 0);
+    log_put_u16(g_pack + HEADER_SIZE + TR_MAIN_FEEDING * 2, 4);
+    memcpy(g_pack + HEADER_SIZE + TR_COUNT * 2, g_blob, sizeof(g_blob));
+    return sizeof(g_pack);
+}
+
+static void pack_write(const uint8_t* data, size_t size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, EXT_PATH("apps_assets"));
+    storage_common_mkdir(storage, EXT_PATH("apps_assets/baby_log"));
+    storage_common_mkdir(storage, APP_ASSETS_PATH("lang"));
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, PACK_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    CHECK_EQ(storage_file_write(file, data, size), size);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Loads the pack as language 1; true if its strings are in use
+static bool pack_used(const uint8_t* data, size_t size) {
+    pack_write(data, size);
+    tr_init(1);
+    const char* awake = tr_get(NULL, TR_MAIN_AWAKE);
+    const char* feeding = tr_get(NULL, TR_MAIN_FEEDING);
+    if(strcmp(awake, "Uno") == 0 && strcmp(feeding, "Dos") == 0) return true;
+    // Not used at all: English everywhere, never half a pack
+    CHECK(strcmp(awake, "Awake") == 0);
+    CHECK(strcmp(feeding, "Feeding") == 0);
+    return false;
+}
+
+static void offset_set(TranslationKey key, uint16_t offset) {
+    pack_build();
+    log_put_u16(g_pack + HEADER_SIZE + key * 2, offset);
+}
+
+int main(void) {
+    scratch_init();
+    test_sd_fresh();
+
+    size_t size = pack_build();
+    CHECK(pack_used(g_pack, size));
+    CHECK(strcmp(tr_get(NULL, TR_MAIN_SLEEPING), "Sleeping") == 0); // Not in the pack
+
+    int used = 0;
+    for(size_t cut = HEADER_SIZE; cut < size; cut++) used += pack_used(g_pack, cut);
+    CHECK_EQ(used, 0);
+
+    uint8_t padded[sizeof(g_pack) + 1];
+    memcpy(padded, g_pack, size);
+    padded[size] = 'x';
+    CHECK(!pack_used(padded, size + 1));
+
+    offset_set(TR_MAIN_FEEDING, sizeof(g_blob));
+    CHECK(!pack_used(g_pack, size));
+    offset_set(TR_MAIN_FEEDING, 0xFFFE);
+    CHECK(!pack_used(g_pack, size));
+    offset_set(TR_MAIN_FEEDING, 5); // Inside "Dos"
+    CHECK(!pack_used(g_pack, size));
+
+    pack_build();
+    g_pack[size - 1] = 'x'; // Last string unterminated
+    CHECK(!pack_used(g_pack, size));
+
+    pack_build();
+    log_put_u16(g_pack + 6, sizeof(g_blob) + 16); // Blob said to be longer than the file
+    CHECK(!pack_used(g_pack, size));
+
+    pack_build();
+    log_put_u16(g_pack + 4, TR_COUNT - 1);
+    CHECK(!pack_used(g_pack, size));
+
+    // A good pack after the bad ones is used again
+    CHECK(pack_used(g_pack, pack_build()));
+    return test_done("lang");
+}
@@ -0,0 +1,133 @@
+// The last-event table against the recent ring: after any add, past add,
+// edit, delete, undo or redo, each type's entry is the ring's newest event
+// of that type, and last.bin - once the derived tables are saved - loads
+// back as the table that was in memory. Restarts alternate between a clean
+// close and power loss, after which the table is seeded again.
+#include "test.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "log_tables.h"
+#include "log_codec.h"
+#include "scratch.h"
+#include <string.h>
+
+#define OPS 600
+
+static AppData app;
+
+static void app_start(bool clean) {
+    if(clean) {
+        log_tables_close();
+    } else {
+        log_append_flush(); // Power loss: last.bin is as last saved
+    }
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app)) {
+    }
+}
+
+static bool is_stop(LogEventType type) {
+    return type == LogEventFeedingStop || type == LogEventSleepStop;
+}
+
+static uint32_t entry_hash(const LogEntry* entry) {
+    if(entry->foreign) return entry->id;
+    char text[LOG_ID_LEN + 1];
+    log_format_id(entry->id, text);
+    return log_hash_id(text);
+}
+
+// Every type the ring holds: timestamp, and ID and duration unless two
+// events of the type share the newest second
+static int check_table(int op) {
+    int wrong = 0;
+    for(int type = 0; type < LOG_EVENT_TYPE_COUNT; type++) {
+        const LogEntry* newest = NULL;
+        bool tie = false;
+        for(int i = 0; i < app.log_count; i++) {
+            const LogEntry* entry = log_recent_get(&app, i);
+            if(entry->type != type) continue;
+            tie = newest && entry->timestamp == newest->timestamp;
+            newest = entry;
+        }
+        if(!newest) continue;
+        const LastEvent* last = &app.last[type];
+        bool same = last->ts == newest->timestamp &&
+                    (tie || (last->id == entry_hash(newest) && last->duration == newest->duration));
+        if(!same) {
+            if(wrong == 0) {
+                fprintf(stderr, "op %d type %d: table %lu, ring %lu\n", op, type,
+                    (unsigned long)last->ts, (unsigned long)newest->timestamp);
+            }
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void random_op(void) {
+    sdk_rtc_now += 60 + test_rand(3000);
+    LogEventType type = (LogEventType)test_rand(LOG_EVENT_TYPE_COUNT);
+    uint32_t duration = is_stop(type) ? test_rand(4000) : 0;
+    uint32_t r = test_rand(100);
+    if(r < 55) {
+        log_add_event(&app, type, duration);
+    } else if(r < 65) {
+        log_add_past_event(&app, type, sdk_rtc_now - test_rand(200000), duration);
+    } else if(r < 75) {
+        if(app.log_count == 0) return;
+        LogEntry edited = *log_recent_get(&app, test_rand(app.log_count));
+        if(test_rand(2)) {
+            edited.timestamp -= test_rand(20000);
+        } else if(is_stop(edited.type)) {
+            edited.duration = test_rand(5000);
+        }
+        log_edit_event(&app, &edited);
+    } else if(r < 85) {
+        log_delete_last(&app);
+    } else if(r < 92) {
+        log_undo(&app);
+    } else if(r < 96) {
+        log_redo(&app);
+    } else {
+        log_append_flush();
+    }
+    while(log_sessions_step(&app)) {
+    }
+}
+
+int main(void) {
+    scratch_init();
+    int wrong = 0;
+    for(uint32_t seed = 1; seed <= 6; seed++) {
+        test_seed(49 * seed);
+        log_tables_close(); // The last run's tables belong to its card
+        test_sd_fresh();
+        app_start(false);
+
+        for(int op = 0; op < OPS; op++) {
+            random_op();
+            wrong += check_table(op);
+
+            if(op % 100 == 99) {
+                // What last.bin holds once the tables are saved
+                LastEvent saved[LOG_EVENT_TYPE_COUNT];
+                memcpy(saved, app.last, sizeof(saved));
+                log_tables_save();
+                memset(app.last, 0, sizeof(app.last));
+                log_last_load(&app);
+                CHECK(memcmp(saved, app.last, sizeof(saved)) == 0);
+
+                // And after a restart, still the ring's newest
+                app_start(op % 200 == 99);
+                wrong += check_table(op);
+            }
+        }
+    }
+    CHECK_EQ(wrong, 0);
+    return test_done("last");
+}
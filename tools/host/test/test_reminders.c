@@ -0,0 +1,95 @@
+// Reminders for every child, not only the active one: each (child, kind)
+// has its own deadline, alerts once, and says which child it is for -
+// also for a child that has not been opened since the app started.
+#include "test.h"
+#include "child.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_tables.h"
+#include "reminder.h"
+#include "scratch.h"
+#include <string.h>
+
+#define FEED_MINUTES 180
+
+static AppData app;
+
+static void timer_cb(void* context) {
+    UNUSED(context);
+}
+
+static void app_start(void) {
+    log_append_flush();
+    save_config(&app);
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app)) {
+    }
+    app.remind_minutes[ReminderFeed] = FEED_MINUTES;
+    reminder_free();
+    reminder_init(timer_cb, NULL);
+}
+
+// Fires what is due at now, returns the number of alerts
+static uint32_t fire_at(uint32_t now) {
+    sdk_rtc_now = now;
+    uint32_t before = sdk_alert_count;
+    app.remind_alert = false;
+    reminder_sync(&app, now);
+    reminder_fire(&app, now);
+    return sdk_alert_count - before;
+}
+
+int main(void) {
+    scratch_init();
+    test_sd_fresh();
+    uint32_t t0 = sdk_rtc_now;
+    app_start();
+
+    // Child 0 fed at t0, child 1 an hour later
+    log_add_event(&app, LogEventFeedingStart, 0);
+    CHECK(child_add(&app));
+    snprintf(app.cfg.name, sizeof(app.cfg.name), "Mia");
+    save_config(&app);
+    sdk_rtc_now = t0 + 3600;
+    log_add_event(&app, LogEventFeedingStart, 0);
+    CHECK_EQ(app.active_child, 1);
+
+    reminder_sync(&app, sdk_rtc_now);
+    CHECK_EQ(sdk_timer_ticks, (FEED_MINUTES * 60 - 3600) * 1000); // Child 0's comes first
+
+    CHECK_EQ(fire_at(t0 + FEED_MINUTES * 60), 1);
+    CHECK(app.remind_alert);
+    CHECK_EQ(app.remind_alert_child, 0);
+    CHECK_EQ(app.remind_alert_kind, ReminderFeed);
+    CHECK_EQ(fire_at(t0 + FEED_MINUTES * 60 + 60), 0); // Once per deadline
+
+    CHECK_EQ(fire_at(t0 + 3600 + FEED_MINUTES * 60), 1);
+    CHECK_EQ(app.remind_alert_child, 1);
+
+    // After a restart child 0 is only peeked, never opened
+    sdk_rtc_now = t0 + 2 * 3600;
+    log_tables_close(); // As on exit
+    app_start();
+    CHECK_EQ(app.active_child, 1);
+    CHECK(app.children[0].peeked && !app.children[0].loaded);
+    reminder_sync(&app, sdk_rtc_now);
+    CHECK_EQ(sdk_timer_ticks, (FEED_MINUTES * 60 - 2 * 3600) * 1000);
+    CHECK_EQ(fire_at(t0 + FEED_MINUTES * 60), 1);
+    CHECK_EQ(app.remind_alert_child, 0);
+
+    // A feed logged for child 0 moves only its own deadline
+    child_switch(&app, 0);
+    sdk_rtc_now = t0 + 4 * 3600;
+    log_add_event(&app, LogEventFeedingStart, 0);
+    CHECK_EQ(fire_at(t0 + 3600 + FEED_MINUTES * 60), 1);
+    CHECK_EQ(app.remind_alert_child, 1);
+    CHECK_EQ(fire_at(t0 + 4 * 3600 + FEED_MINUTES * 60), 1);
+    CHECK_EQ(app.remind_alert_child, 0);
+    CHECK(strcmp(app.children[1].cfg.name, "Mia") == 0);
+
+    reminder_free();
+    return test_done("reminders");
+}
@@ -0,0 +1,168 @@
+// Session index under random adds, past events, edits, deletes, undo and
+// redo: after every batch the incrementally kept index must equal a full
+// re-pairing of the history, and no operation may have fallen back to a
+// rebuild to get there. Records are little-endian on the card whatever
+// the host's byte order.
+#include "test.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define SEEDS 8
+#define OPS 480
+#define CHECK_EVERY 60
+#define SESSIONS_MAX 2048
+
+static AppData app;
+static SessionRecord g_kept[SessionKindCount][SESSIONS_MAX];
+static SessionRecord g_rebuilt[SessionKindCount][SESSIONS_MAX];
+static uint32_t g_fallbacks; // Operations that left the index to a rebuild
+
+static void read_index(SessionRecord out[SessionKindCount][SESSIONS_MAX], uint32_t* counts) {
+    for(int kind = 0; kind < SessionKindCount; kind++) {
+        counts[kind] = log_sessions_count((SessionKind)kind);
+        CHECK(counts[kind] <= SESSIONS_MAX);
+        CHECK_EQ(log_sessions_read((SessionKind)kind, 0, out[kind], SESSIONS_MAX), counts[kind]);
+    }
+}
+
+static uint32_t random_duration(LogEventType type) {
+    return (type == LogEventFeedingStop || type == LogEventSleepStop) ? test_rand(4 * 3600) : 0;
+}
+
+static void random_op(void) {
+    sdk_rtc_now += 60 + test_rand(3000);
+    uint32_t r = test_rand(100);
+    LogEventType type = (LogEventType)test_rand(LOG_EVENT_TYPE_COUNT);
+    if(r < 55) {
+        log_add_event(&app, type, random_duration(type));
+    } else if(r < 65) {
+        log_add_past_event(&app, type, sdk_rtc_now - test_rand(2 * 86400), random_duration(type));
+    } else if(r < 75 && app.log_count > 0) {
+        LogEntry entry = *log_recent_get(&app, test_rand(app.log_count));
+        if(test_rand(2)) {
+            entry.timestamp -= test_rand(6 * 3600);
+        } else {
+            entry.duration = test_rand(4 * 3600);
+        }
+        log_edit_event(&app, &entry);
+    } else if(r < 85) {
+        log_delete_last(&app);
+    } else if(r < 92) {
+        log_undo(&app);
+    } else if(r < 96) {
+        log_redo(&app);
+    } else {
+        log_append_flush();
+    }
+    if(app.sessions_status == JobRunning) {
+        g_fallbacks++;
+        while(log_sessions_step(&app)) {
+        }
+    }
+}
+
+// Returns false on the first difference, after reporting it
+static bool compare(uint32_t seed) {
+    uint32_t kept[SessionKindCount];
+    uint32_t rebuilt[SessionKindCount];
+    log_append_flush();
+    read_index(g_kept, kept);
+    log_sessions_rebuild(&app);
+    while(log_sessions_step(&app)) {
+    }
+    CHECK_EQ(app.sessions_status, JobDone);
+    read_index(g_rebuilt, rebuilt);
+
+    for(int kind = 0; kind < SessionKindCount; kind++) {
+        if(kept[kind] != rebuilt[kind]) {
+            fprintf(stderr, "seed %u kind %d: %u sessions kept, %u rebuilt\n", seed, kind, kept[kind], rebuilt[kind]);
+            return false;
+        }
+        for(uint32_t i = 0; i < kept[kind]; i++) {
+            const SessionRecord* a = &g_kept[kind][i];
+            const SessionRecord* b = &g_rebuilt[kind][i];
+            if(memcmp(a, b, sizeof(SessionRecord)) == 0) continue;
+            fprintf(stderr, "seed %u kind %d #%u: kept %u-%u ids %08x/%08x, rebuilt %u-%u ids %08x/%08x\n",
+                seed, kind, i, a->start_ts, a->end_ts, a->start_id, a->stop_id, b->start_ts, b->end_ts,
+                b->start_id, b->stop_id);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_layout(void) {
+    SessionRecord session = {
+        .start_ts = 0x04030201,
+        .end_ts = 0x08070605,
+        .duration = 0x0c0b0a09,
+        .start_id = 0x100f0e0d,
+        .stop_id = 0x14131211,
+        .type = LogEventSleepStart,
+        .reserved = {1, 2, 3},
+    };
+    uint8_t data[SESSIONS_RECORD_SIZE];
+    log_sessions_encode(&session, data);
+    for(int i = 0; i < 20; i++) CHECK_EQ(data[i], i + 1);
+    CHECK_EQ(data[20], LogEventSleepStart);
+    CHECK(data[21] == 0 && data[22] == 0 && data[23] == 0);
+
+    SessionRecord back;
+    log_sessions_decode(data, &back);
+    session.reserved[0] = session.reserved[1] = session.reserved[2] = 0;
+    CHECK(memcmp(&back, &session, sizeof(SessionRecord)) == 0);
+}
+
+// The last index left by the random runs, byte for byte as encoded
+static void test_card_bytes(void) {
+    log_append_flush();
+    uint32_t count = log_sessions_count(SessionFeeding);
+    CHECK(count > 0 && count <= SESSIONS_MAX);
+    CHECK_EQ(log_sessions_read(SessionFeeding, 0, g_kept[0], count), count);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, SESSIONS_FEED_PATH, FSAM_READ, FSOM_OPEN_EXISTING));
+    CHECK(storage_file_seek(file, 8, true)); // Past the header
+    int wrong = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        uint8_t raw[SESSIONS_RECORD_SIZE];
+        uint8_t want[SESSIONS_RECORD_SIZE];
+        CHECK_EQ(storage_file_read(file, raw, sizeof(raw)), sizeof(raw));
+        log_sessions_encode(&g_kept[0][i], want);
+        if(memcmp(raw, want, sizeof(raw)) != 0) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+int main(void) {
+    scratch_init();
+    int wrong = 0;
+    for(uint32_t seed = 1; seed <= SEEDS; seed++) {
+        test_seed(seed);
+        test_sd_fresh();
+        memset(&app, 0, sizeof(app));
+        load_config(&app);
+        child_init(&app);
+        while(log_sessions_step(&app)) {
+        }
+        for(int op = 1; op <= OPS; op++) {
+            random_op();
+            if(op % CHECK_EVERY == 0 && !compare(seed)) {
+                wrong++;
+                break;
+            }
+        }
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(g_fallbacks, 0);
+    test_card_bytes();
+    test_layout();
+    return test_done("sessions");
+}
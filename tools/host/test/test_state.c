@@ -0,0 +1,88 @@
+// state.json: timers saved before "state_version" used the old timestamp
+// formula and are converted on load; current files round-trip unchanged.
+#include "test.h"
+#include "app_state.h"
+#include "child.h"
+#include "date_util.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+static AppData app;
+
+static uint32_t old_ts(uint16_t y, uint8_t m, uint8_t d, uint32_t seconds) {
+    uint32_t days = (y - 1970) * 365 + (y - 1969) / 4 + (m - 1) * 30 + d - 1;
+    return days * 86400 + seconds;
+}
+
+static uint32_t unix_ts(uint16_t y, uint8_t m, uint8_t d, uint32_t seconds) {
+    return (uint32_t)date_to_days(y, m, d) * 86400 + seconds;
+}
+
+static void write_state(const char* json) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, child_paths()->state, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    CHECK_EQ(storage_file_write(file, json, strlen(json)), strlen(json));
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void write_v1(bool feeding, uint32_t feeding_ts, bool sleep, uint32_t sleep_ts) {
+    char json[256];
+    snprintf(json, sizeof(json),
+        "{\n  \"feeding_active\": %s,\n  \"sleep_active\": %s,\n"
+        "  \"feeding_start_ts\": %lu,\n  \"sleep_start_ts\": %lu\n}\n",
+        feeding ? "true" : "false", sleep ? "true" : "false",
+        (unsigned long)feeding_ts, (unsigned long)sleep_ts);
+    write_state(json);
+}
+
+int main(void) {
+    scratch_init();
+    test_sd_fresh();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    sdk_rtc_now = unix_ts(2026, 10, 19, 12 * 3600);
+
+    // A feed running since yesterday afternoon
+    write_v1(true, old_ts(2026, 10, 18, 14 * 3600 + 30 * 60), false, 0);
+    load_state(&app);
+    CHECK(app.state.feeding_active);
+    CHECK_EQ(app.state.feeding_start_ts, unix_ts(2026, 10, 18, 14 * 3600 + 30 * 60));
+
+    // Every date of the old scheme maps back to itself, bar the overlap day
+    int wrong = 0;
+    for(int32_t days = date_to_days(2024, 1, 1); days < date_to_days(2027, 1, 1); days++) {
+        uint16_t y;
+        uint8_t m, d;
+        date_from_days(days, &y, &m, &d);
+        if(d == 31) continue; // Same old value as the 1st of the next month
+        sdk_rtc_now = unix_ts(y, m, d, 86399);
+        write_v1(false, 0, true, old_ts(y, m, d, 3600));
+        load_state(&app);
+        if(!app.state.sleep_active || app.state.sleep_start_ts != unix_ts(y, m, d, 3600)) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+
+    // A start after now (the clock was set back since) is dropped
+    sdk_rtc_now = unix_ts(2026, 10, 19, 12 * 3600);
+    write_v1(true, sdk_rtc_now + 3 * 86400, true, 0);
+    load_state(&app);
+    CHECK(!app.state.feeding_active);
+    CHECK(!app.state.sleep_active);
+
+    // Saved files carry the version and load back as they were
+    app.state.feeding_active = false;
+    app.state.sleep_active = true;
+    app.state.feeding_start_ts = 0;
+    app.state.sleep_start_ts = sdk_rtc_now - 1800;
+    save_state(&app);
+    memset(&app.state, 0, sizeof(app.state));
+    load_state(&app);
+    CHECK(app.state.sleep_active);
+    CHECK_EQ(app.state.sleep_start_ts, sdk_rtc_now - 1800);
+
+    return test_done("state");
+}
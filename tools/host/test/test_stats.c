@@ -0,0 +1,213 @@
+// Interval statistics: stats.bin is written with the other derived tables,
+// not per event or per log write, and after power loss the statistics are
+// rebuilt to what they were. Deleting, undoing or adding a past feed start
+// rebuilds them from the session index: the result is what logging the
+// surviving feeds live would have given, even once the ring holds no feeds
+// at all, and a rebuild cut short by exit runs again on the next start.
+#include "test.h"
+#include "log_store.h"
+#include "log_stats.h"
+#include "log_append.h"
+#include "log_import.h"
+#include "log_sessions.h"
+#include "log_last.h"
+#include "log_tables.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define FEED_GAP (3 * 3600)
+
+static AppData app;
+
+static bool stats_on_card(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool exists = storage_common_exists(storage, STATS_PATH);
+    furi_record_close(RECORD_STORAGE);
+    return exists;
+}
+
+static void remove_stats(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, STATS_PATH);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool same_stats(const LogStats* a, const LogStats* b) {
+    return memcmp(a, b, sizeof(LogStats)) == 0;
+}
+
+// As the main loop does
+static void stats_settle(void) {
+    while(log_sessions_step(&app) || log_stats_step(&app)) {
+    }
+}
+
+static void feed(uint32_t gap) {
+    sdk_rtc_now += gap;
+    log_add_event(&app, LogEventFeedingStart, 0);
+}
+
+// Power loss: what reached the card is all there is
+static void app_start(void) {
+    log_append_flush();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    stats_settle();
+}
+
+static void app_restart(void) {
+    log_tables_close(); // As on exit
+    app_start();
+}
+
+static void test_save_point(void) {
+    test_sd_fresh();
+    app_start();
+    remove_stats();
+    for(int i = 0; i < 4; i++) feed(FEED_GAP);
+    log_append_flush();
+    CHECK(!stats_on_card()); // Not with the log lines
+    CHECK(app.stats.feed.count == 3);
+
+    LogStats shown = app.stats;
+    app_start();
+    CHECK(!stats_on_card());
+    CHECK(same_stats(&shown, &app.stats)); // Rebuilt
+
+    log_tables_save();
+    CHECK(stats_on_card());
+    app_restart();
+    CHECK(same_stats(&shown, &app.stats));
+}
+
+static void diapers(int count) {
+    for(int i = 0; i < count; i++) {
+        sdk_rtc_now += 600;
+        log_add_event(&app, LogEventDiaper, 0);
+    }
+}
+
+static void test_delete_undo(void) {
+    test_sd_fresh();
+    app_start();
+    for(int i = 0; i < 2 * STATS_WINDOW; i++) feed(FEED_GAP);
+    diapers(MAX_LOG_ENTRIES); // No feed left in the ring
+    LogStats before = app.stats;
+    CHECK_EQ(before.feed.count, STATS_WINDOW);
+
+    // A feed logged by mistake half an hour after the last one
+    feed(40 * 60);
+    LogStats mistake = app.stats;
+    CHECK(!same_stats(&mistake, &before));
+    CHECK(log_delete_last(&app));
+    CHECK_EQ(app.stats_status, JobRunning);
+    stats_settle();
+    CHECK(same_stats(&app.stats, &before));
+
+    CHECK(log_undo(&app));
+    stats_settle();
+    CHECK(same_stats(&app.stats, &mistake));
+    CHECK(log_redo(&app));
+    stats_settle();
+    CHECK(same_stats(&app.stats, &before));
+
+    // A diaper delete leaves them be
+    diapers(1);
+    CHECK(log_delete_last(&app));
+    CHECK(app.stats_status != JobRunning);
+    CHECK(same_stats(&app.stats, &before));
+
+    app_restart();
+    CHECK(same_stats(&app.stats, &before));
+
+    // Exit before the rebuild finishes: the next start redoes it
+    feed(40 * 60);
+    log_tables_save(); // stats.bin has the mistake
+    CHECK(log_delete_last(&app));
+    log_stats_cancel(&app);
+    app_restart();
+    CHECK(same_stats(&app.stats, &before));
+}
+
+// A feed added afterwards between two others splits their interval, the
+// same as if it had been logged at the time
+static void test_past_event(void) {
+    static const uint32_t hours[] = {3, 6, 9, 10, 12, 15, 18};
+    const int missed = 3; // Index into hours[]
+    uint32_t first = sdk_rtc_now;
+
+    test_sd_fresh();
+    app_start();
+    for(size_t i = 0; i < COUNT_OF(hours); i++) {
+        sdk_rtc_now = first + hours[i] * 3600;
+        log_add_event(&app, LogEventFeedingStart, 0);
+    }
+    LogStats live = app.stats;
+
+    log_tables_close();
+    test_sd_fresh();
+    sdk_rtc_now = first;
+    app_start();
+    for(size_t i = 0; i < COUNT_OF(hours); i++) {
+        if((int)i == missed) continue;
+        sdk_rtc_now = first + hours[i] * 3600;
+        log_add_event(&app, LogEventFeedingStart, 0);
+    }
+    CHECK(!same_stats(&app.stats, &live));
+    CHECK(log_add_past_event(&app, LogEventFeedingStart, first + hours[missed] * 3600, 0));
+    stats_settle();
+    CHECK(same_stats(&app.stats, &live));
+}
+
+// The other device logged feeds this one never saw
+static void test_import(void) {
+    test_sd_fresh();
+    app_start();
+    uint32_t first = sdk_rtc_now;
+    for(int i = 0; i < 3; i++) feed(FEED_GAP);
+    log_append_flush();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, EXT_PATH("apps/baby_log/import"));
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, IMPORT_LOG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(int i = 1; i <= 6; i++) {
+        LogRecord rec = {.ts = first + 3 * FEED_GAP + i * 2 * 3600, .type = LogEventFeedingStart};
+        log_format_id(rec.ts, rec.id);
+        char line[LOG_LINE_MAX];
+        int len = log_format_record(&rec, line, sizeof(line));
+        CHECK(len > 0 && storage_file_write(file, line, len) == (size_t)len);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    sdk_rtc_now = first + 3 * FEED_GAP + 13 * 3600;
+
+    CHECK(log_import_start(&app));
+    while(log_import_step(&app)) {
+    }
+    CHECK_EQ(app.import_status, JobDone);
+    // As the main loop does once the merge is done
+    log_load_recent(&app);
+    log_journal_clear(&app);
+    log_sessions_rebuild(&app);
+    log_last_seed(&app);
+    log_stats_rebuild(&app);
+    stats_settle();
+    CHECK_EQ(app.stats.last_feed_ts, first + 3 * FEED_GAP + 12 * 3600);
+    CHECK_EQ(log_stats_typical(&app.stats.feed), 2 * 3600);
+
+    LogStats shown = app.stats;
+    app_restart();
+    CHECK(same_stats(&shown, &app.stats));
+}
+
+int main(void) {
+    scratch_init();
+    test_save_point();
+    test_delete_undo();
+    test_past_event();
+    test_import();
+    return test_done("stats");
+}
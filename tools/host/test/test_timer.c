@@ -0,0 +1,234 @@
+// The feed/sleep keys (timer_step) against a model, on the simulated clock:
+// millions of random days of key presses never leave feeding and sleeping
+// both running, and every press logs what the model expects. A shorter run
+// through the store, the way the main screen does it, checks the session
+// index holds the same feeds and sleeps without overlaps, and the running
+// timer survives power loss (recovered from the log) and a clean exit.
+#include "test.h"
+#include "timer.h"
+#include "clock.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_tables.h"
+#include "scratch.h"
+#include <string.h>
+
+#define DAYS 2000000
+#define ERA_DAYS 20000 // Back to ERA_START before 32-bit seconds run out
+#define ERA_START 1577836800 // 2020-01-01
+#define STORE_DAYS 200
+#define SESSIONS_MAX (STORE_DAYS * 12)
+
+static AppData app;
+
+typedef enum {
+    PhaseAwake,
+    PhaseFeeding,
+    PhaseSleeping,
+} Phase;
+
+typedef struct {
+    Phase phase;
+    uint32_t start_ts;
+} Model;
+
+typedef struct {
+    uint32_t start_ts;
+    uint32_t end_ts; // 0 while running
+} Interval;
+
+// Feeds and sleeps the model started, in order
+static Interval g_sessions[SessionKindCount][SESSIONS_MAX];
+static uint32_t g_session_count[SessionKindCount];
+
+static void model_session(SessionKind kind, uint32_t start_ts, uint32_t end_ts) {
+    if(end_ts) {
+        g_sessions[kind][g_session_count[kind] - 1].end_ts = end_ts;
+    } else if(g_session_count[kind] < SESSIONS_MAX) {
+        g_sessions[kind][g_session_count[kind]++] = (Interval){start_ts, 0};
+    }
+}
+
+// What a key should do: stop whatever runs, then start the other timer
+// unless it was the one running
+static TimerStep model_step(Model* model, TimerKey key, uint32_t now) {
+    TimerStep step = {0};
+    Phase target = (key == TimerKeyFeed) ? PhaseFeeding : PhaseSleeping;
+    if(model->phase != PhaseAwake) {
+        bool feeding = model->phase == PhaseFeeding;
+        step.events[step.count].type = feeding ? LogEventFeedingStop : LogEventSleepStop;
+        step.events[step.count].duration = (now > model->start_ts) ? now - model->start_ts : 0;
+        step.count++;
+        model_session(feeding ? SessionFeeding : SessionSleep, 0, now);
+    }
+    if(model->phase == target) {
+        model->phase = PhaseAwake;
+        return step;
+    }
+    bool feeding = target == PhaseFeeding;
+    step.events[step.count].type = feeding ? LogEventFeedingStart : LogEventSleepStart;
+    step.events[step.count].duration = 0;
+    step.count++;
+    model_session(feeding ? SessionFeeding : SessionSleep, now, 0);
+    model->phase = target;
+    model->start_ts = now;
+    return step;
+}
+
+static bool state_is(const AppState* state, const Model* model) {
+    if(state->feeding_active != (model->phase == PhaseFeeding)) return false;
+    if(state->sleep_active != (model->phase == PhaseSleeping)) return false;
+    if(model->phase == PhaseFeeding) return state->feeding_start_ts == model->start_ts;
+    if(model->phase == PhaseSleeping) return state->sleep_start_ts == model->start_ts;
+    return true;
+}
+
+static bool same_step(const TimerStep* a, const TimerStep* b) {
+    if(a->count != b->count) return false;
+    for(uint8_t i = 0; i < a->count; i++) {
+        if(a->events[i].type != b->events[i].type || a->events[i].duration != b->events[i].duration) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One day of presses at random times, mostly forwards; with setback the
+// clock is now and then set back an hour or less
+typedef void (*PressFn)(TimerKey key);
+
+static void run_day(PressFn press, bool setback) {
+    uint32_t count = test_rand(12);
+    uint32_t spent = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        uint32_t gap = 1 + test_rand(86400 / (count + 1));
+        clock_advance(gap);
+        spent += gap;
+        if(setback && test_rand(5000) == 0) clock_simulate(clock_now() - test_rand(3600));
+        press(test_rand(2) ? TimerKeyFeed : TimerKeySleep);
+    }
+    clock_advance(86400 - spent);
+}
+
+// ==== PURE ====
+
+static AppState g_state;
+static Model g_model;
+static uint32_t g_wrong, g_both;
+
+static void press_pure(TimerKey key) {
+    uint32_t now = clock_now();
+    TimerStep got = timer_step(&g_state, key, now);
+    TimerStep want = model_step(&g_model, key, now);
+    if(g_state.feeding_active && g_state.sleep_active) g_both++;
+    if(!same_step(&got, &want) || !state_is(&g_state, &g_model)) g_wrong++;
+}
+
+static void test_days(void) {
+    for(uint32_t day = 0; day < DAYS; day++) {
+        if(day % ERA_DAYS == 0) {
+            clock_simulate(ERA_START);
+            memset(&g_state, 0, sizeof(g_state));
+            memset(&g_model, 0, sizeof(g_model));
+            memset(g_session_count, 0, sizeof(g_session_count)); // Only the store run reads them
+        }
+        run_day(press_pure, true);
+    }
+    CHECK_EQ(g_both, 0);
+    CHECK_EQ(g_wrong, 0);
+}
+
+// ==== THROUGH THE STORE ====
+
+// Power loss unless log_tables_close() ran first
+static void app_start(void) {
+    log_append_flush();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app)) {
+    }
+}
+
+// As the main screen's Up and Down keys
+static void press_app(TimerKey key) {
+    TimerStep step = timer_step(&app.state, key, clock_now());
+    model_step(&g_model, key, clock_now());
+    for(uint8_t i = 0; i < step.count; i++) {
+        log_add_event(&app, step.events[i].type, step.events[i].duration);
+    }
+    save_state_deferred(&app);
+    if(app.state.feeding_active && app.state.sleep_active) g_both++;
+}
+
+static uint32_t read_sessions(SessionKind kind, SessionRecord* out) {
+    uint32_t count = log_sessions_count(kind);
+    CHECK_EQ(count, g_session_count[kind]);
+    if(count > SESSIONS_MAX) count = SESSIONS_MAX;
+    return log_sessions_read(kind, 0, out, count);
+}
+
+static void test_store(void) {
+    clock_simulate(ERA_START);
+    test_sd_fresh();
+    app_start();
+    memset(&g_model, 0, sizeof(g_model));
+    memset(g_session_count, 0, sizeof(g_session_count));
+    g_both = 0;
+
+    for(uint32_t day = 0; day < STORE_DAYS; day++) run_day(press_app, false);
+    CHECK_EQ(g_both, 0);
+    CHECK(state_is(&app.state, &g_model));
+
+    // The index has the model's sessions, as logged
+    static SessionRecord feeds[SESSIONS_MAX], sleeps[SESSIONS_MAX];
+    log_append_flush();
+    uint32_t feed_count = read_sessions(SessionFeeding, feeds);
+    uint32_t sleep_count = read_sessions(SessionSleep, sleeps);
+    int wrong = 0;
+    for(uint32_t i = 0; i < feed_count; i++) {
+        const Interval* want = &g_sessions[SessionFeeding][i];
+        if(feeds[i].start_ts != want->start_ts || feeds[i].end_ts != want->end_ts) wrong++;
+    }
+    for(uint32_t i = 0; i < sleep_count; i++) {
+        const Interval* want = &g_sessions[SessionSleep][i];
+        if(sleeps[i].start_ts != want->start_ts || sleeps[i].end_ts != want->end_ts) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+
+    // No feed overlaps a sleep; one may end the second the other starts
+    int overlaps = 0;
+    uint32_t f = 0, s = 0;
+    while(f < feed_count && s < sleep_count) {
+        uint32_t feed_end = feeds[f].end_ts ? feeds[f].end_ts : UINT32_MAX;
+        uint32_t sleep_end = sleeps[s].end_ts ? sleeps[s].end_ts : UINT32_MAX;
+        if(feeds[f].start_ts < sleep_end && sleeps[s].start_ts < feed_end) overlaps++;
+        if(feed_end <= sleep_end) {
+            f++;
+        } else {
+            s++;
+        }
+    }
+    CHECK_EQ(overlaps, 0);
+
+    // The running timer comes back after a restart
+    AppState before = app.state;
+    for(int clean = 0; clean < 2; clean++) {
+        if(clean) log_tables_close();
+        app_start();
+        CHECK_EQ(app.state.feeding_active, before.feeding_active);
+        CHECK_EQ(app.state.sleep_active, before.sleep_active);
+        if(before.feeding_active) CHECK_EQ(app.state.feeding_start_ts, before.feeding_start_ts);
+        if(before.sleep_active) CHECK_EQ(app.state.sleep_start_ts, before.sleep_start_ts);
+    }
+}
+
+int main(void) {
+    scratch_init();
+    test_seed(50);
+    test_days();
+    test_store();
+    clock_use_rtc();
+    return test_done("timer");
+}
@@ -0,0 +1,173 @@
+// Deletes beyond the 128-entry tombstone set: rotation folds them out of
+// log.jsonl and compacts them, and when that can't make room the delete is
+// refused. Either way a deleted event never comes back - after a restart,
+// in an export, or from the other device's copy on import.
+#include "test.h"
+#include "log_store.h"
+#include "log_archive.h"
+#include "log_export.h"
+#include "log_import.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_codec.h"
+#include "scratch.h"
+#include <string.h>
+
+#define EVENTS 400
+#define DELETES 200
+#define EVENT_GAP 600
+
+static AppData app;
+static uint32_t g_first_ts;
+static bool g_deleted[EVENTS];
+
+static void app_start(void) {
+    log_append_flush();
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app)) {
+    }
+}
+
+static int event_index(uint32_t ts) {
+    if(ts < g_first_ts || (ts - g_first_ts) % EVENT_GAP) return -1;
+    uint32_t index = (ts - g_first_ts) / EVENT_GAP;
+    return (index < EVENTS) ? (int)index : -1;
+}
+
+// Every live event exactly once, no deleted one - archive segments included
+static void check_history(const char* when) {
+    int seen[EVENTS] = {0};
+    LogHistory history;
+    log_history_open(&history);
+    const LogRecord* rec;
+    while((rec = log_history_next(&history)) != NULL) {
+        if(log_is_deleted(rec->id)) continue;
+        int index = event_index(rec->ts);
+        CHECK(index >= 0);
+        if(index >= 0) seen[index]++;
+    }
+    log_history_close(&history);
+
+    int wrong = 0;
+    for(int i = 0; i < EVENTS; i++) {
+        if(seen[i] != (g_deleted[i] ? 0 : 1)) wrong++;
+    }
+    if(wrong) fprintf(stderr, "%s: %d events wrong\n", when, wrong);
+    CHECK_EQ(wrong, 0);
+}
+
+// The other device's log still has every event; IDs follow from the times
+static void write_import_log(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(storage, EXT_PATH("apps/baby_log/import"));
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, IMPORT_LOG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(int i = 0; i < EVENTS; i++) {
+        LogRecord rec = {.ts = g_first_ts + i * EVENT_GAP, .type = LogEventDiaper, .duration = 0};
+        log_format_id(rec.ts, rec.id);
+        char line[LOG_LINE_MAX];
+        int len = log_format_record(&rec, line, sizeof(line));
+        CHECK(len > 0 && storage_file_write(file, line, len) == (size_t)len);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void test_compaction(void) {
+    test_sd_fresh();
+    memset(g_deleted, 0, sizeof(g_deleted));
+    g_first_ts = sdk_rtc_now;
+    app_start();
+
+    // Every other event is a mistake, deleted right away
+    int refused = 0;
+    for(int i = 0; i < EVENTS; i++) {
+        sdk_rtc_now = g_first_ts + i * EVENT_GAP;
+        log_add_event(&app, LogEventDiaper, 0);
+        if(i % 2 == 0) continue;
+        CHECK_EQ(event_index(log_recent_get(&app, app.log_count - 1)->timestamp), i);
+        if(log_delete_last(&app)) {
+            g_deleted[i] = true;
+        } else {
+            refused++;
+        }
+        CHECK(log_tombstone_count() <= LOG_TOMBSTONE_MAX);
+    }
+    CHECK_EQ(refused, 0); // Every delete was in log.jsonl, so rotation made room
+    CHECK(log_tombstone_count() < DELETES);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    CHECK(storage_common_exists(storage, TOMBSTONES_PATH));
+    furi_record_close(RECORD_STORAGE);
+    check_history("after deletes");
+
+    app_start();
+    check_history("after restart");
+
+    app.export_status = JobIdle;
+    CHECK(log_export_start(&app, ExportFormatCsv, 0));
+    while(log_export_step(&app)) {
+    }
+    CHECK_EQ(app.export_status, JobDone);
+    CHECK_EQ(app.export_rows, EVENTS - DELETES);
+
+    write_import_log();
+    CHECK(log_import_start(&app));
+    while(log_import_step(&app)) {
+    }
+    CHECK_EQ(app.import_status, JobDone);
+    CHECK_EQ(app.import_added, 0);
+    app_start();
+    check_history("after import");
+}
+
+// Journal lines for events that are not in this log (they were archived, or
+// the delete came from the other device): rotation can't fold them
+static void write_foreign_deletes(int count) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    CHECK(storage_file_open(file, DELETED_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(int i = 0; i < count; i++) {
+        LogRecord rec = {.ts = 1000000 + i, .type = LogEventDiaper, .duration = 0};
+        log_format_id(rec.ts, rec.id);
+        char line[LOG_LINE_MAX + 16];
+        int len = log_format_journal(JournalOpDelete, &rec, line, sizeof(line));
+        CHECK(len > 0 && storage_file_write(file, line, len) == (size_t)len);
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void test_refused(void) {
+    test_sd_fresh();
+    app_start();
+    for(int i = 0; i < 5; i++) {
+        sdk_rtc_now += EVENT_GAP;
+        log_add_event(&app, LogEventDiaper, 0);
+    }
+    write_foreign_deletes(LOG_TOMBSTONE_MAX);
+    app_start();
+    CHECK_EQ(log_tombstone_count(), LOG_TOMBSTONE_MAX);
+    CHECK_EQ(app.log_count, 5);
+
+    CHECK(!log_delete_last(&app));
+    CHECK(app.delete_refused);
+    CHECK_EQ(app.log_count, 5);
+    app_start();
+    CHECK_EQ(app.log_count, 5); // Nothing half-written
+
+    // More deletes on the card than fit: import refuses rather than revive
+    write_foreign_deletes(LOG_TOMBSTONE_MAX + 2);
+    app_start();
+    CHECK(log_tombstones_full());
+    CHECK(!log_import_start(&app));
+    CHECK(app.import_deletes_full);
+}
+
+int main(void) {
+    scratch_init();
+    test_compaction();
+    test_refused();
+    return test_done("tombstones");
+}
@@ -0,0 +1,180 @@
+// Card writes per logged event over the whole write path - log.jsonl,
+// debug.log, session index, last.bin, stats.bin, state.json and tables.ok -
+// as the main loop drives it: the event, its timer state, then the append
+// hold expiring. Three ways of using the app: left open for two weeks with
+// events hours apart or in bursts, and opened for each key press and closed
+// again. Each is held to a budget and to what the same run cost before
+// the append buffer and the derived tables: every log.jsonl and debug.log
+// line its own open, write and close, and state.json rewritten on every
+// press. Prints sectors per event by file.
+#include "test.h"
+#include "log_store.h"
+#include "log_append.h"
+#include "log_sessions.h"
+#include "log_stats.h"
+#include "log_tables.h"
+#include "scratch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+#define DAYS 14
+// Budgets, in sectors per event, all files counted, for a release build
+// (debug builds write each debug.log line at once). Before, the runs cost
+// 7.5 (spread out or in bursts) and 18.3 (one session per press).
+#define WRITES_SPREAD_MAX 2.5
+#define WRITES_BURST_MAX 1.5
+#define WRITES_SESSION_MAX 10.0
+
+typedef enum {
+    UseSpread, // Left open, events minutes apart each get their own flush
+    UseBurst, // Left open, events seconds apart share a flush
+    UseSession, // Opened and closed for every press
+} Use;
+
+static AppData app;
+static uint32_t g_presses, g_events;
+
+static void app_open(void) {
+    memset(&app, 0, sizeof(app));
+    load_config(&app);
+    child_init(&app);
+    while(log_sessions_step(&app) || log_stats_step(&app)) {
+    }
+}
+
+static void pass_time(uint32_t seconds) {
+    sdk_rtc_now += seconds;
+    sdk_tick_ms += seconds * 1000;
+    log_append_poll(sdk_tick_ms);
+}
+
+// As the main screen buttons do: a start stops the other timer first
+static void press(Use use, LogEventType type) {
+    if(use == UseSession) app_open();
+    g_presses++;
+    uint32_t generation = app.log_generation; // One per event added
+    uint32_t now = sdk_rtc_now;
+    if(type == LogEventFeedingStart && app.state.sleep_active) {
+        log_add_event(&app, LogEventSleepStop, now - app.state.sleep_start_ts);
+        app.state.sleep_active = false;
+    }
+    if(type == LogEventSleepStart && app.state.feeding_active) {
+        log_add_event(&app, LogEventFeedingStop, now - app.state.feeding_start_ts);
+        app.state.feeding_active = false;
+    }
+    log_add_event(&app, type, 0);
+    if(type == LogEventFeedingStart) {
+        app.state.feeding_active = true;
+        app.state.feeding_start_ts = now;
+    } else if(type == LogEventSleepStart) {
+        app.state.sleep_active = true;
+        app.state.sleep_start_ts = now;
+    }
+    save_state_deferred(&app);
+    g_events += app.log_generation - generation;
+    if(use == UseSession) log_tables_close();
+}
+
+// Two weeks of feeds every 3 h, each followed by a diaper and a sleep
+static void run_days(Use use) {
+    bool burst = use == UseBurst;
+    for(int day = 0; day < DAYS; day++) {
+        for(int feed = 0; feed < 8; feed++) {
+            press(use, LogEventFeedingStart); // Also stops the sleep
+            pass_time(burst ? 30 : 20 * 60);
+            press(use, LogEventDiaper);
+            pass_time(burst ? 30 : 5 * 60);
+            press(use, LogEventSleepStart); // Also stops the feed
+            pass_time(3 * 3600 - (burst ? 60 : 25 * 60));
+        }
+    }
+}
+
+static uint32_t file_size(const char* path) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FileInfo info;
+    uint32_t size = (storage_common_stat(storage, path, &info) == FSE_OK) ? (uint32_t)info.size : 0;
+    furi_record_close(RECORD_STORAGE);
+    return size;
+}
+
+// Sectors the lines from offset on took when each was its own write
+static uint32_t line_writes(const char* path, uint32_t offset) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint32_t sectors = 0;
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) && storage_file_seek(file, offset, true)) {
+        uint8_t buffer[LOG_SECTOR_SIZE];
+        uint32_t start = offset;
+        size_t n;
+        while((n = storage_file_read(file, buffer, sizeof(buffer))) > 0) {
+            for(size_t i = 0; i < n; i++, offset++) {
+                if(buffer[i] != '\n') continue;
+                sectors += start / LOG_SECTOR_SIZE == offset / LOG_SECTOR_SIZE ? 1 : 2;
+                sectors++; // Directory entry
+                start = offset + 1;
+            }
+        }
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return sectors;
+}
+
+// The app's files, debug.log included
+static const char* const g_files[] = {
+    "log.jsonl",
+    "debug.log",
+    "sessions_feed.bin",
+    "sessions_sleep.bin",
+    "last.bin",
+    "stats.bin",
+    "state.json",
+    "tables.ok",
+};
+
+// Sectors per event written to the app's files; *before is what the same
+// run cost per event before
+static double sectors_per_event(Use use, double* before) {
+    static const char* const names[] = {"events spread out", "events in bursts", "one session per press"};
+    test_sd_fresh();
+    app_open();
+    log_tables_close();
+    if(use != UseSession) app_open();
+
+    uint32_t log_from = file_size(LOG_PATH);
+    uint32_t debug_from = file_size(DEBUG_PATH);
+    sdk_io_reset();
+    g_presses = 0;
+    g_events = 0;
+    run_days(use);
+    uint32_t events = g_events;
+    if(use != UseSession) log_tables_close();
+
+    double total = 0;
+    printf("writes: %s, sectors per event:\n", names[use]);
+    for(size_t i = 0; i < COUNT_OF(g_files); i++) {
+        double sectors = (double)sdk_io_file(g_files[i]).sectors / events;
+        printf("  %-20s %5.2f\n", g_files[i], sectors);
+        total += sectors;
+    }
+    uint32_t state_sectors = (file_size(child_paths()->state) + LOG_SECTOR_SIZE - 1) / LOG_SECTOR_SIZE + 1;
+    *before = (double)(line_writes(LOG_PATH, log_from) + line_writes(DEBUG_PATH, debug_from) +
+                       g_presses * state_sectors) /
+              events;
+    printf("  %-20s %5.2f\n", "total", total);
+    printf("  %-20s %5.2f\n", "before", *before);
+    return total;
+}
+
+int main(void) {
+    scratch_init();
+    double before;
+    double spread = sectors_per_event(UseSpread, &before);
+    CHECK(spread < WRITES_SPREAD_MAX && spread < before);
+    double burst = sectors_per_event(UseBurst, &before);
+    CHECK(burst < WRITES_BURST_MAX && burst < before);
+    double session = sectors_per_event(UseSession, &before);
+    CHECK(session < WRITES_SESSION_MAX && session < before);
+    return test_done("writes");
+}
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Build SD language packs from tools/lang/*.txt.
+
+Each source file has an `@index=N` and `@name=...` header followed by
+`KEY=text` lines, where KEY is a TranslationKey from the TR_KEYS list in
+translations.h without the TR_ prefix. Keys that are left out, or whose text
+is the same as the English, fall back to English at runtime. Identical
+strings are stored once in the blob and share an offset.
+
+Pack layout (little endian), written to assets/lang/<index>.lang:
+    0   "BLT1"
+    4   u16 key_count   (must match TR_COUNT)
+    6   u16 blob_size
+    8   char name[24]   (NUL padded, shown on the Language screen)
+    32  u16 offsets[key_count]  (0xFFFF = not translated)
+    ..  blob of NUL-terminated strings
+
+Run from the repo root after changing translations.h or a .txt file:
+    python3 tools/make_lang.py
+"""
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+MAGIC = b"BLT1"
+NAME_LEN = 24
+MISSING = 0xFFFF
+PACK_MAX = 2048  # LANG_PACK_MAX in translations.c
+
+
+def read_keys():
+    """Key names (without TR_) in enum order, mapped to their English text."""
+    with open(os.path.join(ROOT, "translations.h"), encoding="utf-8") as f:
+        src = f.read()
+    found = re.findall(r'^\s*X\(TR_(\w+), "((?:[^"\\]|\\.)*)"\)', src, re.M)
+    return {key: text.encode("utf-8").decode("unicode_escape") for key, text in found}
+
+
+def build(path, keys):
+    index, name, strings = None, None, {}
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line or line.startswith("#"):
+                continue
+            key, sep, text = line.partition("=")
+            if not sep:
+                sys.exit(f"{path}:{lineno}: expected KEY=text")
+            if key == "@index":
+                index = int(text)
+            elif key == "@name":
+                name = text
+            elif key in keys:
+                strings[key] = text
+            else:
+                sys.exit(f"{path}:{lineno}: unknown key {key}")
+    if not index or not name:
+        sys.exit(f"{path}: missing @index or @name")
+
+    blob = bytearray()
+    offsets = []
+    pooled = {}
+    for key, english in keys.items():
+        text = strings.get(key)
+        if text is None or text == english:
+            offsets.append(MISSING)
+            continue
+        if text not in pooled:
+            pooled[text] = len(blob)
+            blob += text.encode("utf-8") + b"\0"
+        offsets.append(pooled[text])
+
+    pack = MAGIC + struct.pack("<HH", len(keys), len(blob))
+    pack += name.encode("utf-8")[: NAME_LEN - 1].ljust(NAME_LEN, b"\0")
+    pack += struct.pack(f"<{len(offsets)}H", *offsets) + blob
+    if len(pack) > PACK_MAX:
+        sys.exit(f"{path}: pack is {len(pack)} bytes, limit {PACK_MAX}")
+
+    out = os.path.join(ROOT, "assets", "lang", f"{index}.lang")
+    with open(out, "wb") as f:
+        f.write(pack)
+    print(f"{os.path.basename(path)} -> assets/lang/{index}.lang ({len(pack)} bytes)")
+
+
+def main():
+    keys = read_keys()
+    os.makedirs(os.path.join(ROOT, "assets", "lang"), exist_ok=True)
+    src_dir = os.path.join(ROOT, "tools", "lang")
+    for name in sorted(os.listdir(src_dir)):
+        if name.endswith(".txt"):
+            build(os.path.join(src_dir, name), keys)
+
+
+if __name__ == "__main__":
+    main()
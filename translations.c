@@ -1,207 +1,172 @@
 #include "translations.h"
+#include "log_store.h"
+#include "log_codec.h"
+#include <storage/storage.h>
+#include <stddef.h>
 #include <string.h>
 
-// English translations
-static const char* tr_en[TR_COUNT] = {
-    [TR_MAIN_AWAKE] = "Awake",
-    [TR_MAIN_FEEDING] = "Feeding",
-    [TR_MAIN_SLEEPING] = "Sleeping",
-    [TR_MAIN_DIAPER_LOGGED] = "Diaper logged!",
-    [TR_MAIN_UP_FEED] = "^ Feed",
-    [TR_MAIN_DOWN_SLEEP] = "v Sleep",
-    [TR_MAIN_LEFT_DIAPER] = "< Diaper",
-    [TR_MAIN_BACK_MENU] = "B Menu",
-    [TR_MAIN_FEED_LABEL] = "Feed",
-    [TR_MAIN_SLEEP_LABEL] = "Sleep",
-    [TR_MAIN_DIAPER_LABEL] = "Diaper",
-    [TR_MAIN_MENU_LABEL] = "Menu",
-    
-    [TR_MENU_PROFILE] = "Child profile",
-    [TR_MENU_RECENT_LOG] = "Recent log",
-    [TR_MENU_DELETE_LAST] = "Delete last",
-    [TR_MENU_CLEAR_ALL] = "Clear all logs",
-    [TR_MENU_LANGUAGE] = "Language",
-    [TR_MENU_EXIT] = "Exit",
-    
-    [TR_PROFILE_TITLE] = "Profile",
-    [TR_PROFILE_NAME] = "Name:",
-    [TR_PROFILE_BIRTH] = "Birth:",
-    [TR_PROFILE_AGE] = "Age:",
-    [TR_PROFILE_EDIT_NAME] = "Edit name",
-    [TR_PROFILE_EDIT_DATE] = "Edit birth date",
-    [TR_PROFILE_LANGUAGE] = "Language",
-    
-    [TR_EDIT_NAME_TITLE] = "Edit Name",
-    [TR_EDIT_NAME_NAME] = "Name:",
-    [TR_EDIT_NAME_CHAR] = "Char:",
-    [TR_EDIT_NAME_UP_DOWN] = "^/v:Char",
-    [TR_EDIT_NAME_L_R] = "</>:Move",
-    
-    [TR_EDIT_DATE_TITLE] = "Edit Birth Date",
-    [TR_EDIT_DATE_YEAR] = "Year:",
-    [TR_EDIT_DATE_MONTH] = "Month:",
-    [TR_EDIT_DATE_DAY] = "Day:",
-    [TR_EDIT_DATE_INVALID] = "Invalid!",
-    
-    [TR_LOG_TITLE] = "Recent Log",
-    [TR_LOG_NO_EVENTS] = "No events yet",
-    [TR_LOG_DIAPER] = "Diaper",
-    [TR_LOG_FEED_START] = "Feed start",
-    [TR_LOG_FEED_STOP] = "Feed stop",
-    [TR_LOG_SLEEP_START] = "Sleep start",
-    [TR_LOG_SLEEP_STOP] = "Sleep stop",
-    
-    [TR_LANG_TITLE] = "Language",
-    [TR_LANG_ENGLISH] = "English",
-    [TR_LANG_RUSSIAN] = "Russian",
-    [TR_LANG_SPANISH] = "Spanish",
-    
-    [TR_AGE_DAYS] = "days",
-    [TR_AGE_WEEKS] = "weeks",
-    [TR_AGE_MONTHS] = "months",
+// English, built in - fallback for missing packs and keys. The strings sit
+// back to back in one pool (a struct of char arrays has no padding) and
+// each key is a 16-bit offset into it, half the size of a pointer table.
+typedef struct {
+#define TR_EN_FIELD(key, en) char key[sizeof(en)];
+    TR_KEYS(TR_EN_FIELD)
+#undef TR_EN_FIELD
+} TrEnPool;
+
+static const TrEnPool tr_en_pool = {
+#define TR_EN_TEXT(key, en) en,
+    TR_KEYS(TR_EN_TEXT)
+#undef TR_EN_TEXT
 };
 
-// Russian translations (using Latin transliteration - Flipper Zero fonts don't support Cyrillic)
-static const char* tr_ru[TR_COUNT] = {
-    [TR_MAIN_AWAKE] = "Bodrstvuet",
-    [TR_MAIN_FEEDING] = "Kormlenie",
-    [TR_MAIN_SLEEPING] = "Spit",
-    [TR_MAIN_DIAPER_LOGGED] = "Podguznik!",
-    [TR_MAIN_UP_FEED] = "^ Korm",
-    [TR_MAIN_DOWN_SLEEP] = "v Son",
-    [TR_MAIN_LEFT_DIAPER] = "< Podg",
-    [TR_MAIN_BACK_MENU] = "B Menu",
-    [TR_MAIN_FEED_LABEL] = "Korm",
-    [TR_MAIN_SLEEP_LABEL] = "Son",
-    [TR_MAIN_DIAPER_LABEL] = "Podg",
-    [TR_MAIN_MENU_LABEL] = "Menu",
-    
-    [TR_MENU_PROFILE] = "Profil",
-    [TR_MENU_RECENT_LOG] = "Zhurnal",
-    [TR_MENU_DELETE_LAST] = "Udalit",
-    [TR_MENU_CLEAR_ALL] = "Ochistit vse",
-    [TR_MENU_LANGUAGE] = "Yazyk",
-    [TR_MENU_EXIT] = "Vyhod",
-    
-    [TR_PROFILE_TITLE] = "Profil",
-    [TR_PROFILE_NAME] = "Imya:",
-    [TR_PROFILE_BIRTH] = "Rozhdenie:",
-    [TR_PROFILE_AGE] = "Vozrast:",
-    [TR_PROFILE_EDIT_NAME] = "Izmenit imya",
-    [TR_PROFILE_EDIT_DATE] = "Data rozhdeniya",
-    [TR_PROFILE_LANGUAGE] = "Yazyk",
-    
-    [TR_EDIT_NAME_TITLE] = "Izmenit imya",
-    [TR_EDIT_NAME_NAME] = "Imya:",
-    [TR_EDIT_NAME_CHAR] = "Bukva:",
-    [TR_EDIT_NAME_UP_DOWN] = "^/v",
-    [TR_EDIT_NAME_L_R] = "</>",
-    
-    [TR_EDIT_DATE_TITLE] = "Data rozhdeniya",
-    [TR_EDIT_DATE_YEAR] = "God:",
-    [TR_EDIT_DATE_MONTH] = "Mesyats:",
-    [TR_EDIT_DATE_DAY] = "Den:",
-    [TR_EDIT_DATE_INVALID] = "Neverno!",
-    
-    [TR_LOG_TITLE] = "Zhurnal",
-    [TR_LOG_NO_EVENTS] = "Net sobytiy",
-    [TR_LOG_DIAPER] = "Podguznik",
-    [TR_LOG_FEED_START] = "Korm nach",
-    [TR_LOG_FEED_STOP] = "Korm kon",
-    [TR_LOG_SLEEP_START] = "Son nach",
-    [TR_LOG_SLEEP_STOP] = "Son kon",
-    
-    [TR_LANG_TITLE] = "Yazyk",
-    [TR_LANG_ENGLISH] = "Angliyskiy",
-    [TR_LANG_RUSSIAN] = "Russkiy",
-    [TR_LANG_SPANISH] = "Ispanskiy",
-    
-    [TR_AGE_DAYS] = "dney",
-    [TR_AGE_WEEKS] = "nedel",
-    [TR_AGE_MONTHS] = "mesyatsev",
+static const uint16_t tr_en_offsets[TR_COUNT] = {
+#define TR_EN_OFFSET(key, en) [key] = offsetof(TrEnPool, key),
+    TR_KEYS(TR_EN_OFFSET)
+#undef TR_EN_OFFSET
 };
 
-// Spanish translations
-static const char* tr_es[TR_COUNT] = {
-    [TR_MAIN_AWAKE] = "Despierto",
-    [TR_MAIN_FEEDING] = "Alimentando",
-    [TR_MAIN_SLEEPING] = "Durmiendo",
-    [TR_MAIN_DIAPER_LOGGED] = "Pañal!",
-    [TR_MAIN_UP_FEED] = "^ Comer",
-    [TR_MAIN_DOWN_SLEEP] = "v Dormir",
-    [TR_MAIN_LEFT_DIAPER] = "< Panal",
-    [TR_MAIN_BACK_MENU] = "B Menu",
-    [TR_MAIN_FEED_LABEL] = "Comer",
-    [TR_MAIN_SLEEP_LABEL] = "Dormir",
-    [TR_MAIN_DIAPER_LABEL] = "Panal",
-    [TR_MAIN_MENU_LABEL] = "Menu",
-    
-    [TR_MENU_PROFILE] = "Perfil",
-    [TR_MENU_RECENT_LOG] = "Registro",
-    [TR_MENU_DELETE_LAST] = "Borrar ultimo",
-    [TR_MENU_CLEAR_ALL] = "Borrar todo",
-    [TR_MENU_LANGUAGE] = "Idioma",
-    [TR_MENU_EXIT] = "Salir",
-    
-    [TR_PROFILE_TITLE] = "Perfil",
-    [TR_PROFILE_NAME] = "Nombre:",
-    [TR_PROFILE_BIRTH] = "Nacimiento:",
-    [TR_PROFILE_AGE] = "Edad:",
-    [TR_PROFILE_EDIT_NAME] = "Editar nombre",
-    [TR_PROFILE_EDIT_DATE] = "Fecha nacimiento",
-    [TR_PROFILE_LANGUAGE] = "Idioma",
-    
-    [TR_EDIT_NAME_TITLE] = "Editar Nombre",
-    [TR_EDIT_NAME_NAME] = "Nombre:",
-    [TR_EDIT_NAME_CHAR] = "Letra:",
-    [TR_EDIT_NAME_UP_DOWN] = "^/v",
-    [TR_EDIT_NAME_L_R] = "</>",
-    
-    [TR_EDIT_DATE_TITLE] = "Fecha Nacimiento",
-    [TR_EDIT_DATE_YEAR] = "Año:",
-    [TR_EDIT_DATE_MONTH] = "Mes:",
-    [TR_EDIT_DATE_DAY] = "Día:",
-    [TR_EDIT_DATE_INVALID] = "Inválido!",
-    
-    [TR_LOG_TITLE] = "Registro",
-    [TR_LOG_NO_EVENTS] = "Sin eventos",
-    [TR_LOG_DIAPER] = "Pañal",
-    [TR_LOG_FEED_START] = "Comer inicio",
-    [TR_LOG_FEED_STOP] = "Comer fin",
-    [TR_LOG_SLEEP_START] = "Dormir inicio",
-    [TR_LOG_SLEEP_STOP] = "Dormir fin",
-    
-    [TR_LANG_TITLE] = "Idioma",
-    [TR_LANG_ENGLISH] = "Inglés",
-    [TR_LANG_RUSSIAN] = "Ruso",
-    [TR_LANG_SPANISH] = "Español",
-    
-    [TR_AGE_DAYS] = "días",
-    [TR_AGE_WEEKS] = "semanas",
-    [TR_AGE_MONTHS] = "meses",
+_Static_assert(sizeof(TrEnPool) <= UINT16_MAX, "English pool outgrew 16-bit offsets");
+
+// ==== LANGUAGE PACKS ====
+// Only the active pack is held in RAM, in one static buffer. On load the
+// lookup table is filled with English and then overridden by every key the
+// pack translates, so tr_get() is a single bounds-checked index. The table
+// starts out as English, so lookups work before tr_init().
+
+#define LANG_PACK_MAGIC "BLT1"
+#define LANG_PACK_HEADER_SIZE (8 + LANG_NAME_LEN)
+#define LANG_PACK_MAX 2048
+#define LANG_KEY_MISSING 0xFFFF
+
+static uint8_t g_pack[LANG_PACK_MAX]; // Global buffer - not on stack!
+static const char* g_table[TR_COUNT] = {
+#define TR_EN_POINTER(key, en) [key] = tr_en_pool.key,
+    TR_KEYS(TR_EN_POINTER)
+#undef TR_EN_POINTER
 };
+static char g_names[LANG_MAX][LANG_NAME_LEN];
+static uint8_t g_language_count = 1;
 
-const char* tr_get(AppData* app, TranslationKey key) {
-    if(!app || key >= TR_COUNT) {
-        return "";
+static void pack_path(uint8_t language, char* out, size_t out_size) {
+    snprintf(out, out_size, APP_ASSETS_PATH("lang/%u.lang"), language);
+}
+
+static void table_reset(void) {
+    const char* pool = (const char*)&tr_en_pool;
+    for(int i = 0; i < TR_COUNT; i++) {
+        g_table[i] = pool + tr_en_offsets[i];
     }
-    
-    Language lang = (Language)app->cfg.language;
-    const char** table = tr_en; // Default to English
-    
-    switch(lang) {
-        case LangRussian:
-            table = tr_ru;
-            break;
-        case LangSpanish:
-            table = tr_es;
-            break;
-        case LangEnglish:
-        default:
-            table = tr_en;
-            break;
+}
+
+// Read a pack header; fills name (may be NULL)
+static bool pack_read_header(File* file, uint16_t* key_count, uint16_t* blob_size, char* name) {
+    uint8_t header[LANG_PACK_HEADER_SIZE];
+    if(storage_file_read(file, header, sizeof(header)) != sizeof(header)) return false;
+    if(memcmp(header, LANG_PACK_MAGIC, 4) != 0) return false;
+    *key_count = log_get_u16(header + 4);
+    *blob_size = log_get_u16(header + 6);
+    if(name) {
+        memcpy(name, header + 8, LANG_NAME_LEN);
+        name[LANG_NAME_LEN - 1] = '\0';
     }
-    
-    return table[key] ? table[key] : "";
+    return true;
 }
 
+// Every offset must start a string inside the blob, and the blob must end
+// in a NUL, so no lookup can read past the bytes actually loaded
+static bool pack_valid(uint16_t key_count, uint16_t blob_size) {
+    const uint8_t* blob = g_pack + key_count * 2;
+    if(blob[blob_size - 1] != '\0') return false;
+    for(uint16_t i = 0; i < key_count; i++) {
+        uint16_t offset = log_get_u16(g_pack + i * 2);
+        if(offset == LANG_KEY_MISSING) continue;
+        if(offset >= blob_size) return false;
+        if(offset > 0 && blob[offset - 1] != '\0') return false; // Mid-string
+    }
+    return true;
+}
+
+bool tr_load(uint8_t language) {
+    table_reset();
+    if(language == LangEnglish || language >= g_language_count) return language == LangEnglish;
+
+    char path[64];
+    pack_path(language, path, sizeof(path));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+
+    uint16_t key_count = 0;
+    uint16_t blob_size = 0;
+    if(ok) {
+        ok = pack_read_header(file, &key_count, &blob_size, NULL) &&
+             key_count == TR_COUNT && // Pack built for a different key set
+             blob_size > 0;
+    }
+    if(ok) {
+        // The file is exactly header + offsets + blob: truncated or padded
+        // packs are refused before anything is read into the buffer
+        size_t body = key_count * 2 + blob_size;
+        ok = body <= sizeof(g_pack) &&
+             storage_file_size(file) == LANG_PACK_HEADER_SIZE + body &&
+             storage_file_read(file, g_pack, body) == body &&
+             pack_valid(key_count, blob_size);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!ok) {
+        debug_log("tr_load: bad pack, using English");
+        return false;
+    }
+
+    const char* blob = (const char*)g_pack + key_count * 2;
+    for(uint16_t i = 0; i < key_count; i++) {
+        uint16_t offset = log_get_u16(g_pack + i * 2);
+        if(offset != LANG_KEY_MISSING) g_table[i] = blob + offset;
+    }
+    return true;
+}
+
+void tr_init(uint8_t language) {
+    // Packs are numbered from 1 with no gaps
+    strncpy(g_names[LangEnglish], "English", LANG_NAME_LEN);
+    g_language_count = 1;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    char path[64];
+    while(g_language_count < LANG_MAX) {
+        pack_path(g_language_count, path, sizeof(path));
+        uint16_t key_count;
+        uint16_t blob_size;
+        bool found = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                     pack_read_header(file, &key_count, &blob_size, g_names[g_language_count]);
+        storage_file_close(file);
+        if(!found) break;
+        g_language_count++;
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    tr_load(language);
+}
+
+uint8_t tr_language_count(void) {
+    return g_language_count;
+}
+
+const char* tr_language_name(uint8_t language) {
+    return (language < g_language_count) ? g_names[language] : "";
+}
+
+const char* tr_get(AppData* app, TranslationKey key) {
+    UNUSED(app);
+    if(key >= TR_COUNT) {
+        return "";
+    }
+    return g_table[key];
+}
@@ -1,81 +1,147 @@
 #pragma once
 #include "app_state.h"
 
+// English is compiled in; every other language is a pack on SD
+// (assets/lang/<index>.lang, built by tools/make_lang.py)
 typedef enum {
     LangEnglish = 0,
-    LangRussian,
-    LangSpanish,
+    LangRussian, // 1.lang
+    LangSpanish, // 2.lang
 } Language;
 
-// Translation keys
+#define LANG_MAX 8 // English + up to 7 packs
+#define LANG_NAME_LEN 24
+
+// Translation keys with their English text. This list is the only place
+// a key is defined: it expands into the enum below and the built-in English
+// pool in translations.c, and tools/make_lang.py reads it to build packs.
+#define TR_KEYS(X) \
+    /* Main screen */                                            \
+    X(TR_MAIN_AWAKE, "Awake")                                    \
+    X(TR_MAIN_FEEDING, "Feeding")                                \
+    X(TR_MAIN_SLEEPING, "Sleeping")                              \
+    X(TR_MAIN_DIAPER_LOGGED, "Diaper logged!")                   \
+    X(TR_MAIN_UP_FEED, "^ Feed")                                 \
+    X(TR_MAIN_DOWN_SLEEP, "v Sleep")                             \
+    X(TR_MAIN_LEFT_DIAPER, "< Diaper")                           \
+    X(TR_MAIN_BACK_MENU, "B Menu")                               \
+    X(TR_MAIN_FEED_LABEL, "Feed") /* Label without arrow */      \
+    X(TR_MAIN_SLEEP_LABEL, "Sleep") /* Label without arrow */    \
+    X(TR_MAIN_DIAPER_LABEL, "Diaper") /* Label without arrow */  \
+    X(TR_MAIN_MENU_LABEL, "Menu") /* Label without arrow */      \
+    X(TR_MAIN_NEXT_FEED, "Next feed") /* "Next feed ~14:20" */   \
+    X(TR_MAIN_WAKE_AT, "Wake") /* "Wake ~15:10" */               \
+    X(TR_MAIN_FED, "Fed") /* "Fed 45m ago" - last feed ended */  \
+    X(TR_MAIN_DIAPER_SINCE, "Diaper") /* "Diaper 2h10m ago" */   \
+    X(TR_MAIN_AGO, "ago") /* After the duration, may be empty */ \
+    /* Menu */                                                   \
+    X(TR_MENU_PROFILE, "Child profile")                          \
+    X(TR_MENU_ADD_CHILD, "Add child")                            \
+    X(TR_MENU_RECENT_LOG, "Recent log")                          \
+    X(TR_MENU_ADD_PAST, "Add past event")                        \
+    X(TR_MENU_EXPORT, "Export")                                  \
+    X(TR_MENU_IMPORT, "Import")                                  \
+    X(TR_MENU_DELETE_LAST, "Delete last")                        \
+    X(TR_MENU_UNDO, "Undo delete")                               \
+    X(TR_MENU_REDO, "Redo delete")                               \
+    X(TR_MENU_CLEAR_ALL, "Clear all logs")                       \
+    X(TR_MENU_CHECK, "Check log")                                \
+    X(TR_MENU_REMINDERS, "Reminders")                            \
+    X(TR_MENU_LANGUAGE, "Language")                              \
+    X(TR_MENU_EXIT, "Exit")                                      \
+    X(TR_MENU_DELETE_FULL, "Delete list full")                   \
+    /* Profile */                                                \
+    X(TR_PROFILE_TITLE, "Profile")                               \
+    X(TR_PROFILE_NAME, "Name:")                                  \
+    X(TR_PROFILE_BIRTH, "Birth:")                                \
+    X(TR_PROFILE_AGE, "Age:")                                    \
+    X(TR_PROFILE_EDIT_NAME, "Edit name")                         \
+    X(TR_PROFILE_EDIT_DATE, "Edit birth date")                   \
+    X(TR_PROFILE_LANGUAGE, "Language")                           \
+    /* Edit name */                                              \
+    X(TR_EDIT_NAME_TITLE, "Edit Name")                           \
+    X(TR_EDIT_NAME_NAME, "Name:")                                \
+    X(TR_EDIT_NAME_CHAR, "Char:")                                \
+    X(TR_EDIT_NAME_UP_DOWN, "^/v:Char")                          \
+    X(TR_EDIT_NAME_L_R, "</>:Move")                              \
+    /* Edit birth date */                                        \
+    X(TR_EDIT_DATE_TITLE, "Edit Birth Date")                     \
+    X(TR_EDIT_DATE_YEAR, "Year:")                                \
+    X(TR_EDIT_DATE_MONTH, "Month:")                              \
+    X(TR_EDIT_DATE_DAY, "Day:")                                  \
+    X(TR_EDIT_DATE_INVALID, "Invalid!")                          \
+    /* Recent log */                                             \
+    X(TR_LOG_TITLE, "Recent Log")                                \
+    X(TR_LOG_NO_EVENTS, "No events yet")                         \
+    X(TR_LOG_DIAPER, "Diaper")                                   \
+    X(TR_LOG_FEED_START, "Feed start")                           \
+    X(TR_LOG_FEED_STOP, "Feed stop")                             \
+    X(TR_LOG_SLEEP_START, "Sleep start")                         \
+    X(TR_LOG_SLEEP_STOP, "Sleep stop")                           \
+    /* Add/edit event */                                         \
+    X(TR_EVENT_ADD_TITLE, "Add Event")                           \
+    X(TR_EVENT_EDIT_TITLE, "Edit Event")                         \
+    X(TR_EVENT_TYPE, "Type:")                                    \
+    X(TR_EVENT_DUR, "Dur:")                                      \
+    X(TR_EVENT_HINT, "</>:Field ^/v:Set OK:Save")                \
+    X(TR_EVENT_FULL, "Too many edits!")                          \
+    /* Export */                                                 \
+    X(TR_EXPORT_TITLE, "Export")                                 \
+    X(TR_EXPORT_START, "OK: start")                              \
+    X(TR_EXPORT_RUNNING, "Exporting...")                         \
+    X(TR_EXPORT_CANCEL, "B: cancel")                             \
+    X(TR_EXPORT_DONE, "Saved")                                   \
+    X(TR_EXPORT_CANCELLED, "Cancelled")                          \
+    X(TR_EXPORT_FAILED, "Export failed")                         \
+    X(TR_EXPORT_ROWS, "rows")                                    \
+    X(TR_EXPORT_ALL, "All history")                              \
+    X(TR_EXPORT_LAST, "Last") /* "Last 30 days" */               \
+    X(TR_EXPORT_DAYS, "days")                                    \
+    /* Import */                                                 \
+    X(TR_IMPORT_TITLE, "Import")                                 \
+    X(TR_IMPORT_SOURCE, "Merge log from:")                       \
+    X(TR_IMPORT_START, "OK: merge")                              \
+    X(TR_IMPORT_RUNNING, "Merging...")                           \
+    X(TR_IMPORT_DONE, "Merged")                                  \
+    X(TR_IMPORT_ADDED, "new events")                             \
+    X(TR_IMPORT_DUPS, "duplicates")                              \
+    X(TR_IMPORT_FAILED, "No import file")                        \
+    X(TR_IMPORT_DELETES_FULL, "Too many deletes")                \
+    /* Check log */                                              \
+    X(TR_CHECK_TITLE, "Check Log")                               \
+    X(TR_CHECK_RESUME, "OK: resume")                             \
+    X(TR_CHECK_RUNNING, "Checking...")                           \
+    X(TR_CHECK_DONE, "Check done")                               \
+    X(TR_CHECK_GOOD, "good lines")                               \
+    X(TR_CHECK_BAD, "damaged, quarantined")                      \
+    X(TR_CHECK_REPAIRED, "bytes cut at startup")                 \
+    /* Reminders */                                              \
+    X(TR_REMIND_TITLE, "Reminders")                              \
+    X(TR_REMIND_FEED, "No feed for")                             \
+    X(TR_REMIND_DIAPER, "No diaper for")                         \
+    X(TR_REMIND_SLEEP, "Sleep over")                             \
+    X(TR_REMIND_OFF, "off")                                      \
+    X(TR_REMIND_HINT, "</>: -/+30 min")                          \
+    X(TR_ALERT_FEED, "time to feed") /* "Anna: time to feed" */  \
+    X(TR_ALERT_DIAPER, "check diaper")                           \
+    X(TR_ALERT_SLEEP, "long sleep")                              \
+    /* Language */                                               \
+    X(TR_LANG_TITLE, "Language")                                 \
+    /* Age units */                                              \
+    X(TR_AGE_DAYS, "days")                                       \
+    X(TR_AGE_WEEKS, "weeks")                                     \
+    X(TR_AGE_MONTHS, "months")
+
 typedef enum {
-    // Main screen
-    TR_MAIN_AWAKE,
-    TR_MAIN_FEEDING,
-    TR_MAIN_SLEEPING,
-    TR_MAIN_DIAPER_LOGGED,
-    TR_MAIN_UP_FEED,
-    TR_MAIN_DOWN_SLEEP,
-    TR_MAIN_LEFT_DIAPER,
-    TR_MAIN_BACK_MENU,
-    TR_MAIN_FEED_LABEL,    // Label without arrow
-    TR_MAIN_SLEEP_LABEL,   // Label without arrow
-    TR_MAIN_DIAPER_LABEL,  // Label without arrow
-    TR_MAIN_MENU_LABEL,    // Label without arrow
-    
-    // Menu
-    TR_MENU_PROFILE,
-    TR_MENU_RECENT_LOG,
-    TR_MENU_DELETE_LAST,
-    TR_MENU_CLEAR_ALL,
-    TR_MENU_LANGUAGE,
-    TR_MENU_EXIT,
-    
-    // Profile
-    TR_PROFILE_TITLE,
-    TR_PROFILE_NAME,
-    TR_PROFILE_BIRTH,
-    TR_PROFILE_AGE,
-    TR_PROFILE_EDIT_NAME,
-    TR_PROFILE_EDIT_DATE,
-    TR_PROFILE_LANGUAGE,
-    
-    // Edit name
-    TR_EDIT_NAME_TITLE,
-    TR_EDIT_NAME_NAME,
-    TR_EDIT_NAME_CHAR,
-    TR_EDIT_NAME_UP_DOWN,
-    TR_EDIT_NAME_L_R,
-    
-    // Edit birth date
-    TR_EDIT_DATE_TITLE,
-    TR_EDIT_DATE_YEAR,
-    TR_EDIT_DATE_MONTH,
-    TR_EDIT_DATE_DAY,
-    TR_EDIT_DATE_INVALID,
-    
-    // Recent log
-    TR_LOG_TITLE,
-    TR_LOG_NO_EVENTS,
-    TR_LOG_DIAPER,
-    TR_LOG_FEED_START,
-    TR_LOG_FEED_STOP,
-    TR_LOG_SLEEP_START,
-    TR_LOG_SLEEP_STOP,
-    
-    // Language
-    TR_LANG_TITLE,
-    TR_LANG_ENGLISH,
-    TR_LANG_RUSSIAN,
-    TR_LANG_SPANISH,
-    
-    // Age units
-    TR_AGE_DAYS,
-    TR_AGE_WEEKS,
-    TR_AGE_MONTHS,
-    
+#define TR_ENUM(key, en) key,
+    TR_KEYS(TR_ENUM)
+#undef TR_ENUM
     TR_COUNT // Total count
 } TranslationKey;
 
 const char* tr_get(AppData* app, TranslationKey key);
+void tr_init(uint8_t language); // Find installed packs and load the active one
+bool tr_load(uint8_t language); // Falls back to English if the pack is missing or stale
+uint8_t tr_language_count(void);
+const char* tr_language_name(uint8_t language);
 